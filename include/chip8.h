@@ -11,6 +11,41 @@
 #include "chip8stack.h"
 #include "chip8keyboard.h"
 #include "chip8screen.h"
+#include "chip8audio.h"
+#include "chip8trace.h"
+#include "chip8profile.h"
+
+enum chip8_fault
+{
+    CHIP8_FAULT_NONE,
+    CHIP8_FAULT_MEMORY,
+    CHIP8_FAULT_STACK_OVERFLOW,
+    CHIP8_FAULT_STACK_UNDERFLOW
+}; /* End fault enum */
+
+enum chip8_load_result
+{
+    CHIP8_LOAD_OK,
+    CHIP8_LOAD_OPEN_FAILED,
+    CHIP8_LOAD_READ_FAILED,
+    CHIP8_LOAD_TOO_LARGE
+}; /* End load result enum */
+
+/* Why the last chip8_run_frame stopped making progress. A core
+ * waiting for a key or halted on a jump to itself changes nothing until
+ * a key goes down (or ever, for a halt), and one polling the delay timer
+ * (Fx07; 3x00; 1nnn back to the Fx07) nothing until wake_cycle, when the
+ * timer runs out. A frontend can sleep rather than run it and catch up
+ * with chip8_skip_frames; see chip8_can_sleep. A display wait only lasts
+ * until the frame ends. */
+enum chip8_idle
+{
+    CHIP8_IDLE_NONE,
+    CHIP8_IDLE_KEY,
+    CHIP8_IDLE_HALT,
+    CHIP8_IDLE_VBLANK,
+    CHIP8_IDLE_TIMER
+}; /* End idle enum */
 
 struct chip8
 {
@@ -19,10 +54,153 @@ struct chip8
     struct chip8_registers registers;
     struct chip8_keyboard keyboard;
     struct chip8_screen screen;
+    struct chip8_audio audio;
+    unsigned long long cycles;
+    unsigned int random_state;
+    enum chip8_fault fault;
+    unsigned long long vblank_frame;
+    enum chip8_idle idle;
+    unsigned long long wake_cycle;
+    const struct chip8_profile* profile;
+    struct chip8_trace* trace;
+    struct chip8_profiler* profiler;
 }; /* End chip8 struct */
 
+/* Profiling builds (-DCHIP8_PROFILING) hand every instruction run to
+ * the profiler attached to the core, if any; see chip8profiler.h.
+ * Other builds never look at it. */
+#ifdef CHIP8_PROFILING
+#define CHIP8_PROFILING_ON(chip8) ((chip8)->profiler != NULL)
+#else
+#define CHIP8_PROFILING_ON(chip8) 0
+#endif
+
 void chip8_init(struct chip8* chip8);
-void chip8_load(struct chip8* chip8, const char* buf, size_t size);
+void chip8_seed(struct chip8* chip8, unsigned int seed);
+void chip8_set_profile(struct chip8* chip8, const struct chip8_profile* profile);
+enum chip8_load_result chip8_load(struct chip8* chip8, const char* buf, size_t size);
+void chip8_loaded(struct chip8* chip8, size_t size);
+const char* chip8_load_result_name(enum chip8_load_result result);
 void chip8_exec(struct chip8* chip8, unsigned short opcode);
+void chip8_step(struct chip8* chip8);
+void chip8_run_frame(struct chip8* chip8);
+void chip8_skip_frames(struct chip8* chip8, unsigned long long frames);
+bool chip8_can_sleep(struct chip8* chip8);
+unsigned long long chip8_sleep_frames(const struct chip8* chip8);
+const char* chip8_fault_name(enum chip8_fault fault);
+
+/* Size of the address space the current profile wraps or traps at */
+static inline int chip8_address_space(const struct chip8* chip8)
+{
+    return chip8->profile->quirks & CHIP8_QUIRK_XO_CHIP ? CHIP8_MEMORY_SIZE : CHIP8_CLASSIC_MEMORY_SIZE;
+} /* End of address space function */
+
+/* Emulated time is the cycle count: the 60Hz tick falls after every
+ * CHIP8_CYCLES_PER_FRAME instructions, so this many ticks have passed
+ * once the core has run cycles instructions */
+static inline unsigned long long chip8_frame_at(unsigned long long cycles)
+{
+    return cycles / CHIP8_CYCLES_PER_FRAME;
+} /* End of frame at function */
+
+/* A timer written with value at cycle set, as it reads now */
+static inline unsigned char chip8_timer_value(const struct chip8* chip8, unsigned char value, unsigned long long set)
+{
+    unsigned long long ticks = chip8_frame_at(chip8->cycles) - chip8_frame_at(set);
+    return ticks >= value ? 0 : value - ticks;
+} /* End of timer value function */
+
+static inline unsigned char chip8_delay_timer(const struct chip8* chip8)
+{
+    return chip8_timer_value(chip8, chip8->registers.delay_value, chip8->registers.delay_cycle);
+} /* End of delay timer function */
+
+static inline unsigned char chip8_sound_timer(const struct chip8* chip8)
+{
+    return chip8_timer_value(chip8, chip8->registers.sound_value, chip8->registers.sound_cycle);
+} /* End of sound timer function */
+
+static inline void chip8_set_delay_timer(struct chip8* chip8, unsigned char value)
+{
+    chip8->registers.delay_value = value;
+    chip8->registers.delay_cycle = chip8->cycles;
+} /* End of set delay timer function */
+
+static inline void chip8_set_sound_timer(struct chip8* chip8, unsigned char value)
+{
+    chip8->registers.sound_value = value;
+    chip8->registers.sound_cycle = chip8->cycles;
+} /* End of set sound timer function */
+
+/* The first cycle at which the delay timer reads 0 */
+static inline unsigned long long chip8_delay_expiry(const struct chip8* chip8)
+{
+    return (chip8_frame_at(chip8->registers.delay_cycle) + chip8->registers.delay_value) * CHIP8_CYCLES_PER_FRAME;
+} /* End of delay expiry function */
+
+/* Whether a 1nnn, with PC already past it, closes a loop that only polls
+ * the running delay timer : Fx07; 3x00; 1nnn back to the Fx07 */
+static inline bool chip8_polls_delay(const struct chip8* chip8, unsigned short nnn)
+{
+    const unsigned char* loop = &chip8->memory.memory[nnn];
+    unsigned char x = loop[0] & 0x0f;
+    return nnn == chip8->registers.PC - 6
+        && loop[0] == (0xf0 | x) && loop[1] == 0x07
+        && loop[2] == (0x30 | x) && loop[3] == 0x00
+        && chip8_delay_expiry(chip8) > chip8->cycles;
+} /* End of polls delay function */
+
+/* Moves a core polling the delay timer, back at the Fx07, on by whole
+ * passes of the loop : the ones that still read a running timer and end
+ * by end. Vx is left as the last of them read it. Returns true when the
+ * core is still polling at end; otherwise the rest runs normally. */
+static inline bool chip8_delay_forward(struct chip8* chip8, unsigned long long end)
+{
+    unsigned long long start = chip8->cycles;
+    unsigned long long passes = chip8->wake_cycle > start ? (chip8->wake_cycle - start + 2) / 3 : 0;
+    if (passes > (end - start) / 3)
+    {
+        passes = (end - start) / 3;
+    } /* End of if statement */
+    if (passes == 0)
+    {
+        chip8->idle = CHIP8_IDLE_NONE;
+        return false;
+    } /* End of if statement */
+
+    chip8->cycles = start + 3 * (passes - 1);
+    chip8->registers.V[chip8->memory.memory[chip8->registers.PC] & 0x0f] = chip8_delay_timer(chip8);
+    chip8->cycles += 3;
+    if (chip8->cycles < end || chip8->cycles >= chip8->wake_cycle)
+    {
+        chip8->idle = CHIP8_IDLE_NONE;
+        return false;
+    } /* End of if statement */
+    return true;
+} /* End of delay forward function */
+
+/* Moves an idle core on to where its wait ends, counting the
+ * instructions that would only have repeated it as run : a display wait
+ * ends at the next frame boundary, a delay timer poll when the timer
+ * runs out, a key wait or halt outlasts any run since keys only change
+ * between runs. Returns true, with the cycle count at end, when the wait
+ * lasts past end. */
+static inline bool chip8_idle_forward(struct chip8* chip8, unsigned long long end)
+{
+    if (chip8->idle == CHIP8_IDLE_TIMER)
+    {
+        return chip8_delay_forward(chip8, end);
+    } /* End of if statement */
+
+    unsigned long long wake = (chip8->vblank_frame + 1) * CHIP8_CYCLES_PER_FRAME;
+    if (chip8->idle != CHIP8_IDLE_VBLANK || wake >= end)
+    {
+        chip8->cycles = end;
+        return true;
+    } /* End of if statement */
+    chip8->cycles = wake;
+    chip8->idle = CHIP8_IDLE_NONE;
+    return false;
+} /* End of idle forward function */
 
 #endif
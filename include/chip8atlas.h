@@ -0,0 +1,47 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8atlas.h */
+
+#ifndef CHIP8ATLAS_H
+#define CHIP8ATLAS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "chip8frame.h"
+
+/* Each tile is one lo-res screen at a texel per pixel; hi-res frames
+ * are halved to fit. A gutter of border colour separates the tiles. */
+#define CHIP8_ATLAS_TILE_WIDTH CHIP8_WIDTH
+#define CHIP8_ATLAS_TILE_HEIGHT CHIP8_HEIGHT
+#define CHIP8_ATLAS_GUTTER 1
+#define CHIP8_ATLAS_BORDER 0xff202020
+
+/* Aspect ratio the grid of tiles is laid out for */
+#define CHIP8_ATLAS_ASPECT_WIDTH 16
+#define CHIP8_ATLAS_ASPECT_HEIGHT 9
+
+/* The screens of many instances tiled into one 32-bit image, so a
+ * whole grid goes to the GPU as one texture and is drawn with one
+ * copy. Only tiles handed a new frame are redrawn, and the rows they
+ * span are kept as one band so a frame needs a single upload of just
+ * the part that changed. */
+struct chip8_atlas
+{
+    int count;
+    int columns;
+    int rows;
+    int width;
+    int height;
+    size_t pitch;
+    uint32_t* pixels;
+    uint32_t palette[4];
+    int dirty_top;
+    int dirty_bottom;
+}; /* End atlas struct */
+
+int chip8_atlas_init(struct chip8_atlas* atlas, int count, const uint32_t palette[4]);
+void chip8_atlas_free(struct chip8_atlas* atlas);
+void chip8_atlas_draw(struct chip8_atlas* atlas, int index, const struct chip8_frame* frame);
+bool chip8_atlas_take_dirty(struct chip8_atlas* atlas, int* y, int* height);
+int chip8_atlas_find(const struct chip8_atlas* atlas, int x, int y);
+
+#endif
@@ -0,0 +1,19 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8audio.h */
+
+#ifndef CHIP8AUDIO_H
+#define CHIP8AUDIO_H
+
+#include "config.h"
+
+/* XO-CHIP sound: while the sound timer runs, the 128 bits of pattern
+ * are played MSB first as 1-bit samples, looping, at a rate of
+ * 4000 * 2^((pitch - 64) / 48) samples per second. F002 loads pattern
+ * from I and Fx3A sets pitch. */
+struct chip8_audio
+{
+    unsigned char pattern[CHIP8_AUDIO_PATTERN_SIZE];
+    unsigned char pitch;
+}; /* End audio struct */
+
+#endif
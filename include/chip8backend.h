@@ -0,0 +1,28 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8backend.h */
+
+#ifndef CHIP8BACKEND_H
+#define CHIP8BACKEND_H
+
+struct chip8;
+
+/* An execution backend runs one instruction at PC per step. A backend
+ * that only shows its real behaviour over longer runs, such as one that
+ * fuses instructions, also has a run that executes up to cycles
+ * instructions, stopping early on a fault; the lockstep verifier then
+ * drives it a run at a time and compares at the run boundaries. "switch"
+ * is the reference interpreter; every other backend must stay
+ * indistinguishable from it under the lockstep verifier. */
+struct chip8_backend
+{
+    const char* name;
+    void (*step)(struct chip8* chip8);
+    void (*run)(struct chip8* chip8, int cycles);
+}; /* End backend struct */
+
+extern const struct chip8_backend chip8_backends[];
+extern const int chip8_total_backends;
+
+const struct chip8_backend* chip8_backend_find(const char* name);
+
+#endif
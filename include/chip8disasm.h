@@ -0,0 +1,11 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8disasm.h */
+
+#ifndef CHIP8DISASM_H
+#define CHIP8DISASM_H
+
+#include <stddef.h>
+
+void chip8_disassemble(unsigned short opcode, char* out, size_t size);
+
+#endif
@@ -0,0 +1,814 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8exec.h */
+
+/* The interpreter, included by chip8.c once per quirk profile. Before
+ * each inclusion chip8.c defines CHIP8_EXEC_PROFILE, the suffix given to
+ * the generated functions, and CHIP8_EXEC_QUIRKS, the profile's quirk
+ * mask. Every quirk test is on a constant, so each instance compiles to
+ * just the behaviour of its own profile. There is deliberately no
+ * include guard. */
+
+#define CHIP8_EXEC_PASTE2(name, profile) name##_##profile
+#define CHIP8_EXEC_PASTE(name, profile) CHIP8_EXEC_PASTE2(name, profile)
+#define CHIP8_EXEC_NAME(name) CHIP8_EXEC_PASTE(name, CHIP8_EXEC_PROFILE)
+#define CHIP8_EXEC_QUIRK(quirk) ((CHIP8_EXEC_QUIRKS & (quirk)) != 0)
+
+/* The profile's address space, which every access wraps or traps at */
+#define CHIP8_EXEC_MEMORY_SIZE (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP) ? CHIP8_MEMORY_SIZE : CHIP8_CLASSIC_MEMORY_SIZE)
+
+static void CHIP8_EXEC_NAME(chip8_exec_extended)(struct chip8* chip8, unsigned short opcode)
+{
+    unsigned short nnn = opcode & 0x0fff;
+    unsigned char x = (opcode >> 8) & 0x000f;
+    unsigned char y = (opcode >> 4) & 0x000f;
+    unsigned char kk = opcode & 0x00ff;
+    unsigned short tmp = 0;
+    unsigned char n = opcode & 0x000f;
+
+    switch (opcode & 0xf000)
+    {
+        /* 00Cn : Scroll the display down n rows
+         * 00Dn : Scroll the display up n rows */
+        case 0x0000:
+            if ((opcode & 0xfff0) == 0x00C0)
+            {
+                chip8_screen_scroll_down(&chip8->screen, n);
+            }
+            else if ((opcode & 0xfff0) == 0x00D0 && CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP))
+            {
+                chip8_screen_scroll_up(&chip8->screen, n);
+            } /* End of if statement */
+            break;
+
+        /* 1nnn : Jump to location nnn. A jump to itself halts, one back
+         * over Fx07; 3x00 polls the delay timer; see chip8_idle */
+        case 0x1000:
+            if (nnn == chip8->registers.PC - 2)
+            {
+                chip8->idle = CHIP8_IDLE_HALT;
+            }
+            else if (chip8_polls_delay(chip8, nnn))
+            {
+                chip8->idle = CHIP8_IDLE_TIMER;
+                chip8->wake_cycle = chip8_delay_expiry(chip8);
+            } /* End of if statement */
+            chip8->registers.PC = nnn;
+            break;
+
+        /* 2nnn : Call subroutine at location nnn */
+        case 0x2000:
+            chip8_stack_push(chip8, chip8->registers.PC);
+            chip8->registers.PC = nnn;
+            break;
+
+        /* 3xkk : Skip next instruction if Vx = kk */
+        case 0x3000:
+            if (chip8->registers.V[x] == kk)
+            {
+                chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+            } /* End of if statement */
+            break;
+        /* 4xkk : Skip next instruction if Vx != kk */
+        case 0x4000:
+            if (chip8->registers.V[x] != kk)
+            {
+                chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+            } /* End of if statement */
+            break;
+        /* Opcodes for 0x5000 instruction set */
+        case 0x5000:
+            switch (n)
+            {
+                /* 5xy0 : Skip the next instruction if Vx = Vy */
+                case 0x00:
+                    if (chip8->registers.V[x] == chip8->registers.V[y])
+                    {
+                        chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+                    } /* End if statement */
+                    break;
+
+                /* 5xy2 : Store Vx through Vy in memory starting at location I */
+                case 0x02:
+                    if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP))
+                    {
+                        chip8_save_range(chip8, x, y);
+                    } /* End of if statement */
+                    break;
+
+                /* 5xy3 : Read Vx through Vy from memory starting at location I */
+                case 0x03:
+                    if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP))
+                    {
+                        chip8_load_range(chip8, x, y);
+                    } /* End of if statement */
+                    break;
+            } /* End of nested switch */
+            break;
+
+        /* 6xkk : Set Vx = kk */
+        case 0x6000:
+            chip8->registers.V[x] = kk;
+            break;
+
+        /* 7xkk : Set Vx = Vx + kk */
+        case 0x7000:
+            chip8->registers.V[x] += kk;
+            break;
+
+        /* Opcodes for 0x8000 instruction set */
+        case 0x8000:
+            {
+                switch (opcode & 0x000f)
+                {
+                    /* 8xy0 : Set Vx = Vy */
+                    case 0x00:
+                        chip8->registers.V[x] = chip8->registers.V[y];
+                        break;
+
+                    /* 8xy1 : Set Vx = Vx OR Vy */
+                    case 0x01:
+                        chip8->registers.V[x] = chip8->registers.V[x] |= chip8->registers.V[y];
+                        if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_VF_RESET))
+                        {
+                            chip8->registers.V[0x0f] = 0;
+                        } /* End of if statement */
+                        break;
+
+                    /* 8xy2 : Set Vx = Vx AND Vy */
+                    case 0x02:
+                        chip8->registers.V[x] = chip8->registers.V[x] &= chip8->registers.V[y];
+                        if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_VF_RESET))
+                        {
+                            chip8->registers.V[0x0f] = 0;
+                        } /* End of if statement */
+                        break;
+
+                    /* 8xy3 : Set Vx = Vx XOR Vy */
+                    case 0x03:
+                        chip8->registers.V[x] = chip8->registers.V[x] ^= chip8->registers.V[y];
+                        if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_VF_RESET))
+                        {
+                            chip8->registers.V[0x0f] = 0;
+                        } /* End of if statement */
+                        break;
+
+                    /* 8xy4 : Set Vx = Vx + Vy, set VF = carry */
+                    case 0x04:
+                        tmp = chip8->registers.V[x] + chip8->registers.V[y];
+                        chip8->registers.V[0x0f] = tmp > 0xff;
+                        chip8->registers.V[x] = tmp;
+                        break;
+
+                    /* 8xy5 : Set Vx = Vx - Vy, Set VF = Not borrow */
+                    case 0x05:
+                        chip8->registers.V[0x0f] = chip8->registers.V[x] > chip8->registers.V[y];
+                        chip8->registers.V[x] = chip8->registers.V[x] - chip8->registers.V[y];
+                        break;
+                    
+                    /* 8xy6 : Set Vx = Vx SHR 1 least-significant bit, or Vx = Vy SHR 1 */
+                    case 0x06:
+                        tmp = chip8->registers.V[CHIP8_EXEC_QUIRK(CHIP8_QUIRK_SHIFT_VY) ? y : x];
+                        chip8->registers.V[0x0f] = tmp & 0x01;
+                        chip8->registers.V[x] = tmp >> 1;
+                        break;
+
+                    /* 8xy7 : Set Vx = Vy - Vx, Set VF = Not borrow */ 
+                    case 0x07:
+                        chip8->registers.V[0x0f] = chip8->registers.V[y] > chip8->registers.V[x];
+                        chip8->registers.V[x] = chip8->registers.V[y] - chip8->registers.V[x];
+                        break;
+
+                    /* 8xye : Set Vx = Vx SHL 1 most-significant bit, or Vx = Vy SHL 1 */
+                    case 0x0e:
+                        tmp = chip8->registers.V[CHIP8_EXEC_QUIRK(CHIP8_QUIRK_SHIFT_VY) ? y : x];
+                        chip8->registers.V[0x0f] = tmp >> 7;
+                        chip8->registers.V[x] = tmp << 1;
+                        break;
+                } /* End of nested switch */
+            } /* End of scope */
+            break;
+
+        /* 9xy0 : Skip the next instruction if Vx != Vy */    
+        case 0x9000:
+            if (chip8->registers.V[x] != chip8->registers.V[y])
+            {
+                chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+            } /* End of nested if statement */
+            break;
+
+        /* Annn : Set I = nnn */
+        case 0xA000:
+            chip8->registers.I = nnn;
+            break;
+
+        /* Bnnn : Jump to location nnn + V0, or Bxnn : xnn + Vx */
+        case 0xB000:
+            chip8->registers.PC = nnn + chip8->registers.V[CHIP8_EXEC_QUIRK(CHIP8_QUIRK_JUMP_VX) ? x : 0x00];
+            break;
+
+        /* Cxkk : Set Vx = random byte AND kk */
+        case 0xC000:
+            chip8->registers.V[x] = chip8_random_byte(chip8) & kk;
+            break;
+
+        /* 0xD000 : Draw to the screen. Dxy0 in hi-res mode, or in either
+         * mode under BIG_LORES, draws a 16x16 sprite from 32 bytes at I.
+         * With both XO-CHIP planes selected the second plane's data
+         * follows the first's. */
+        case 0xD000:
+            {
+                /* Wait for the tick: re-execute until a frame has ended
+                 * since the last wait */
+                if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_DISPLAY_WAIT))
+                {
+                    unsigned long long frame = chip8_frame_at(chip8->cycles);
+                    if (frame <= chip8->vblank_frame)
+                    {
+                        chip8->idle = CHIP8_IDLE_VBLANK;
+                        chip8->registers.PC -= 2;
+                        break;
+                    } /* End of if statement */
+                    chip8->vblank_frame = frame;
+                } /* End of if statement */
+
+                bool big = n == 0 && (chip8->screen.hires || CHIP8_EXEC_QUIRK(CHIP8_QUIRK_BIG_LORES));
+                int size = (big ? 32 : n) * chip8_screen_plane_count(&chip8->screen);
+
+                /* Sprites running off the end of memory go through the
+                 * memory policy */
+                char wrapped[32 * CHIP8_SCREEN_PLANES];
+                const char* sprite = wrapped;
+                if (chip8->registers.I + size <= CHIP8_EXEC_MEMORY_SIZE)
+                {
+                    sprite = (const char*) &chip8->memory.memory[chip8->registers.I];
+                }
+                else
+                {
+                    chip8_memory_read_block_wrapped(&chip8->memory, CHIP8_EXEC_MEMORY_SIZE,
+                            chip8->registers.I, (unsigned char*) wrapped, size);
+                } /* End of if statement */
+
+                if (big)
+                {
+                    chip8->registers.V[0x0f] = chip8_screen_draw_sprite16(
+                            &chip8->screen,
+                            chip8->registers.V[x],
+                            chip8->registers.V[y],
+                            sprite,
+                            CHIP8_EXEC_QUIRK(CHIP8_QUIRK_CLIP)
+                    );
+                    break;
+                } /* End of if statement */
+                chip8->registers.V[0x0f] = chip8_screen_draw_sprite(
+                        &chip8->screen,
+                        chip8->registers.V[x],
+                        chip8->registers.V[y],
+                        sprite,
+                        n,
+                        CHIP8_EXEC_QUIRK(CHIP8_QUIRK_CLIP)
+                );
+            } /* End of scope */
+            break;
+
+        /* Opcodes for 0xE000 instruction set */
+        case 0xE000:
+            {
+                switch (opcode & 0x00ff)
+                {
+                    /* Ex9E : Skip the next instruction if the key with the value of Vx is pressed */
+                    case 0x9e:
+                        if (chip8_keyboard_is_down(&chip8->keyboard, chip8->registers.V[x] & 0x0f))
+                        {
+                            chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+                        }
+                        break;
+
+                    /* ExA1 : Skip the next instruction if the key with the value of Vx is not pressed */
+                    case 0xa1:
+                        if (!chip8_keyboard_is_down(&chip8->keyboard, chip8->registers.V[x] & 0x0f))
+                        {
+                            chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+                        }
+                        break;
+                } /* End of switch statement */
+            } /* End of scope */
+            break;
+
+        /* Opcodes for 0xF000 instruction set */
+        case 0xF000:
+            {
+                switch (opcode & 0x00ff)
+                {
+                    /* F000 nnnn : Set I = nnnn, the word after the instruction */
+                    case 0x00:
+                        if (x == 0 && CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP))
+                        {
+                            chip8->registers.I = chip8_memory_get_short(&chip8->memory, CHIP8_EXEC_MEMORY_SIZE,
+                                    chip8->registers.PC);
+                            chip8->registers.PC += 2;
+                        } /* End of if statement */
+                        break;
+
+                    /* Fn01 : Select the planes drawn to with the mask n */
+                    case 0x01:
+                        if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP))
+                        {
+                            chip8_screen_select_planes(&chip8->screen, x);
+                        } /* End of if statement */
+                        break;
+
+                    /* F002 : Load the 16-byte audio pattern from memory starting at location I */
+                    case 0x02:
+                        if (x == 0 && CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP))
+                        {
+                            chip8_memory_read_block(&chip8->memory, CHIP8_EXEC_MEMORY_SIZE, chip8->registers.I,
+                                    chip8->audio.pattern, CHIP8_AUDIO_PATTERN_SIZE);
+                        } /* End of if statement */
+                        break;
+
+                    /* Fx07 : Set Vx = delay timer value */
+                    case 0x07:
+                        chip8->registers.V[x] = chip8_delay_timer(chip8);
+                        break;
+
+                    /* Fx0A : Wait for a key press, store the value of the key in Vx.
+                     * Rather than blocking on the frontend the instruction is
+                     * re-executed until the frontend reports a key down. */
+                    case 0x0A:
+                        {
+                            char pressed_key = chip8_pressed_key(chip8);
+                            if (pressed_key == -1)
+                            {
+                                chip8->idle = CHIP8_IDLE_KEY;
+                                chip8->registers.PC -= 2;
+                                break;
+                            } /* End of if statement */
+                            chip8->registers.V[x] = pressed_key;
+                        }
+                        break;
+
+                    /* Fx15 : Set delay timer = Vx */
+                    case 0x15:
+                        chip8_set_delay_timer(chip8, chip8->registers.V[x]);
+                        break;
+
+                    /* Fx18 : Set the sound timer = Vx */
+                    case 0x18:
+                        chip8_set_sound_timer(chip8, chip8->registers.V[x]);
+                        break;
+
+                    /* Fx1E : Set I = I + Vx */
+                    case 0x1e:
+                        chip8->registers.I += chip8->registers.V[x];
+                        break;
+
+                    /* Fx29 : Set I = location of sprite for digit Vx */
+                    case 0x29:
+                        chip8->registers.I = chip8->registers.V[x] * CHIP8_DEFAULT_SPRITE_HEIGHT;
+                        break;
+
+                    /* Fx30 : Set I = location of the 8x10 sprite for digit Vx */
+                    case 0x30:
+                        chip8->registers.I = CHIP8_BIG_CHARACTER_SET_LOAD_ADDRESS
+                            + (chip8->registers.V[x] & 0x0f) * CHIP8_BIG_SPRITE_HEIGHT;
+                        break;
+
+                    /* Fx33 : Store BCD representation of Vx in memory locations I, I+1, and I+2 */
+                    case 0x33:
+                        {
+                            unsigned char bcd[3];
+                            bcd[0] = chip8->registers.V[x] / 100;
+                            bcd[1] = chip8->registers.V[x] / 10 % 10;
+                            bcd[2] = chip8->registers.V[x] % 10;
+                            chip8_memory_write_block(&chip8->memory, CHIP8_EXEC_MEMORY_SIZE,
+                                    chip8->registers.I, bcd, sizeof(bcd));
+                        }
+                        break;
+
+                    /* Fx3A : Set the audio pitch = Vx */
+                    case 0x3a:
+                        if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP))
+                        {
+                            chip8->audio.pitch = chip8->registers.V[x];
+                        } /* End of if statement */
+                        break;
+
+                    /* Fx55 : Store the registers V0 through Vx in memory starting at location I */
+                    case 0x55:
+                        chip8_memory_write_block(&chip8->memory, CHIP8_EXEC_MEMORY_SIZE,
+                                chip8->registers.I, chip8->registers.V, x+1);
+                        if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_INCREMENT_I))
+                        {
+                            chip8->registers.I += x+1;
+                        } /* End of if statement */
+                        break;
+
+                    /* Fx65 : Read registers V0 through Vx from memory starting at location I */
+                    case 0x65:
+                        chip8_memory_read_block(&chip8->memory, CHIP8_EXEC_MEMORY_SIZE,
+                                chip8->registers.I, chip8->registers.V, x+1);
+                        if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_INCREMENT_I))
+                        {
+                            chip8->registers.I += x+1;
+                        } /* End of if statement */
+                        break;
+                } /* End of switch statement */
+            } /* End of scope */
+            break;
+    } /* End of switch statement */
+} /* End of exec extended function */
+
+static void CHIP8_EXEC_NAME(chip8_exec)(struct chip8* chip8, unsigned short opcode)
+{
+    switch (opcode)
+    {
+        /* CLS : Clears the screen */
+        case 0x00E0:
+            chip8_screen_clear(&chip8->screen);
+            break;
+
+        /* Ret : Return from subroutine */
+        case 0x00EE:
+            chip8->registers.PC = chip8_stack_pop(chip8);
+            break;
+
+        /* 00FB : Scroll the display right four pixels */
+        case 0x00FB:
+            chip8_screen_scroll_right(&chip8->screen);
+            break;
+
+        /* 00FC : Scroll the display left four pixels */
+        case 0x00FC:
+            chip8_screen_scroll_left(&chip8->screen);
+            break;
+
+        /* 00FE : Switch to the 64x32 lo-res mode */
+        case 0x00FE:
+            chip8_screen_set_hires(&chip8->screen, false);
+            break;
+
+        /* 00FF : Switch to the 128x64 hi-res mode */
+        case 0x00FF:
+            chip8_screen_set_hires(&chip8->screen, true);
+            break;
+
+        default:
+            CHIP8_EXEC_NAME(chip8_exec_extended)(chip8, opcode);
+    } /* End of switch statement */
+} /* End of exec function */
+
+static void CHIP8_EXEC_NAME(chip8_step_traced)(struct chip8* chip8, unsigned short pc, unsigned short opcode)
+{
+    unsigned char before[CHIP8_TOTAL_DATA_REGISTERS];
+    memcpy(before, chip8->registers.V, sizeof(before));
+    CHIP8_EXEC_NAME(chip8_exec)(chip8, opcode);
+
+    unsigned char reg = CHIP8_TRACE_NO_REGISTER;
+    for (int i = 0; i < CHIP8_TOTAL_DATA_REGISTERS; i++)
+    {
+        if (chip8->registers.V[i] != before[i])
+        {
+            reg = i;
+            break;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    chip8_trace_append(chip8->trace, chip8->cycles, pc, opcode, chip8->registers.I,
+            reg, reg == CHIP8_TRACE_NO_REGISTER ? 0 : chip8->registers.V[reg]);
+} /* End of step traced function */
+
+/* Fetches, decodes and executes the instruction at PC. Faults are
+ * reported through chip8->fault. */
+static void CHIP8_EXEC_NAME(chip8_step)(struct chip8* chip8)
+{
+    unsigned short pc = chip8->registers.PC;
+    unsigned short opcode = chip8_memory_get_short(&chip8->memory, CHIP8_EXEC_MEMORY_SIZE, pc);
+#if CHIP8_MEMORY_POLICY == CHIP8_MEMORY_REPORT
+    if (chip8->memory.fault)
+    {
+        chip8->fault = CHIP8_FAULT_MEMORY;
+        return;
+    } /* End of if statement */
+#endif
+    chip8->registers.PC += 2;
+
+    if (chip8->trace)
+    {
+        CHIP8_EXEC_NAME(chip8_step_traced)(chip8, pc, opcode);
+    }
+    else
+    {
+        CHIP8_EXEC_NAME(chip8_exec)(chip8, opcode);
+    } /* End of if statement */
+#ifdef CHIP8_PROFILING
+    if (chip8->profiler)
+    {
+        chip8_profiler_record(chip8->profiler, pc, opcode, chip8->registers.PC);
+    } /* End of if statement */
+#endif
+    chip8->cycles++;
+
+#if CHIP8_MEMORY_POLICY == CHIP8_MEMORY_REPORT
+    if (chip8->memory.fault)
+    {
+        chip8->fault = CHIP8_FAULT_MEMORY;
+    } /* End of if statement */
+#endif
+} /* End of step function */
+
+/* Runs up to cycles instructions, stopping early on a fault. The step
+ * is inlined here, so a frame makes no indirect calls. Once the core
+ * idles every instruction until the wait ends would just re-execute the
+ * same wait, jump or timer poll, so they are counted without being run :
+ * a display wait ends at the next frame boundary, a timer poll when the
+ * delay timer runs out, a key wait or halt outlasts the run since keys
+ * only change between runs. With a trace attached they are run so the
+ * trace still shows them. */
+static void CHIP8_EXEC_NAME(chip8_run)(struct chip8* chip8, int cycles)
+{
+    unsigned long long end = chip8->cycles + cycles;
+    chip8->idle = CHIP8_IDLE_NONE;
+    while (chip8->cycles < end && chip8->fault == CHIP8_FAULT_NONE)
+    {
+        CHIP8_EXEC_NAME(chip8_step)(chip8);
+        if (chip8->idle != CHIP8_IDLE_NONE && !chip8->trace && chip8_idle_forward(chip8, end))
+        {
+            break;
+        } /* End of if statement */
+    } /* End of while loop */
+} /* End of run function */
+
+/* Executes one predecoded instruction with PC already past it. The
+ * common register, skip and jump forms run straight off the decoded op;
+ * the rest go through the full decode in chip8_exec. */
+static inline void CHIP8_EXEC_NAME(chip8_exec_decoded)(struct chip8* chip8, unsigned char op, unsigned short opcode)
+{
+    unsigned short nnn = opcode & 0x0fff;
+    unsigned char x = (opcode >> 8) & 0x000f;
+    unsigned char y = (opcode >> 4) & 0x000f;
+    unsigned char kk = opcode & 0x00ff;
+    unsigned char* V = chip8->registers.V;
+    unsigned short tmp = 0;
+
+    switch (op)
+    {
+        /* 0nnn and the patterns chip8_exec ignores do nothing */
+        case CHIP8_OP_SYS:
+        case CHIP8_OP_INVALID:
+            break;
+
+        case CHIP8_OP_RET:
+            chip8->registers.PC = chip8_stack_pop(chip8);
+            break;
+
+        case CHIP8_OP_JP:
+            if (nnn == chip8->registers.PC - 2)
+            {
+                chip8->idle = CHIP8_IDLE_HALT;
+            }
+            else if (chip8_polls_delay(chip8, nnn))
+            {
+                chip8->idle = CHIP8_IDLE_TIMER;
+                chip8->wake_cycle = chip8_delay_expiry(chip8);
+            } /* End of if statement */
+            chip8->registers.PC = nnn;
+            break;
+
+        case CHIP8_OP_CALL:
+            chip8_stack_push(chip8, chip8->registers.PC);
+            chip8->registers.PC = nnn;
+            break;
+
+        case CHIP8_OP_SE_BYTE:
+            if (V[x] == kk)
+            {
+                chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+            } /* End of if statement */
+            break;
+
+        case CHIP8_OP_SNE_BYTE:
+            if (V[x] != kk)
+            {
+                chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+            } /* End of if statement */
+            break;
+
+        case CHIP8_OP_SE_REG:
+            if (V[x] == V[y])
+            {
+                chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+            } /* End of if statement */
+            break;
+
+        case CHIP8_OP_LD_BYTE:
+            V[x] = kk;
+            break;
+
+        case CHIP8_OP_ADD_BYTE:
+            V[x] += kk;
+            break;
+
+        case CHIP8_OP_LD_REG:
+            V[x] = V[y];
+            break;
+
+        case CHIP8_OP_OR:
+            V[x] |= V[y];
+            if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_VF_RESET))
+            {
+                V[0x0f] = 0;
+            } /* End of if statement */
+            break;
+
+        case CHIP8_OP_AND:
+            V[x] &= V[y];
+            if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_VF_RESET))
+            {
+                V[0x0f] = 0;
+            } /* End of if statement */
+            break;
+
+        case CHIP8_OP_XOR:
+            V[x] ^= V[y];
+            if (CHIP8_EXEC_QUIRK(CHIP8_QUIRK_VF_RESET))
+            {
+                V[0x0f] = 0;
+            } /* End of if statement */
+            break;
+
+        case CHIP8_OP_ADD_REG:
+            tmp = V[x] + V[y];
+            V[0x0f] = tmp > 0xff;
+            V[x] = tmp;
+            break;
+
+        case CHIP8_OP_SUB:
+            V[0x0f] = V[x] > V[y];
+            V[x] = V[x] - V[y];
+            break;
+
+        case CHIP8_OP_SHR:
+            tmp = V[CHIP8_EXEC_QUIRK(CHIP8_QUIRK_SHIFT_VY) ? y : x];
+            V[0x0f] = tmp & 0x01;
+            V[x] = tmp >> 1;
+            break;
+
+        case CHIP8_OP_SUBN:
+            V[0x0f] = V[y] > V[x];
+            V[x] = V[y] - V[x];
+            break;
+
+        case CHIP8_OP_SHL:
+            tmp = V[CHIP8_EXEC_QUIRK(CHIP8_QUIRK_SHIFT_VY) ? y : x];
+            V[0x0f] = tmp >> 7;
+            V[x] = tmp << 1;
+            break;
+
+        case CHIP8_OP_SNE_REG:
+            if (V[x] != V[y])
+            {
+                chip8_skip(chip8, CHIP8_EXEC_QUIRK(CHIP8_QUIRK_XO_CHIP));
+            } /* End of if statement */
+            break;
+
+        case CHIP8_OP_LD_I:
+            chip8->registers.I = nnn;
+            break;
+
+        case CHIP8_OP_JP_V0:
+            chip8->registers.PC = nnn + V[CHIP8_EXEC_QUIRK(CHIP8_QUIRK_JUMP_VX) ? x : 0x00];
+            break;
+
+        case CHIP8_OP_LD_VX_DT:
+            V[x] = chip8_delay_timer(chip8);
+            break;
+
+        case CHIP8_OP_LD_DT_VX:
+            chip8_set_delay_timer(chip8, V[x]);
+            break;
+
+        case CHIP8_OP_LD_ST_VX:
+            chip8_set_sound_timer(chip8, V[x]);
+            break;
+
+        case CHIP8_OP_ADD_I:
+            chip8->registers.I += V[x];
+            break;
+
+        case CHIP8_OP_LD_F:
+            chip8->registers.I = V[x] * CHIP8_DEFAULT_SPRITE_HEIGHT;
+            break;
+
+        default:
+            CHIP8_EXEC_NAME(chip8_exec)(chip8, opcode);
+    } /* End of switch statement */
+} /* End of exec decoded function */
+
+/* Reports a memory fault left by the instruction just executed */
+static inline void CHIP8_EXEC_NAME(chip8_decoded_fault)(struct chip8* chip8)
+{
+#if CHIP8_MEMORY_POLICY == CHIP8_MEMORY_REPORT
+    if (chip8->memory.fault)
+    {
+        chip8->fault = CHIP8_FAULT_MEMORY;
+    } /* End of if statement */
+#else
+    (void) chip8;
+#endif
+} /* End of decoded fault function */
+
+/* Whether a fused run has to stop after an instruction that should have
+ * left PC at next */
+static inline bool CHIP8_EXEC_NAME(chip8_decoded_stopped)(struct chip8* chip8, unsigned short next)
+{
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+    return chip8->registers.PC != next || chip8->fault != CHIP8_FAULT_NONE;
+} /* End of decoded stopped function */
+
+/* Runs the first length instructions of a decoded entry for pc, exactly
+ * as chip8_step would run them one by one. A fused run stops early once
+ * an instruction sends PC anywhere but on to the next one (a jump, a
+ * taken skip, a wait) or faults. */
+static inline void CHIP8_EXEC_NAME(chip8_dispatch_decoded)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        unsigned short next = pc + 2 * (i + 1);
+        chip8->registers.PC = next;
+        CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, decoded->ops[i], decoded->opcodes[i]);
+        chip8->cycles++;
+        if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, next))
+        {
+            break;
+        } /* End of if statement */
+    } /* End of for loop */
+} /* End of dispatch decoded function */
+
+/* The superinstructions generated into chip8super.h, which define
+ * chip8_exec_super for the profile */
+#include "chip8super.h"
+
+/* chip8_step over a decode cache : one instruction, never a whole fused
+ * run. With a trace or profiler attached, or with PC so close to the end
+ * of memory that an entry's code would run off it, the plain step runs
+ * instead. */
+static void CHIP8_EXEC_NAME(chip8_step_predecoded)(struct chip8_predecode* predecode, struct chip8* chip8)
+{
+    unsigned short pc = chip8->registers.PC;
+    if (chip8->trace || CHIP8_PROFILING_ON(chip8) || pc > CHIP8_EXEC_MEMORY_SIZE - sizeof(unsigned long long))
+    {
+        CHIP8_EXEC_NAME(chip8_step)(chip8);
+        return;
+    } /* End of if statement */
+    CHIP8_EXEC_NAME(chip8_dispatch_decoded)(chip8, chip8_predecode_fetch(predecode, chip8, pc), pc, 1);
+} /* End of step predecoded function */
+
+/* chip8_run over a decode cache, a fused run executing off a single
+ * dispatch unless it would take the run past its last cycle. Runs with
+ * a generated superinstruction go through its handler. */
+static void CHIP8_EXEC_NAME(chip8_run_predecoded)(struct chip8_predecode* predecode, struct chip8* chip8, int cycles)
+{
+    unsigned long long end = chip8->cycles + cycles;
+    chip8->idle = CHIP8_IDLE_NONE;
+    while (chip8->cycles < end && chip8->fault == CHIP8_FAULT_NONE)
+    {
+        unsigned short pc = chip8->registers.PC;
+        if (chip8->trace || CHIP8_PROFILING_ON(chip8) || pc > CHIP8_EXEC_MEMORY_SIZE - sizeof(unsigned long long))
+        {
+            CHIP8_EXEC_NAME(chip8_step)(chip8);
+        }
+        else
+        {
+            const struct chip8_decoded* decoded = chip8_predecode_fetch(predecode, chip8, pc);
+            int length = decoded->length;
+            if (end - chip8->cycles < (unsigned long long) length)
+            {
+                length = end - chip8->cycles;
+                CHIP8_EXEC_NAME(chip8_dispatch_decoded)(chip8, decoded, pc, length);
+            }
+            else if (decoded->super)
+            {
+                CHIP8_EXEC_NAME(chip8_exec_super)(chip8, decoded, pc);
+            }
+            else
+            {
+                CHIP8_EXEC_NAME(chip8_dispatch_decoded)(chip8, decoded, pc, length);
+            } /* End of if statement */
+            predecode->dispatches++;
+        } /* End of if statement */
+
+        if (chip8->idle != CHIP8_IDLE_NONE && !chip8->trace && chip8_idle_forward(chip8, end))
+        {
+            break;
+        } /* End of if statement */
+    } /* End of while loop */
+} /* End of run predecoded function */
+
+#undef CHIP8_EXEC_PASTE2
+#undef CHIP8_EXEC_PASTE
+#undef CHIP8_EXEC_NAME
+#undef CHIP8_EXEC_QUIRK
+#undef CHIP8_EXEC_MEMORY_SIZE
+#undef CHIP8_EXEC_PROFILE
+#undef CHIP8_EXEC_QUIRKS
@@ -0,0 +1,42 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8fleet.h */
+
+#ifndef CHIP8FLEET_H
+#define CHIP8FLEET_H
+
+#include <stdatomic.h>
+#include "chip8.h"
+#include "chip8triple.h"
+
+/* Keys go to every instance while focus is this */
+#define CHIP8_FLEET_ALL -1
+
+/* One emulator of a fleet and the triple buffer its frames leave by */
+struct chip8_fleet_instance
+{
+    struct chip8 chip8;
+    struct chip8_triple triple;
+    unsigned long long frames;
+    unsigned long long slept;
+}; /* End fleet instance struct */
+
+/* Many copies of one program, each with its own random seed, split
+ * into contiguous shards run by however many worker threads the caller
+ * starts. A worker only ever touches its own shard; the viewer reads
+ * each instance's triple buffer and feeds input through keys, sent to
+ * the focused instance or to all of them. With powersave set, frames of
+ * instances that chip8_can_sleep are skipped rather than run. */
+struct chip8_fleet
+{
+    int count;
+    bool powersave;
+    struct chip8_fleet_instance* instances;
+    _Atomic unsigned int keys;
+    _Atomic int focus;
+}; /* End fleet struct */
+
+int chip8_fleet_init(struct chip8_fleet* fleet, const struct chip8* program, int count);
+void chip8_fleet_free(struct chip8_fleet* fleet);
+int chip8_fleet_run_frame(struct chip8_fleet* fleet, int worker, int workers);
+
+#endif
@@ -0,0 +1,40 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8frame.h */
+
+#ifndef CHIP8FRAME_H
+#define CHIP8FRAME_H
+
+#include <stdint.h>
+#include "chip8.h"
+
+/* A completed frame as handed to a viewer: registers plus each screen
+ * plane as packed rows of the current resolution */
+struct chip8_frame
+{
+    uint64_t frame;
+    uint16_t width;
+    uint16_t height;
+    uint16_t I;
+    uint16_t PC;
+    uint8_t V[CHIP8_TOTAL_DATA_REGISTERS];
+    uint8_t SP;
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+    uint8_t pixels[CHIP8_SCREEN_PLANES][CHIP8_SCREEN_PACKED_SIZE];
+}; /* End frame struct */
+
+void chip8_frame_capture(struct chip8_frame* frame, const struct chip8* chip8, unsigned long long number);
+
+/* Colour of pixel (x, y) : plane 0 | plane 1 << 1 */
+static inline int chip8_frame_pixel(const struct chip8_frame* frame, int x, int y)
+{
+    int offset = y * (frame->width / 8) + x / 8;
+    int colour = 0;
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        colour |= ((frame->pixels[plane][offset] >> (7 - x % 8)) & 1) << plane;
+    } /* End of for loop */
+    return colour;
+} /* End of frame pixel function */
+
+#endif
@@ -0,0 +1,21 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8hash.h */
+
+#ifndef CHIP8HASH_H
+#define CHIP8HASH_H
+
+struct chip8;
+
+/* 64-bit FNV-1a digests of the observable machine state. Registers
+ * covers V, I, the timers, PC, SP and the stack. */
+struct chip8_hashes
+{
+    unsigned long long screen;
+    unsigned long long registers;
+    unsigned long long memory;
+}; /* End hashes struct */
+
+void chip8_hash(const struct chip8* chip8, struct chip8_hashes* hashes);
+unsigned long long chip8_hash_screen(const struct chip8* chip8);
+
+#endif
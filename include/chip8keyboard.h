@@ -17,6 +17,7 @@ void chip8_keyboard_set_map(struct chip8_keyboard* keyboard, const char* map);
 int chip8_keyboard_map(struct chip8_keyboard* keyboard, char key);
 void chip8_keyboard_down(struct chip8_keyboard* keyboard, int key);
 void chip8_keyboard_up(struct chip8_keyboard* keyboard, int key);
+void chip8_keyboard_set_mask(struct chip8_keyboard* keyboard, unsigned int mask);
 bool chip8_keyboard_is_down(struct chip8_keyboard* keyboard, int key);
 
 #endif
@@ -0,0 +1,12 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8loader.h */
+
+#ifndef CHIP8LOADER_H
+#define CHIP8LOADER_H
+
+#include "chip8.h"
+
+enum chip8_load_result chip8_load_file(struct chip8* chip8, const char* filename);
+const struct chip8_profile* chip8_profile_for_file(const char* filename);
+
+#endif
@@ -0,0 +1,45 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8lockstep.h */
+
+#ifndef CHIP8LOCKSTEP_H
+#define CHIP8LOCKSTEP_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "chip8.h"
+#include "chip8backend.h"
+
+/* The first instruction after which two cores disagreed, with the state
+ * of both cores just before and just after it. If replaying from the
+ * last checkpoint never disagreed again, reproduced is false, before is
+ * the checkpoint and a and b are the states the cores were found in. */
+struct chip8_divergence
+{
+    bool reproduced;
+    unsigned long long cycle;
+    unsigned short PC;
+    unsigned short opcode;
+    struct chip8 before;
+    struct chip8 a;
+    struct chip8 b;
+}; /* End divergence struct */
+
+/* Two cores started from the same state. Their timers run off their own
+ * cycle counts, as they would under chip8_run_frame. */
+struct chip8_lockstep
+{
+    const struct chip8_backend* backend_a;
+    const struct chip8_backend* backend_b;
+    struct chip8 a;
+    struct chip8 b;
+    struct chip8 checkpoint;
+    unsigned int interval;
+}; /* End lockstep struct */
+
+bool chip8_state_equal(const struct chip8* a, const struct chip8* b);
+void chip8_lockstep_init(struct chip8_lockstep* lockstep, const struct chip8_backend* backend_a,
+        const struct chip8_backend* backend_b, const struct chip8* start, unsigned int interval);
+int chip8_lockstep_run(struct chip8_lockstep* lockstep, unsigned long long cycles, struct chip8_divergence* divergence);
+void chip8_lockstep_print(FILE* f, const struct chip8_lockstep* lockstep, const struct chip8_divergence* divergence);
+
+#endif
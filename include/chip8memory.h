@@ -4,14 +4,149 @@
 #ifndef CHIP8MEMORY_H
 #define CHIP8MEMORY_H
 
+#include <stdbool.h>
+#include <string.h>
 #include "config.h"
+
+/* What an access outside the address space does:
+ *   WRAP   - the address is masked to the address space
+ *   TRAP   - the process aborts
+ *   REPORT - the address is masked and memory.fault is set; the core
+ *            stops with CHIP8_FAULT_MEMORY after the instruction
+ * Release builds default to WRAP and debug builds to TRAP.
+ *
+ * The address space belongs to the quirk profile : 4 KB, or 64 KB under
+ * XO-CHIP. Memory always has room for the larger one, and the accessors
+ * take the size of the space in use, a power of two, as space. */
+#define CHIP8_MEMORY_WRAP 0
+#define CHIP8_MEMORY_TRAP 1
+#define CHIP8_MEMORY_REPORT 2
+
+#ifndef CHIP8_MEMORY_POLICY
+#ifdef NDEBUG
+#define CHIP8_MEMORY_POLICY CHIP8_MEMORY_WRAP
+#else
+#define CHIP8_MEMORY_POLICY CHIP8_MEMORY_TRAP
+#endif
+#endif
+
+/* Every store marks its 64-byte page in dirty, one bit per page, so
+ * snapshots and code caches can find what changed since they last
+ * cleared it. Page p is bit p % 64 of dirty[p / 64]. checkpoint names
+ * the snapshot dirty is relative to, 0 for none (chip8snapshot.h). */
+#define CHIP8_MEMORY_PAGE_SHIFT 6
+#define CHIP8_MEMORY_PAGE_SIZE (1 << CHIP8_MEMORY_PAGE_SHIFT)
+#define CHIP8_MEMORY_TOTAL_PAGES (CHIP8_MEMORY_SIZE >> CHIP8_MEMORY_PAGE_SHIFT)
+#define CHIP8_MEMORY_DIRTY_WORDS ((CHIP8_MEMORY_TOTAL_PAGES + 63) / 64)
+
 struct chip8_memory
 {
     unsigned char memory[CHIP8_MEMORY_SIZE];
+    unsigned long long dirty[CHIP8_MEMORY_DIRTY_WORDS];
+    unsigned long long checkpoint;
+    bool fault;
 }; /* End memory struct */
 
-void chip8_memory_set(struct chip8_memory *memory, int index, unsigned char val);
-unsigned char chip8_memory_get(struct chip8_memory *memory, int index);
-unsigned short chip8_memory_get_short(struct chip8_memory* memory, int index);
+_Static_assert((CHIP8_MEMORY_SIZE & (CHIP8_MEMORY_SIZE - 1)) == 0, "the memory size must be a power of two");
+_Static_assert((CHIP8_CLASSIC_MEMORY_SIZE & (CHIP8_CLASSIC_MEMORY_SIZE - 1)) == 0,
+        "the classic memory size must be a power of two");
+
+int chip8_memory_out_of_bounds(struct chip8_memory* memory, int space, int index);
+void chip8_memory_write_block_wrapped(struct chip8_memory* memory, int space, int index, const unsigned char* src, int size);
+void chip8_memory_read_block_wrapped(struct chip8_memory* memory, int space, int index, unsigned char* dst, int size);
+
+static inline int chip8_memory_index(struct chip8_memory* memory, int space, int index)
+{
+#if CHIP8_MEMORY_POLICY == CHIP8_MEMORY_WRAP
+    (void) memory;
+    return index & (space - 1);
+#else
+    if ((unsigned int) index < (unsigned int) space)
+    {
+        return index;
+    } /* End of if statement */
+    return chip8_memory_out_of_bounds(memory, space, index);
+#endif
+} /* End memory index function */
+
+/* Marks the pages covering size bytes from an in-range index. A range
+ * inside one bitmap word, the common case, is a single OR. */
+static inline void chip8_memory_mark(struct chip8_memory* memory, int index, int size)
+{
+    int first = index >> CHIP8_MEMORY_PAGE_SHIFT;
+    int last = (index + size - 1) >> CHIP8_MEMORY_PAGE_SHIFT;
+    if (first >> 6 == last >> 6)
+    {
+        memory->dirty[first >> 6] |= (2ULL << (last & 63)) - (1ULL << (first & 63));
+        return;
+    } /* End of if statement */
+
+    for (int page = first; page <= last; page++)
+    {
+        memory->dirty[page >> 6] |= 1ULL << (page & 63);
+    } /* End of for loop */
+} /* End memory mark function */
+
+static inline void chip8_memory_clear_dirty(struct chip8_memory* memory)
+{
+    memset(memory->dirty, 0, sizeof(memory->dirty));
+} /* End memory clear dirty function */
+
+static inline void chip8_memory_set(struct chip8_memory* memory, int space, int index, unsigned char val)
+{
+    index = chip8_memory_index(memory, space, index);
+    memory->memory[index] = val;
+    int page = index >> CHIP8_MEMORY_PAGE_SHIFT;
+    memory->dirty[page >> 6] |= 1ULL << (page & 63);
+} /* End memory set function */
+
+static inline unsigned char chip8_memory_get(struct chip8_memory* memory, int space, int index)
+{
+    return memory->memory[chip8_memory_index(memory, space, index)];
+} /* End memory get function */
+
+/* Big endian 16-bit read, a single load unless it straddles the end of
+ * the address space */
+static inline unsigned short chip8_memory_get_short(struct chip8_memory* memory, int space, int index)
+{
+    if ((unsigned int) index < (unsigned int) space - 1)
+    {
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        unsigned short word;
+        memcpy(&word, &memory->memory[index], sizeof(word));
+        return __builtin_bswap16(word);
+#else
+        return memory->memory[index] << 8 | memory->memory[index+1];
+#endif
+    } /* End of if statement */
+
+    unsigned char byte1 = chip8_memory_get(memory, space, index);
+    unsigned char byte2 = chip8_memory_get(memory, space, index+1);
+    return byte1 << 8 | byte2;
+} /* End of get short function */
+
+/* Copies size bytes in one go. The range is checked once and only a
+ * range that leaves the address space takes the wrapping slow path. */
+static inline void chip8_memory_write_block(struct chip8_memory* memory, int space, int index,
+        const unsigned char* src, int size)
+{
+    if ((unsigned int) index + size <= (unsigned int) space)
+    {
+        memcpy(&memory->memory[index], src, size);
+        chip8_memory_mark(memory, index, size);
+        return;
+    } /* End of if statement */
+    chip8_memory_write_block_wrapped(memory, space, index, src, size);
+} /* End of write block function */
+
+static inline void chip8_memory_read_block(struct chip8_memory* memory, int space, int index, unsigned char* dst, int size)
+{
+    if ((unsigned int) index + size <= (unsigned int) space)
+    {
+        memcpy(dst, &memory->memory[index], size);
+        return;
+    } /* End of if statement */
+    chip8_memory_read_block_wrapped(memory, space, index, dst, size);
+} /* End of read block function */
 
 #endif
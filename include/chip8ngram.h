@@ -0,0 +1,35 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8ngram.h */
+
+#ifndef CHIP8NGRAM_H
+#define CHIP8NGRAM_H
+
+#include <stdio.h>
+#include "chip8.h"
+#include "chip8predecode.h"
+
+/* How often each instruction form ran, and each pair and triple of
+ * forms ran back to back from consecutive addresses, i.e. the runs
+ * the predecoder could fuse. Counts only ever add up, so profiles from
+ * several runs or machines can be loaded into one. */
+struct chip8_ngrams
+{
+    unsigned long long singles[CHIP8_TOTAL_OPS];
+    unsigned long long pairs[CHIP8_TOTAL_OPS][CHIP8_TOTAL_OPS];
+    unsigned long long* triples;
+    int previous[2];
+    unsigned short next_pc;
+}; /* End ngrams struct */
+
+int chip8_ngrams_init(struct chip8_ngrams* ngrams);
+void chip8_ngrams_free(struct chip8_ngrams* ngrams);
+void chip8_ngrams_record(struct chip8_ngrams* ngrams, unsigned short pc, unsigned short opcode);
+void chip8_ngrams_run(struct chip8_ngrams* ngrams, struct chip8* chip8, int cycles);
+void chip8_ngrams_write(const struct chip8_ngrams* ngrams, FILE* f);
+int chip8_ngrams_parse(struct chip8_ngrams* ngrams, const char* line);
+int chip8_ngrams_save(const struct chip8_ngrams* ngrams, const char* filename);
+int chip8_ngrams_load(struct chip8_ngrams* ngrams, const char* filename);
+
+int chip8_fusion_select(struct chip8_fusion* fusion, const struct chip8_ngrams* ngrams, int max);
+
+#endif
@@ -0,0 +1,152 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8predecode.h */
+
+#ifndef CHIP8PREDECODE_H
+#define CHIP8PREDECODE_H
+
+#include <string.h>
+#include "chip8.h"
+
+/* Instruction forms, one per opcode pattern the interpreter tells
+ * apart. Patterns it ignores decode as INVALID. */
+enum chip8_op
+{
+    CHIP8_OP_CLS,
+    CHIP8_OP_RET,
+    CHIP8_OP_SCROLL_DOWN,
+    CHIP8_OP_SCROLL_UP,
+    CHIP8_OP_SCROLL_RIGHT,
+    CHIP8_OP_SCROLL_LEFT,
+    CHIP8_OP_LORES,
+    CHIP8_OP_HIRES,
+    CHIP8_OP_SYS,
+    CHIP8_OP_JP,
+    CHIP8_OP_CALL,
+    CHIP8_OP_SE_BYTE,
+    CHIP8_OP_SNE_BYTE,
+    CHIP8_OP_SE_REG,
+    CHIP8_OP_SAVE_RANGE,
+    CHIP8_OP_LOAD_RANGE,
+    CHIP8_OP_LD_BYTE,
+    CHIP8_OP_ADD_BYTE,
+    CHIP8_OP_LD_REG,
+    CHIP8_OP_OR,
+    CHIP8_OP_AND,
+    CHIP8_OP_XOR,
+    CHIP8_OP_ADD_REG,
+    CHIP8_OP_SUB,
+    CHIP8_OP_SHR,
+    CHIP8_OP_SUBN,
+    CHIP8_OP_SHL,
+    CHIP8_OP_SNE_REG,
+    CHIP8_OP_LD_I,
+    CHIP8_OP_JP_V0,
+    CHIP8_OP_RND,
+    CHIP8_OP_DRW,
+    CHIP8_OP_SKP,
+    CHIP8_OP_SKNP,
+    CHIP8_OP_LD_I_LONG,
+    CHIP8_OP_PLANES,
+    CHIP8_OP_AUDIO,
+    CHIP8_OP_LD_VX_DT,
+    CHIP8_OP_LD_VX_K,
+    CHIP8_OP_LD_DT_VX,
+    CHIP8_OP_LD_ST_VX,
+    CHIP8_OP_ADD_I,
+    CHIP8_OP_LD_F,
+    CHIP8_OP_LD_HF,
+    CHIP8_OP_BCD,
+    CHIP8_OP_PITCH,
+    CHIP8_OP_STORE,
+    CHIP8_OP_READ,
+    CHIP8_OP_INVALID,
+    CHIP8_TOTAL_OPS
+}; /* End op enum */
+
+/* The longest run of instructions fused into one dispatch, as many as
+ * an entry's 8 bytes of code hold */
+#define CHIP8_FUSE_MAX 4
+#define CHIP8_FUSION_MAX_PATTERNS 32
+
+/* A run of forms executed as one when they sit one after the other in
+ * memory. count is how often the profile saw the run. */
+struct chip8_fusion_pattern
+{
+    unsigned char ops[CHIP8_FUSE_MAX];
+    int length;
+    unsigned long long count;
+}; /* End fusion pattern struct */
+
+/* The runs to fuse, normally picked from profiling data with
+ * chip8_fusion_select rather than written down by hand */
+struct chip8_fusion
+{
+    struct chip8_fusion_pattern patterns[CHIP8_FUSION_MAX_PATTERNS];
+    int count;
+}; /* End fusion struct */
+
+/* One address's decoded instructions. code is the 8 bytes of memory
+ * from the address as they were when decoded and mask picks out the
+ * ones the entry depends on, so an entry is checked against memory with
+ * one load and compare per dispatch : code that rewrites itself, a
+ * restored snapshot or a newly loaded ROM just decodes again. super is
+ * the generated handler for the run, 0 if it has none (chip8super.h). */
+struct chip8_decoded
+{
+    unsigned long long code;
+    unsigned long long mask;
+    unsigned short opcodes[CHIP8_FUSE_MAX];
+    unsigned char ops[CHIP8_FUSE_MAX];
+    unsigned char length;
+    unsigned char super;
+}; /* End decoded struct */
+
+/* A decode cache with an entry per address. Entries hold a single
+ * instruction unless the instructions from the address start one of
+ * the superinstructions compiled in from chip8super.h or one of the
+ * fusion's patterns, in which case the whole run executes off one
+ * dispatch; the longest match wins. Nothing in it belongs to a
+ * particular core, so one cache can serve any number of cores run from
+ * the same thread. */
+struct chip8_predecode
+{
+    struct chip8_decoded* entries;
+    struct chip8_fusion fusion;
+    unsigned long long decodes;
+    unsigned long long dispatches;
+}; /* End predecode struct */
+
+enum chip8_op chip8_op_decode(unsigned short opcode);
+const char* chip8_op_name(enum chip8_op op);
+int chip8_op_find(const char* name);
+bool chip8_op_writes_memory(enum chip8_op op);
+bool chip8_op_straight(enum chip8_op op);
+
+void chip8_predecode_decode(struct chip8_predecode* predecode, const struct chip8* chip8,
+        unsigned short pc, struct chip8_decoded* decoded, unsigned long long code);
+
+/* The entry for pc, decoded again if memory no longer matches it. pc
+ * must leave room for all 8 bytes of code. */
+static inline const struct chip8_decoded* chip8_predecode_fetch(struct chip8_predecode* predecode,
+        const struct chip8* chip8, unsigned short pc)
+{
+    struct chip8_decoded* decoded = &predecode->entries[pc];
+    unsigned long long code;
+    memcpy(&code, &chip8->memory.memory[pc], sizeof(code));
+    if (((code ^ decoded->code) & decoded->mask) != 0 || decoded->mask == 0)
+    {
+        chip8_predecode_decode(predecode, chip8, pc, decoded, code);
+    } /* End of if statement */
+    return decoded;
+} /* End of predecode fetch function */
+
+int chip8_predecode_init(struct chip8_predecode* predecode, const struct chip8_fusion* fusion);
+void chip8_predecode_free(struct chip8_predecode* predecode);
+void chip8_predecode_run(struct chip8_predecode* predecode, struct chip8* chip8, int cycles);
+void chip8_predecode_run_frame(struct chip8_predecode* predecode, struct chip8* chip8);
+void chip8_predecode_step(struct chip8_predecode* predecode, struct chip8* chip8);
+void chip8_predecode_backend_step(struct chip8* chip8);
+void chip8_predecode_backend_fuse(const struct chip8_fusion* fusion);
+void chip8_predecode_backend_run(struct chip8* chip8, int cycles);
+
+#endif
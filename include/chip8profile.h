@@ -0,0 +1,66 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8profile.h */
+
+#ifndef CHIP8PROFILE_H
+#define CHIP8PROFILE_H
+
+/* Behaviour that differs between CHIP-8 variants:
+ *   SHIFT_VY         - 8xy6/8xyE shift Vy into Vx instead of shifting Vx
+ *   INCREMENT_I      - Fx55/Fx65 leave I pointing past the last register
+ *   JUMP_VX          - Bxnn jumps to xnn + Vx instead of nnn + V0
+ *   VF_RESET         - 8xy1/8xy2/8xy3 clear VF
+ *   CLIP             - sprites are clipped at the screen edges instead
+ *                      of wrapping around
+ *   DISPLAY_WAIT     - Dxyn waits for the next 60Hz tick before drawing
+ *   BIG_LORES        - Dxy0 draws a 16x16 sprite in lo-res mode too,
+ *                      not just in hi-res mode
+ *   XO_CHIP          - the XO-CHIP instructions 00Dn, 5xy2/5xy3,
+ *                      F000 nnnn, Fn01, F002 and Fx3A run and the
+ *                      address space is 64 KB; without it they are
+ *                      ignored like any other unknown opcode and
+ *                      memory accesses wrap or trap at 4 KB */
+#define CHIP8_QUIRK_SHIFT_VY (1 << 0)
+#define CHIP8_QUIRK_INCREMENT_I (1 << 1)
+#define CHIP8_QUIRK_JUMP_VX (1 << 2)
+#define CHIP8_QUIRK_VF_RESET (1 << 3)
+#define CHIP8_QUIRK_CLIP (1 << 4)
+#define CHIP8_QUIRK_DISPLAY_WAIT (1 << 5)
+#define CHIP8_QUIRK_BIG_LORES (1 << 6)
+#define CHIP8_QUIRK_XO_CHIP (1 << 7)
+
+/* "default" is this emulator's original behaviour, after Cowgod's
+ * reference. The others follow the COSMAC VIP interpreter, SUPER-CHIP
+ * 1.1 and XO-CHIP. */
+#define CHIP8_PROFILE_DEFAULT_QUIRKS 0
+#define CHIP8_PROFILE_VIP_QUIRKS (CHIP8_QUIRK_SHIFT_VY | CHIP8_QUIRK_INCREMENT_I | CHIP8_QUIRK_VF_RESET \
+        | CHIP8_QUIRK_CLIP | CHIP8_QUIRK_DISPLAY_WAIT)
+#define CHIP8_PROFILE_SCHIP_QUIRKS (CHIP8_QUIRK_JUMP_VX | CHIP8_QUIRK_CLIP)
+#define CHIP8_PROFILE_XOCHIP_QUIRKS (CHIP8_QUIRK_SHIFT_VY | CHIP8_QUIRK_INCREMENT_I | CHIP8_QUIRK_BIG_LORES \
+        | CHIP8_QUIRK_XO_CHIP)
+
+struct chip8;
+struct chip8_predecode;
+
+/* A quirk profile and the interpreter specialised for it. Each profile
+ * has its own copy of the interpreter with its quirks fixed at compile
+ * time, so choosing a profile costs one indirect call per chip8_step or
+ * per chip8_run_frame and nothing per instruction inside a frame. The
+ * _predecoded pair step and run the same over a decode cache, see
+ * chip8predecode.h. */
+struct chip8_profile
+{
+    const char* name;
+    unsigned int quirks;
+    void (*exec)(struct chip8* chip8, unsigned short opcode);
+    void (*step)(struct chip8* chip8);
+    void (*run)(struct chip8* chip8, int cycles);
+    void (*step_predecoded)(struct chip8_predecode* predecode, struct chip8* chip8);
+    void (*run_predecoded)(struct chip8_predecode* predecode, struct chip8* chip8, int cycles);
+}; /* End profile struct */
+
+extern const struct chip8_profile chip8_profiles[];
+extern const int chip8_total_profiles;
+
+const struct chip8_profile* chip8_profile_find(const char* name);
+
+#endif
@@ -0,0 +1,45 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8profiler.h */
+
+#ifndef CHIP8PROFILER_H
+#define CHIP8PROFILER_H
+
+#include <stddef.h>
+#include "chip8.h"
+#include "chip8ngram.h"
+#include "chip8predecode.h"
+
+/* A transfer of control other than falling through to the next
+ * instruction : a jump, call, return or taken skip */
+struct chip8_profiler_edge
+{
+    unsigned short from;
+    unsigned short to;
+    unsigned long long count;
+}; /* End profiler edge struct */
+
+/* What a profiling build saw the core run : how often the instruction
+ * at each address ran and which opcode it was last time, how often each
+ * edge was taken, and the n-grams of the forms run. Edges sit in an
+ * open addressed table keyed by both addresses. Like n-grams, counts
+ * only ever add up, so the files of many runs of a ROM load into one
+ * profiler; runs of different ROMs want a profiler each. */
+struct chip8_profiler
+{
+    unsigned long long* counts;
+    unsigned short* opcodes;
+    struct chip8_profiler_edge* edges;
+    size_t edge_count;
+    size_t edge_capacity;
+    struct chip8_ngrams ngrams;
+}; /* End profiler struct */
+
+int chip8_profiler_init(struct chip8_profiler* profiler);
+void chip8_profiler_free(struct chip8_profiler* profiler);
+void chip8_profiler_record(struct chip8_profiler* profiler, unsigned short pc, unsigned short opcode, unsigned short next);
+void chip8_profiler_add_edge(struct chip8_profiler* profiler, unsigned short from, unsigned short to, unsigned long long count);
+int chip8_profiler_save(const struct chip8_profiler* profiler, const char* filename);
+int chip8_profiler_load(struct chip8_profiler* profiler, const char* filename);
+int chip8_profiler_traces(const struct chip8_profiler* profilers, int count, struct chip8_fusion* traces, int max);
+
+#endif
@@ -0,0 +1,40 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8publish.h */
+
+#ifndef CHIP8PUBLISH_H
+#define CHIP8PUBLISH_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "chip8frame.h"
+
+/* Layout of the POSIX shared memory segment. sequence is a seqlock: it
+ * is odd while the emulator is writing, so a reader copies the frame and
+ * retries if sequence was odd or changed meanwhile. The emulator never
+ * waits for readers. */
+struct chip8_shared_frame
+{
+    _Atomic uint32_t sequence;
+    struct chip8_frame data;
+}; /* End shared frame struct */
+
+struct chip8_publisher
+{
+    struct chip8_shared_frame* shared;
+    char name[64];
+}; /* End publisher struct */
+
+struct chip8_subscriber
+{
+    const struct chip8_shared_frame* shared;
+}; /* End subscriber struct */
+
+int chip8_publisher_open(struct chip8_publisher* publisher, const char* name);
+void chip8_publisher_publish(struct chip8_publisher* publisher, const struct chip8* chip8, unsigned long long frame);
+void chip8_publisher_close(struct chip8_publisher* publisher);
+
+int chip8_subscriber_open(struct chip8_subscriber* subscriber, const char* name);
+int chip8_subscriber_read(const struct chip8_subscriber* subscriber, struct chip8_frame* frame);
+void chip8_subscriber_close(struct chip8_subscriber* subscriber);
+
+#endif
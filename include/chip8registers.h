@@ -6,14 +6,19 @@
 
 #include "config.h"
 
+/* The delay and sound timers are not counted down every frame. Each is
+ * kept as the value last written and the cycle it was written at, and
+ * chip8_delay_timer / chip8_sound_timer work out what it reads now. */
 struct chip8_registers
 {
     unsigned char V[CHIP8_TOTAL_DATA_REGISTERS];
     unsigned short I;
-    unsigned char delay_timer;
-    unsigned char sound_timer;
+    unsigned char delay_value;
+    unsigned char sound_value;
     unsigned short PC;
     unsigned char SP;
+    unsigned long long delay_cycle;
+    unsigned long long sound_cycle;
 }; /* End registers struct */
 
 #endif
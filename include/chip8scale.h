@@ -0,0 +1,30 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8scale.h */
+
+#ifndef CHIP8SCALE_H
+#define CHIP8SCALE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "chip8frame.h"
+
+/* Largest scale chip8_scale_rgba takes */
+#define CHIP8_SCALE_MAX 32
+
+/* Expands a frame's packed planes into one byte per output pixel,
+ * lut[colour] for each, scaled up scale times in both directions by
+ * nearest neighbour. out holds frame->height * scale rows of
+ * frame->width * scale bytes. */
+void chip8_scale_indexed(const struct chip8_frame* frame, const unsigned char lut[4], int scale, unsigned char* out);
+
+/* The same with 32-bit pixels, palette[colour] for each, written in
+ * whatever byte order the palette entries use. Rows of out are pitch
+ * bytes apart, as with a locked SDL texture. */
+void chip8_scale_rgba(const struct chip8_frame* frame, const uint32_t palette[4], int scale, uint32_t* out, size_t pitch);
+
+/* Shrinks a hi-res frame to lo-res size, each output pixel the OR of
+ * the 2x2 block it covers so single-pixel lines stay visible. Copies
+ * only the size and the pixels. */
+void chip8_scale_halve(const struct chip8_frame* frame, struct chip8_frame* out);
+
+#endif
@@ -0,0 +1,66 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8scheduler.h */
+
+#ifndef CHIP8SCHEDULER_H
+#define CHIP8SCHEDULER_H
+
+#include <stddef.h>
+#include "chip8.h"
+
+/* What happens when an event comes due:
+ *   FRAME      - a 60Hz frame boundary, handed to the handler so a
+ *                frontend can present or publish
+ *   KEY_DOWN   - key goes down, applied by the scheduler
+ *   KEY_UP     - key goes up, applied by the scheduler
+ *   CHECKPOINT - handed to the handler, e.g. to take a snapshot
+ * Timer ticks and the end of a display wait need no events of their
+ * own : both are read off the cycle count, so a run goes straight
+ * through them. */
+enum chip8_event_type
+{
+    CHIP8_EVENT_FRAME,
+    CHIP8_EVENT_KEY_DOWN,
+    CHIP8_EVENT_KEY_UP,
+    CHIP8_EVENT_CHECKPOINT
+}; /* End event type enum */
+
+/* An event due before the instruction at cycle runs. A period other
+ * than 0 schedules it again that many cycles later each time. */
+struct chip8_event
+{
+    unsigned long long cycle;
+    unsigned long long period;
+    unsigned long long order;
+    enum chip8_event_type type;
+    int key;
+}; /* End event struct */
+
+struct chip8_scheduler;
+
+/* Called for FRAME and CHECKPOINT events. Returning non-zero stops
+ * chip8_scheduler_run, which returns the same value. */
+typedef int (*chip8_event_handler)(void* context, struct chip8* chip8, const struct chip8_event* event);
+
+/* Events in a binary min-heap keyed by cycle, in the order they were
+ * pushed when cycles are equal. chip8_scheduler_run executes the core
+ * straight through to the next event with the profile's batched run
+ * loop and only stops there, so nothing is checked per instruction
+ * beyond what a plain frame already checks. */
+struct chip8_scheduler
+{
+    struct chip8_event* heap;
+    size_t count;
+    size_t capacity;
+    unsigned long long order;
+    chip8_event_handler handler;
+    void* context;
+}; /* End scheduler struct */
+
+int chip8_scheduler_init(struct chip8_scheduler* scheduler, size_t capacity, chip8_event_handler handler, void* context);
+void chip8_scheduler_free(struct chip8_scheduler* scheduler);
+void chip8_scheduler_clear(struct chip8_scheduler* scheduler);
+int chip8_scheduler_push(struct chip8_scheduler* scheduler, unsigned long long cycle, unsigned long long period,
+        enum chip8_event_type type, int key);
+int chip8_scheduler_run(struct chip8_scheduler* scheduler, struct chip8* chip8, unsigned long long until);
+
+#endif
@@ -7,14 +7,77 @@
 #include <stdbool.h>
 #include "config.h"
 
+/* 64-bit words per framebuffer row, enough for the hi-res width */
+#define CHIP8_SCREEN_ROW_WORDS (CHIP8_HIRES_WIDTH / 64)
+
+/* XO-CHIP bit planes; a pixel's colour is plane 0 | plane 1 << 1 */
+#define CHIP8_SCREEN_PLANES 2
+
+/* Largest size of one plane as packed rows, eight pixels per byte, MSB
+ * first. chip8_screen_packed_size gives the size in the current mode. */
+#define CHIP8_SCREEN_PACKED_SIZE (CHIP8_HIRES_WIDTH * CHIP8_HIRES_HEIGHT / 8)
+
+/* Each plane is bit-packed: pixel x of row y is bit 63 - x % 64 of
+ * rows[plane][y][x / 64], so a row reads left to right MSB first and
+ * scrolls are word shifts. In lo-res mode only the first CHIP8_HEIGHT
+ * rows and the first word of each row are used; the rest stays zero.
+ *
+ * planes is the Fn01 selection mask. Clearing, drawing and scrolling
+ * only touch the selected planes; a sprite holds the data for each
+ * selected plane in turn.
+ *
+ * dirty_rows has bit y set once row y has been drawn to, scrolled or
+ * cleared. Nothing in the core resets it; a consumer takes the mask with
+ * chip8_screen_take_dirty_rows once per frame and redraws only those
+ * rows. */
 struct chip8_screen
 {
-    bool pixels[CHIP8_HEIGHT][CHIP8_WIDTH];
+    unsigned long long rows[CHIP8_SCREEN_PLANES][CHIP8_HIRES_HEIGHT][CHIP8_SCREEN_ROW_WORDS];
+    unsigned long long dirty_rows;
+    bool hires;
+    unsigned char planes;
 }; /* End screen struct */
 
+_Static_assert(CHIP8_WIDTH == 64, "lo-res rows are a single word");
+_Static_assert(CHIP8_HIRES_WIDTH == 128, "hi-res rows are two words");
+_Static_assert(CHIP8_HIRES_HEIGHT <= 64, "dirty_rows holds 64 rows");
+
+static inline int chip8_screen_width(const struct chip8_screen* screen)
+{
+    return screen->hires ? CHIP8_HIRES_WIDTH : CHIP8_WIDTH;
+} /* End of screen width function */
+
+static inline int chip8_screen_height(const struct chip8_screen* screen)
+{
+    return screen->hires ? CHIP8_HIRES_HEIGHT : CHIP8_HEIGHT;
+} /* End of screen height function */
+
+static inline int chip8_screen_packed_size(const struct chip8_screen* screen)
+{
+    return chip8_screen_width(screen) * chip8_screen_height(screen) / 8;
+} /* End of screen packed size function */
+
+/* Number of planes a sprite draws into, and so how many copies of the
+ * sprite data it reads */
+static inline int chip8_screen_plane_count(const struct chip8_screen* screen)
+{
+    return (screen->planes & 1) + (screen->planes >> 1 & 1);
+} /* End of screen plane count function */
+
+void chip8_screen_init(struct chip8_screen* screen);
 void chip8_screen_clear(struct chip8_screen* screen);
+void chip8_screen_set_hires(struct chip8_screen* screen, bool hires);
+void chip8_screen_select_planes(struct chip8_screen* screen, int planes);
 void chip8_screen_set(struct chip8_screen* screen, int x, int y);
-bool chip8_screen_is_set(struct chip8_screen* screen, int x, int y);
-bool chip8_screen_draw_sprite(struct chip8_screen* screen, int x, int y, const char* sprite, int num);
+bool chip8_screen_is_set(const struct chip8_screen* screen, int x, int y);
+int chip8_screen_pixel(const struct chip8_screen* screen, int x, int y);
+bool chip8_screen_draw_sprite(struct chip8_screen* screen, int x, int y, const char* sprite, int num, bool clip);
+bool chip8_screen_draw_sprite16(struct chip8_screen* screen, int x, int y, const char* sprite, bool clip);
+void chip8_screen_scroll_down(struct chip8_screen* screen, int num);
+void chip8_screen_scroll_up(struct chip8_screen* screen, int num);
+void chip8_screen_scroll_right(struct chip8_screen* screen);
+void chip8_screen_scroll_left(struct chip8_screen* screen);
+unsigned long long chip8_screen_take_dirty_rows(struct chip8_screen* screen);
+void chip8_screen_pack(const struct chip8_screen* screen, int plane, unsigned char* out);
 
 #endif
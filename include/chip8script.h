@@ -0,0 +1,37 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8script.h */
+
+#ifndef CHIP8SCRIPT_H
+#define CHIP8SCRIPT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct chip8;
+struct chip8_scheduler;
+
+struct chip8_script_event
+{
+    unsigned long frame;
+    int key;
+    bool down;
+}; /* End script event struct */
+
+/* Scripted keyboard input for headless runs, one event per line:
+ *     FRAME KEY down|up
+ * with KEY in hex. Blank lines and lines starting with # are ignored and
+ * events must be in frame order. */
+struct chip8_script
+{
+    struct chip8_script_event* events;
+    size_t count;
+    size_t next;
+}; /* End script struct */
+
+int chip8_script_load(struct chip8_script* script, const char* filename);
+void chip8_script_free(struct chip8_script* script);
+void chip8_script_rewind(struct chip8_script* script);
+void chip8_script_apply(struct chip8_script* script, struct chip8* chip8, unsigned long frame);
+int chip8_script_schedule(const struct chip8_script* script, struct chip8_scheduler* scheduler);
+
+#endif
@@ -0,0 +1,31 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8snapshot.h */
+
+#ifndef CHIP8SNAPSHOT_H
+#define CHIP8SNAPSHOT_H
+
+#include "chip8.h"
+
+/* A saved machine state that an instance can be rewound to. The
+ * instance's trace attachment is never saved or restored.
+ *
+ * Each take or update gives the snapshot a new checkpoint id, records it
+ * in the instance and clears the instance's dirty page bitmap. As long
+ * as the instance's memory is only changed through the memory API from
+ * then on, chip8_snapshot_update and chip8_snapshot_restore copy just
+ * the pages written since. Only the instance's latest checkpoint can be
+ * brought up to date that way; restoring an older snapshot, or one taken
+ * from another instance, copies the whole memory and makes that snapshot
+ * the latest checkpoint again, so any number of snapshots can be kept
+ * for rewinding and save states. */
+struct chip8_snapshot
+{
+    struct chip8 state;
+    unsigned long long checkpoint;
+}; /* End snapshot struct */
+
+void chip8_snapshot_take(struct chip8_snapshot* snapshot, struct chip8* chip8);
+void chip8_snapshot_update(struct chip8_snapshot* snapshot, struct chip8* chip8);
+void chip8_snapshot_restore(const struct chip8_snapshot* snapshot, struct chip8* chip8);
+
+#endif
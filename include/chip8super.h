@@ -0,0 +1,517 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8super.h */
+
+/* Generated by fusegen from 3 counts files covering 858 instructions;
+ * regenerate rather than edit. The first part lists the runs for the
+ * predecoder, the second is included by chip8exec.h once per profile
+ * and defines a handler for each run plus chip8_exec_super, which
+ * picks the handler for a decoded entry. */
+
+#ifndef CHIP8SUPER_H
+#define CHIP8SUPER_H
+
+#include "chip8predecode.h"
+
+#define CHIP8_TOTAL_SUPERS 24
+
+/* The runs with a handler, entry super - 1 for super, ending in an
+ * empty pattern */
+#define CHIP8_SUPER_PATTERNS \
+    { { CHIP8_OP_LD_VX_DT, CHIP8_OP_SE_BYTE, CHIP8_OP_JP }, 3, 121ULL }, \
+    { { CHIP8_OP_SE_BYTE, CHIP8_OP_JP }, 2, 121ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_SKNP, CHIP8_OP_JP }, 3, 29ULL }, \
+    { { CHIP8_OP_SKNP, CHIP8_OP_JP }, 2, 29ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_LD_BYTE }, 2, 13ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_LD_I, CHIP8_OP_DRW }, 3, 6ULL }, \
+    { { CHIP8_OP_PLANES, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_BYTE }, 3, 4ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_I }, 3, 6ULL }, \
+    { { CHIP8_OP_ADD_BYTE, CHIP8_OP_LD_F, CHIP8_OP_DRW }, 3, 3ULL }, \
+    { { CHIP8_OP_LD_I, CHIP8_OP_DRW }, 2, 6ULL }, \
+    { { CHIP8_OP_LD_F, CHIP8_OP_DRW, CHIP8_OP_ADD_BYTE }, 3, 3ULL }, \
+    { { CHIP8_OP_DRW, CHIP8_OP_LD_BYTE }, 2, 5ULL }, \
+    { { CHIP8_OP_HIRES, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_BYTE }, 3, 2ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_DRW }, 2, 4ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_LD_HF, CHIP8_OP_LD_BYTE }, 3, 2ULL }, \
+    { { CHIP8_OP_DRW, CHIP8_OP_SCROLL_DOWN, CHIP8_OP_SCROLL_RIGHT }, 3, 2ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_I, CHIP8_OP_DRW }, 4, 6ULL }, \
+    { { CHIP8_OP_PLANES, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_I }, 4, 3ULL }, \
+    { { CHIP8_OP_HIRES, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_I }, 4, 2ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_LD_I, CHIP8_OP_DRW, CHIP8_OP_LD_BYTE }, 4, 2ULL }, \
+    { { CHIP8_OP_LD_BYTE, CHIP8_OP_LD_HF, CHIP8_OP_LD_BYTE, CHIP8_OP_DRW }, 4, 2ULL }, \
+    { { CHIP8_OP_ADD_BYTE, CHIP8_OP_LD_F, CHIP8_OP_DRW, CHIP8_OP_ADD_BYTE }, 4, 2ULL }, \
+    { { CHIP8_OP_DRW, CHIP8_OP_LD_BYTE, CHIP8_OP_LD_HF, CHIP8_OP_LD_BYTE }, 4, 2ULL }, \
+    { { CHIP8_OP_DRW, CHIP8_OP_ADD_BYTE, CHIP8_OP_LD_F, CHIP8_OP_DRW }, 4, 2ULL }, \
+    { { 0 }, 0, 0 }
+
+#endif
+
+#ifdef CHIP8_EXEC_PROFILE
+
+/* Fx07 3xkk 1nnn, a superinstruction run 121 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_1)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_VX_DT, decoded->opcodes[0]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 4;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_SE_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 4))
+    {
+        return;
+    } /* End of if statement */
+    chip8->registers.PC = pc + 6;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_JP, decoded->opcodes[2]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 1 function */
+
+/* 3xkk 1nnn, a superinstruction run 121 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_2)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    chip8->registers.PC = pc + 2;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_SE_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 2))
+    {
+        return;
+    } /* End of if statement */
+    chip8->registers.PC = pc + 4;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_JP, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 2 function */
+
+/* 6xkk ExA1 1nnn, a superinstruction run 29 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_3)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 4;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_SKNP, decoded->opcodes[1]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 4))
+    {
+        return;
+    } /* End of if statement */
+    chip8->registers.PC = pc + 6;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_JP, decoded->opcodes[2]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 3 function */
+
+/* ExA1 1nnn, a superinstruction run 29 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_4)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    chip8->registers.PC = pc + 2;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_SKNP, decoded->opcodes[0]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 2))
+    {
+        return;
+    } /* End of if statement */
+    chip8->registers.PC = pc + 4;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_JP, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 4 function */
+
+/* 6xkk 6xkk, a superinstruction run 13 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_5)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 4;
+} /* End of super 5 function */
+
+/* 6xkk Annn Dxyn, a superinstruction run 6 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_6)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_I, decoded->opcodes[1]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[2]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 6 function */
+
+/* Fn01 6xkk 6xkk, a superinstruction run 4 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_7)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_PLANES, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+} /* End of super 7 function */
+
+/* 6xkk 6xkk Annn, a superinstruction run 6 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_8)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_I, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+} /* End of super 8 function */
+
+/* 7xkk Fx29 Dxyn, a superinstruction run 3 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_9)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_ADD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_F, decoded->opcodes[1]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[2]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 9 function */
+
+/* Annn Dxyn, a superinstruction run 6 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_10)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_I, decoded->opcodes[0]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 4;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 10 function */
+
+/* Fx29 Dxyn 7xkk, a superinstruction run 3 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_11)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_F, decoded->opcodes[0]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 4;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[1]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 4))
+    {
+        return;
+    } /* End of if statement */
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_ADD_BYTE, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+} /* End of super 11 function */
+
+/* Dxyn 6xkk, a superinstruction run 5 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_12)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    chip8->registers.PC = pc + 2;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[0]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 2))
+    {
+        return;
+    } /* End of if statement */
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 4;
+} /* End of super 12 function */
+
+/* 00FF 6xkk 6xkk, a superinstruction run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_13)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_HIRES, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+} /* End of super 13 function */
+
+/* 6xkk Dxyn, a superinstruction run 4 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_14)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 4;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 14 function */
+
+/* 6xkk Fx30 6xkk, a superinstruction run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_15)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_HF, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+} /* End of super 15 function */
+
+/* Dxyn 00Cn 00FB, a superinstruction run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_16)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    chip8->registers.PC = pc + 2;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[0]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 2))
+    {
+        return;
+    } /* End of if statement */
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_SCROLL_DOWN, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_SCROLL_RIGHT, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+} /* End of super 16 function */
+
+/* 6xkk 6xkk Annn Dxyn, a trace run 6 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_17)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_I, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 8;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[3]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 17 function */
+
+/* Fn01 6xkk 6xkk Annn, a trace run 3 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_18)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_PLANES, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[2]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_I, decoded->opcodes[3]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 8;
+} /* End of super 18 function */
+
+/* 00FF 6xkk 6xkk Annn, a trace run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_19)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_HIRES, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[2]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_I, decoded->opcodes[3]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 8;
+} /* End of super 19 function */
+
+/* 6xkk Annn Dxyn 6xkk, a trace run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_20)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_I, decoded->opcodes[1]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[2]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 6))
+    {
+        return;
+    } /* End of if statement */
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[3]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 8;
+} /* End of super 20 function */
+
+/* 6xkk Fx30 6xkk Dxyn, a trace run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_21)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_HF, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 8;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[3]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 21 function */
+
+/* 7xkk Fx29 Dxyn 7xkk, a trace run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_22)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_ADD_BYTE, decoded->opcodes[0]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_F, decoded->opcodes[1]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 6;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[2]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 6))
+    {
+        return;
+    } /* End of if statement */
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_ADD_BYTE, decoded->opcodes[3]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 8;
+} /* End of super 22 function */
+
+/* Dxyn 6xkk Fx30 6xkk, a trace run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_23)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    chip8->registers.PC = pc + 2;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[0]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 2))
+    {
+        return;
+    } /* End of if statement */
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_HF, decoded->opcodes[2]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_BYTE, decoded->opcodes[3]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 8;
+} /* End of super 23 function */
+
+/* Dxyn 7xkk Fx29 Dxyn, a trace run 2 times */
+static inline void CHIP8_EXEC_NAME(chip8_super_24)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    chip8->registers.PC = pc + 2;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[0]);
+    chip8->cycles++;
+    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + 2))
+    {
+        return;
+    } /* End of if statement */
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_ADD_BYTE, decoded->opcodes[1]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_LD_F, decoded->opcodes[2]);
+    chip8->cycles++;
+    chip8->registers.PC = pc + 8;
+    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, CHIP8_OP_DRW, decoded->opcodes[3]);
+    chip8->cycles++;
+    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);
+} /* End of super 24 function */
+
+/* Runs a decoded entry through its handler, or the generic dispatch
+ * if it has none */
+static inline void CHIP8_EXEC_NAME(chip8_exec_super)(struct chip8* chip8, const struct chip8_decoded* decoded,
+        unsigned short pc)
+{
+    switch (decoded->super)
+    {
+        case 1:
+            CHIP8_EXEC_NAME(chip8_super_1)(chip8, decoded, pc);
+            break;
+        case 2:
+            CHIP8_EXEC_NAME(chip8_super_2)(chip8, decoded, pc);
+            break;
+        case 3:
+            CHIP8_EXEC_NAME(chip8_super_3)(chip8, decoded, pc);
+            break;
+        case 4:
+            CHIP8_EXEC_NAME(chip8_super_4)(chip8, decoded, pc);
+            break;
+        case 5:
+            CHIP8_EXEC_NAME(chip8_super_5)(chip8, decoded, pc);
+            break;
+        case 6:
+            CHIP8_EXEC_NAME(chip8_super_6)(chip8, decoded, pc);
+            break;
+        case 7:
+            CHIP8_EXEC_NAME(chip8_super_7)(chip8, decoded, pc);
+            break;
+        case 8:
+            CHIP8_EXEC_NAME(chip8_super_8)(chip8, decoded, pc);
+            break;
+        case 9:
+            CHIP8_EXEC_NAME(chip8_super_9)(chip8, decoded, pc);
+            break;
+        case 10:
+            CHIP8_EXEC_NAME(chip8_super_10)(chip8, decoded, pc);
+            break;
+        case 11:
+            CHIP8_EXEC_NAME(chip8_super_11)(chip8, decoded, pc);
+            break;
+        case 12:
+            CHIP8_EXEC_NAME(chip8_super_12)(chip8, decoded, pc);
+            break;
+        case 13:
+            CHIP8_EXEC_NAME(chip8_super_13)(chip8, decoded, pc);
+            break;
+        case 14:
+            CHIP8_EXEC_NAME(chip8_super_14)(chip8, decoded, pc);
+            break;
+        case 15:
+            CHIP8_EXEC_NAME(chip8_super_15)(chip8, decoded, pc);
+            break;
+        case 16:
+            CHIP8_EXEC_NAME(chip8_super_16)(chip8, decoded, pc);
+            break;
+        case 17:
+            CHIP8_EXEC_NAME(chip8_super_17)(chip8, decoded, pc);
+            break;
+        case 18:
+            CHIP8_EXEC_NAME(chip8_super_18)(chip8, decoded, pc);
+            break;
+        case 19:
+            CHIP8_EXEC_NAME(chip8_super_19)(chip8, decoded, pc);
+            break;
+        case 20:
+            CHIP8_EXEC_NAME(chip8_super_20)(chip8, decoded, pc);
+            break;
+        case 21:
+            CHIP8_EXEC_NAME(chip8_super_21)(chip8, decoded, pc);
+            break;
+        case 22:
+            CHIP8_EXEC_NAME(chip8_super_22)(chip8, decoded, pc);
+            break;
+        case 23:
+            CHIP8_EXEC_NAME(chip8_super_23)(chip8, decoded, pc);
+            break;
+        case 24:
+            CHIP8_EXEC_NAME(chip8_super_24)(chip8, decoded, pc);
+            break;
+        default:
+            CHIP8_EXEC_NAME(chip8_dispatch_decoded)(chip8, decoded, pc, decoded->length);
+            break;
+    } /* End of switch statement */
+} /* End of exec super function */
+
+#endif
@@ -0,0 +1,45 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8term.h */
+
+#ifndef CHIP8TERM_H
+#define CHIP8TERM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "chip8screen.h"
+
+/* Braille packs 2x4 pixels into a character and shows any non-zero
+ * colour as a dot; half-blocks use one character per 1x2 pixels and
+ * keep the four colours through the foreground and background. */
+enum chip8_term_mode
+{
+    CHIP8_TERM_BRAILLE,
+    CHIP8_TERM_HALF_BLOCK
+}; /* End term mode enum */
+
+#define CHIP8_TERM_MAX_CELLS (CHIP8_HIRES_WIDTH * CHIP8_HIRES_HEIGHT / 2)
+
+/* Worst case per cell: a cursor move, foreground and background colours
+ * and three bytes of UTF-8, plus the clear that starts a full redraw */
+#define CHIP8_TERM_BUFFER_SIZE (CHIP8_TERM_MAX_CELLS * 32 + 64)
+
+/* Renders a screen to ANSI escape sequences. The cells last sent are
+ * kept so a frame only costs bytes for the cells that changed, and the
+ * whole frame is built in buffer for the caller to write at once. */
+struct chip8_term
+{
+    enum chip8_term_mode mode;
+    int columns;
+    int lines;
+    bool valid;
+    int foreground;
+    int background;
+    unsigned char cells[CHIP8_TERM_MAX_CELLS];
+    char buffer[CHIP8_TERM_BUFFER_SIZE];
+}; /* End term struct */
+
+void chip8_term_init(struct chip8_term* term, enum chip8_term_mode mode);
+void chip8_term_invalidate(struct chip8_term* term);
+size_t chip8_term_render(struct chip8_term* term, const struct chip8_screen* screen, unsigned long long dirty_rows);
+
+#endif
@@ -0,0 +1,64 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8trace.h */
+
+#ifndef CHIP8TRACE_H
+#define CHIP8TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CHIP8_TRACE_MAGIC "C8TR"
+#define CHIP8_TRACE_VERSION 1
+#define CHIP8_TRACE_NO_REGISTER 0xff
+
+/* One executed instruction, 16 bytes with no padding so the ring buffer
+ * can be written to disk as-is. reg is the first V register the
+ * instruction changed (or CHIP8_TRACE_NO_REGISTER) and value its new
+ * contents. */
+struct chip8_trace_record
+{
+    uint64_t cycle;
+    uint16_t PC;
+    uint16_t opcode;
+    uint16_t I;
+    uint8_t reg;
+    uint8_t value;
+}; /* End trace record struct */
+
+/* File layout written by chip8_trace_flush, all fields little endian. */
+struct chip8_trace_header
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+}; /* End trace header struct */
+
+struct chip8_trace
+{
+    struct chip8_trace_record* records;
+    size_t mask;
+    uint64_t written;
+}; /* End trace struct */
+
+int chip8_trace_init(struct chip8_trace* trace, size_t capacity);
+void chip8_trace_free(struct chip8_trace* trace);
+void chip8_trace_reset(struct chip8_trace* trace);
+int chip8_trace_flush(const struct chip8_trace* trace, const char* filename);
+void chip8_trace_flush_on_abort(const struct chip8_trace* trace, const char* filename);
+const char* chip8_trace_start(struct chip8_trace* trace, const char* filename);
+
+/* Appends a record, overwriting the oldest one once the buffer is full. */
+static inline void chip8_trace_append(struct chip8_trace* trace, uint64_t cycle,
+        uint16_t pc, uint16_t opcode, uint16_t i, uint8_t reg, uint8_t value)
+{
+    struct chip8_trace_record* record = &trace->records[trace->written & trace->mask];
+    record->cycle = cycle;
+    record->PC = pc;
+    record->opcode = opcode;
+    record->I = i;
+    record->reg = reg;
+    record->value = value;
+    trace->written++;
+} /* End of trace append function */
+
+#endif
@@ -0,0 +1,32 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8triple.h */
+
+#ifndef CHIP8TRIPLE_H
+#define CHIP8TRIPLE_H
+
+#include <stdatomic.h>
+#include "chip8frame.h"
+
+/* Set in middle while it holds a frame the reader has not taken yet */
+#define CHIP8_TRIPLE_FRESH 4
+
+/* Lock-free triple buffer handing frames from the emulation thread to a
+ * render thread. The writer fills back and swaps it with middle; the
+ * reader swaps front with middle when middle is fresh. Each side owns
+ * its buffer outright between swaps, so neither ever waits for the
+ * other and the reader always gets the latest completed frame, with
+ * frames it was too slow for simply skipped. */
+struct chip8_triple
+{
+    struct chip8_frame frames[3];
+    int back;
+    _Alignas(64) _Atomic int middle;
+    _Alignas(64) int front;
+}; /* End triple struct */
+
+void chip8_triple_init(struct chip8_triple* triple);
+struct chip8_frame* chip8_triple_back(struct chip8_triple* triple);
+void chip8_triple_publish(struct chip8_triple* triple);
+const struct chip8_frame* chip8_triple_read(struct chip8_triple* triple);
+
+#endif
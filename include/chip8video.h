@@ -0,0 +1,59 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8video.h */
+
+#ifndef CHIP8VIDEO_H
+#define CHIP8VIDEO_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+enum chip8_video_format
+{
+    CHIP8_VIDEO_Y4M,
+    CHIP8_VIDEO_GIF,
+    CHIP8_VIDEO_PNG
+}; /* End video format enum */
+
+/* GIF dictionary : codes go up to 4095 and each has one child per colour */
+#define CHIP8_VIDEO_GIF_CODES 4096
+
+/* Writes a run of emulated frames at 60Hz as video. Each image is drawn
+ * as one byte per pixel into the buffer from chip8_video_buffer, in the
+ * colours from chip8_video_lut, and handed over with the emulated frame
+ * it first appears on. Frames in between repeat the previous image, so
+ * duplicates cost nothing to encode:
+ *     y4m - a grey Y4M stream, the image written once per frame
+ *     gif - an animated GIF, one image per change, held for as long as
+ *           it lasted; GIF delays are in 1/100s and players stretch
+ *           anything under 2/100s, so images shorter than that are
+ *           dropped in favour of the next one
+ *     png - one palette PNG per change, named PREFIX + frame number */
+struct chip8_video
+{
+    enum chip8_video_format format;
+    FILE* out;
+    const char* prefix;
+    int width;
+    int height;
+    unsigned char lut[4];
+
+    /* The image being drawn and the one waiting for its duration */
+    unsigned char* buffers[2];
+    int current;
+    bool pending;
+    unsigned long pending_frame;
+
+    unsigned long long bytes;
+    unsigned long images;
+
+    unsigned short gif_children[CHIP8_VIDEO_GIF_CODES][4];
+    unsigned char* png_data;
+}; /* End video struct */
+
+int chip8_video_open(struct chip8_video* video, enum chip8_video_format format, const char* path, int width, int height);
+unsigned char* chip8_video_buffer(struct chip8_video* video);
+int chip8_video_write(struct chip8_video* video, unsigned long frame);
+int chip8_video_close(struct chip8_video* video, unsigned long end_frame);
+int chip8_video_format_find(const char* name, enum chip8_video_format* format);
+
+#endif
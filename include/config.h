@@ -5,11 +5,15 @@
 #define CONFIG_H
 
 #define EMULATOR_WINDOW_TITLE "Chip-8 Emulator"
-#define CHIP8_MEMORY_SIZE 4096
+#define CHIP8_MEMORY_SIZE 65536
+#define CHIP8_CLASSIC_MEMORY_SIZE 4096
 #define CHIP8_PROGRAM_LOAD_ADDRESS 0x200
+#define CHIP8_PROGRAM_MAX_SIZE (CHIP8_MEMORY_SIZE - CHIP8_PROGRAM_LOAD_ADDRESS)
 
 #define CHIP8_WIDTH 64
 #define CHIP8_HEIGHT 32
+#define CHIP8_HIRES_WIDTH 128
+#define CHIP8_HIRES_HEIGHT 64
 #define CHIP8_WINDOW_MULTIPLIER 10
 
 #define CHIP8_TOTAL_DATA_REGISTERS 16
@@ -17,5 +21,16 @@
 #define CHIP8_TOTAL_KEYS 16
 #define CHIP8_CHARACTER_SET_LOAD_ADDRESS 0x00
 #define CHIP8_DEFAULT_SPRITE_HEIGHT 5
+#define CHIP8_BIG_CHARACTER_SET_LOAD_ADDRESS 0x50
+#define CHIP8_BIG_SPRITE_HEIGHT 10
+
+#define CHIP8_AUDIO_PATTERN_SIZE 16
+#define CHIP8_AUDIO_DEFAULT_PITCH 64
+
+#define CHIP8_CYCLES_PER_FRAME 10
+#define CHIP8_TIMER_HZ 60
+#define CHIP8_DEFAULT_RANDOM_SEED 0x2545f491
+
+#define CHIP8_TRACE_DEFAULT_CAPACITY (1 << 20)
 
 #endif
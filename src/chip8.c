@@ -1,14 +1,16 @@
 /* Program name : Chip-8 emulator 
  * File name : chip8.c */
 
+#include <limits.h>
 #include <memory.h>
-#include <assert.h>
 #include <stdbool.h>
-#include <stdlib.h>
-#include <time.h>
+#include <string.h>
 
 #include "chip8.h"
-#include "SDL2/SDL.h"
+#include "chip8predecode.h"
+#ifdef CHIP8_PROFILING
+#include "chip8profiler.h"
+#endif
 
 const char chip8_default_character_set[] = {
     0xf0, 0x90, 0x90, 0x90, 0xf0,
@@ -29,302 +31,280 @@ const char chip8_default_character_set[] = {
     0xf0, 0x80, 0xf0, 0x80, 0x80
 }; /* End character set array */
 
+/* SUPER-CHIP 8x10 digits for Fx30 */
+const char chip8_big_character_set[] = {
+    0xff, 0xff, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xff, 0xff,
+    0x18, 0x78, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0xff, 0xff,
+    0xff, 0xff, 0x03, 0x03, 0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff,
+    0xff, 0xff, 0x03, 0x03, 0xff, 0xff, 0x03, 0x03, 0xff, 0xff,
+    0xc3, 0xc3, 0xc3, 0xc3, 0xff, 0xff, 0x03, 0x03, 0x03, 0x03,
+    0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff, 0x03, 0x03, 0xff, 0xff,
+    0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff, 0xc3, 0xc3, 0xff, 0xff,
+    0xff, 0xff, 0x03, 0x03, 0x06, 0x0c, 0x18, 0x18, 0x18, 0x18,
+    0xff, 0xff, 0xc3, 0xc3, 0xff, 0xff, 0xc3, 0xc3, 0xff, 0xff,
+    0xff, 0xff, 0xc3, 0xc3, 0xff, 0xff, 0x03, 0x03, 0xff, 0xff,
+    0x7e, 0xff, 0xc3, 0xc3, 0xc3, 0xff, 0xff, 0xc3, 0xc3, 0xc3,
+    0xfc, 0xfc, 0xc3, 0xc3, 0xfc, 0xfc, 0xc3, 0xc3, 0xfc, 0xfc,
+    0x3c, 0xff, 0xc3, 0xc0, 0xc0, 0xc0, 0xc0, 0xc3, 0xff, 0x3c,
+    0xfc, 0xfe, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xfe, 0xfc,
+    0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff,
+    0xff, 0xff, 0xc0, 0xc0, 0xff, 0xff, 0xc0, 0xc0, 0xc0, 0xc0
+}; /* End big character set array */
+
 void chip8_init(struct chip8* chip8)
 {
     memset(chip8, 0, sizeof(struct chip8));
-    memcpy(&chip8->memory.memory, chip8_default_character_set, sizeof(chip8_default_character_set));
+    memcpy(&chip8->memory.memory[CHIP8_CHARACTER_SET_LOAD_ADDRESS], chip8_default_character_set, sizeof(chip8_default_character_set));
+    memcpy(&chip8->memory.memory[CHIP8_BIG_CHARACTER_SET_LOAD_ADDRESS], chip8_big_character_set, sizeof(chip8_big_character_set));
+    chip8_screen_init(&chip8->screen);
+    chip8->audio.pitch = CHIP8_AUDIO_DEFAULT_PITCH;
+    chip8->profile = &chip8_profiles[0];
+    chip8->random_state = CHIP8_DEFAULT_RANDOM_SEED;
 } /* End init function */
 
-void chip8_load(struct chip8* chip8, const char* buf, size_t size)
+void chip8_seed(struct chip8* chip8, unsigned int seed)
+{
+    chip8->random_state = seed ? seed : CHIP8_DEFAULT_RANDOM_SEED;
+} /* End of seed function */
+
+enum chip8_load_result chip8_load(struct chip8* chip8, const char* buf, size_t size)
 {
-    assert(size+CHIP8_PROGRAM_LOAD_ADDRESS < CHIP8_MEMORY_SIZE);
+    if (size > CHIP8_PROGRAM_MAX_SIZE)
+    {
+        return CHIP8_LOAD_TOO_LARGE;
+    } /* End of if statement */
+
     memcpy(&chip8->memory.memory[CHIP8_PROGRAM_LOAD_ADDRESS], buf, size);
-    chip8->registers.PC = CHIP8_PROGRAM_LOAD_ADDRESS;
+    chip8_loaded(chip8, size);
+    return CHIP8_LOAD_OK;
 } /* End of load function */
 
-static char chip8_wait_key_press(struct chip8* chip8)
+/* Finishes a load once size program bytes are in place */
+void chip8_loaded(struct chip8* chip8, size_t size)
 {
-    SDL_Event event;
-    while (SDL_WaitEvent(&event))
+    if (size > 0)
     {
-        if (event.type != SDL_KEYDOWN)
-        {
-            continue;
-        } /* End of nested if statement */
+        chip8_memory_mark(&chip8->memory, CHIP8_PROGRAM_LOAD_ADDRESS, size);
+    } /* End of if statement */
+    chip8->registers.PC = CHIP8_PROGRAM_LOAD_ADDRESS;
+} /* End of loaded function */
+
+const char* chip8_load_result_name(enum chip8_load_result result)
+{
+    switch (result)
+    {
+        case CHIP8_LOAD_OK:
+            return "ok";
+        case CHIP8_LOAD_OPEN_FAILED:
+            return "failed to open file";
+        case CHIP8_LOAD_READ_FAILED:
+            return "failed to read from file";
+        case CHIP8_LOAD_TOO_LARGE:
+            return "program too large for memory";
+    } /* End of switch statement */
 
-        char c = event.key.keysym.sym;
-        char chip8_key = chip8_keyboard_map(&chip8->keyboard, c);
-        if (chip8_key != -1)
+    return "unknown";
+} /* End of load result name function */
+
+/* Returns the lowest key that is held down, or -1 if none are */
+static char chip8_pressed_key(struct chip8* chip8)
+{
+    for (int i = 0; i < CHIP8_TOTAL_KEYS; i++)
+    {
+        if (chip8_keyboard_is_down(&chip8->keyboard, i))
         {
-            return chip8_key;
-        } /* End of nested if statement */
-    } /* End of while loop */
+            return i;
+        } /* End of if statement */
+    } /* End of for loop */
 
     return -1;
-} /* End of wait for key press function */
+} /* End of pressed key function */
 
-static void chip8_exec_extended(struct chip8* chip8, unsigned short opcode)
+/* xorshift32, kept per instance so headless runs are reproducible */
+static unsigned char chip8_random_byte(struct chip8* chip8)
 {
-    unsigned short nnn = opcode & 0x0fff;
-    unsigned char x = (opcode >> 8) & 0x000f;
-    unsigned char y = (opcode >> 4) & 0x000f;
-    unsigned char kk = opcode & 0x00ff;
-    unsigned short tmp = 0;
-    unsigned char n = opcode & 0x000f;
-
-    switch (opcode & 0xf000)
+    unsigned int r = chip8->random_state;
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+    chip8->random_state = r;
+    return r >> 24;
+} /* End of random byte function */
+
+/* Skips the next instruction, stepping over both words of F000 nnnn
+ * when the profile has XO-CHIP's long load */
+static void chip8_skip(struct chip8* chip8, bool xochip)
+{
+    unsigned short pc = chip8->registers.PC;
+    bool long_load = xochip && pc < CHIP8_MEMORY_SIZE - 1
+        && chip8->memory.memory[pc] == 0xf0 && chip8->memory.memory[pc+1] == 0x00;
+    chip8->registers.PC += long_load ? 4 : 2;
+} /* End of skip function */
+
+/* 5xy2 / 5xy3 : Vx through Vy in memory from I, in descending register
+ * order when x > y. I is left unchanged. */
+static void chip8_save_range(struct chip8* chip8, unsigned char x, unsigned char y)
+{
+    if (x <= y)
     {
-        /* 1nnn : Jump to location nnn */
-        case 0x1000:
-            chip8->registers.PC = nnn;
-            break;
-
-        /* 2nnn : Call subroutine at location nnn */
-        case 0x2000:
-            chip8_stack_push(chip8, chip8->registers.PC);
-            chip8->registers.PC = nnn;
-            break;
-
-        /* 3xkk : Skip next instruction if Vx = kk */
-        case 0x3000:
-            if (chip8->registers.V[x] == kk)
-            {
-                chip8->registers.PC += 2;
-            } /* End of if statement */
-            break;
-        /* 4xkk : Skip next instruction if Vx != kk */
-        case 0x4000:
-            if (chip8->registers.V[x] != kk)
-            {
-                chip8->registers.PC += 2;
-            } /* End of if statement */
-            break;
-        /* 5xy0 : Skip the next instruction if Vx = Vy */
-        case 0x5000:
-            if (chip8->registers.V[x] == chip8->registers.V[y])
-            {
-                chip8->registers.PC += 2;
-            } /* End if statement */
-            break;
-
-        /* 6xkk : Set Vx = kk */
-        case 0x6000:
-            chip8->registers.V[x] = kk;
-            break;
-
-        /* 7xkk : Set Vx = Vx + kk */
-        case 0x7000:
-            chip8->registers.V[x] += kk;
-            break;
-
-        /* Opcodes for 0x8000 instruction set */
-        case 0x8000:
-            {
-                switch (opcode & 0x000f)
-                {
-                    /* 8xy0 : Set Vx = Vy */
-                    case 0x00:
-                        chip8->registers.V[x] = chip8->registers.V[y];
-                        break;
-
-                    /* 8xy1 : Set Vx = Vx OR Vy */
-                    case 0x01:
-                        chip8->registers.V[x] = chip8->registers.V[x] |= chip8->registers.V[y];
-                        break;
-
-                    /* 8xy2 : Set Vx = Vx AND Vy */
-                    case 0x02:
-                        chip8->registers.V[x] = chip8->registers.V[x] &= chip8->registers.V[y];
-                        break;
-
-                    /* 8xy3 : Set Vx = Vx XOR Vy */
-                    case 0x03:
-                        chip8->registers.V[x] = chip8->registers.V[x] ^= chip8->registers.V[y];
-                        break;
-
-                    /* 8xy4 : Set Vx = Vx + Vy, set VF = carry */
-                    case 0x04:
-                        tmp = chip8->registers.V[x] + chip8->registers.V[y];
-                        chip8->registers.V[0x0f] = tmp > 0xff;
-                        chip8->registers.V[x] = tmp;
-                        break;
-
-                    /* 8xy5 : Set Vx = Vx - Vy, Set VF = Not borrow */
-                    case 0x05:
-                        chip8->registers.V[0x0f] = chip8->registers.V[x] > chip8->registers.V[y];
-                        chip8->registers.V[x] = chip8->registers.V[x] - chip8->registers.V[y];
-                        break;
-                    
-                    /* 8xy6 : Set Vx = Vx SHR 1 least-significant bit*/
-                    case 0x06:
-                        chip8->registers.V[0x0f] = chip8->registers.V[x] & 0x01;
-                        chip8->registers.V[x] /= 2;
-                        break;
-
-                    /* 8xy7 : Set Vx = Vy - Vx, Set VF = Not borrow */ 
-                    case 0x07:
-                        chip8->registers.V[0x0f] = chip8->registers.V[y] > chip8->registers.V[x];
-                        chip8->registers.V[x] = chip8->registers.V[y] - chip8->registers.V[x];
-                        break;
-
-                    /* 8xye : Set Vx = Vx SHL 1 most-significant bit */
-                    case 0x0e:
-                        chip8->registers.V[0x0f] = chip8->registers.V[x] & 0x80;
-                        chip8->registers.V[x] *= 2;
-                        break;
-                } /* End of nested switch */
-            } /* End of scope */
-            break;
-
-        /* 9xy0 : Skip the next instruction if Vx != Vy */    
-        case 0x9000:
-            if (chip8->registers.V[x] != chip8->registers.V[y])
-            {
-                chip8->registers.PC += 2;
-            } /* End of nested if statement */
-            break;
-
-        /* Annn : Set I = nnn */
-        case 0xA000:
-            chip8->registers.I = nnn;
-            break;
-
-        /* Bnnn : Jump to location nnn + V0 */
-        case 0xB000:
-            chip8->registers.PC = nnn + chip8->registers.V[0x00];
-            break;
-
-        /* Cxkk : Set Vx = random byte AND kk */
-        case 0xC000:
-            srand(clock());
-            chip8->registers.V[x] = (rand() % 255) & kk;
-            break;
-
-        /* 0xD000 : Draw to the screen */
-        case 0xD000:
-            {
-                const char* sprite = (const char*) &chip8->memory.memory[chip8->registers.I];
-                chip8->registers.V[0x0f] = chip8_screen_draw_sprite(
-                        &chip8->screen,
-                        chip8->registers.V[x],
-                        chip8->registers.V[y],
-                        sprite,
-                        n
-                );
-            } /* End of scope */
-            break;
-
-        /* Opcodes for 0xE000 instruction set */
-        case 0xE000:
-            {
-                switch (opcode & 0x00ff)
-                {
-                    /* Ex9E : Skip the next instruction if the key with the value of Vx is pressed */
-                    case 0x9e:
-                        if (chip8_keyboard_is_down(&chip8->keyboard, chip8->registers.V[x]))
-                        {
-                            chip8->registers.PC += 2;
-                        }
-                        break;
-
-                    /* ExA1 : Skip the next instruction if the key with the value of Vx is not pressed */
-                    case 0xa1:
-                        if (!chip8_keyboard_is_down(&chip8->keyboard, chip8->registers.V[x]))
-                        {
-                            chip8->registers.PC += 2;
-                        }
-                        break;
-                } /* End of switch statement */
-            } /* End of scope */
-            break;
-
-        /* Opcodes for 0xF000 instruction set */
-        case 0xF000:
-            {
-                switch (opcode & 0x00ff)
-                {
-                    /* Fx07 : Set Vx = delay timer value */
-                    case 0x07:
-                        chip8->registers.V[x] = chip8->registers.delay_timer;
-                        break;
-
-                    /* Fx0A : Wait for a key press, store the value of the key in Vx */
-                    case 0x0A:
-                        {
-                            char pressed_key = chip8_wait_key_press(chip8);
-                            chip8->registers.V[x] = pressed_key;
-                        }
-                        break;
-
-                    /* Fx15 : Set delay timer = Vx */
-                    case 0x15:
-                        chip8->registers.delay_timer = chip8->registers.V[x];
-                        break;
-
-                    /* Fx18 : Set the sound timer = Vx */
-                    case 0x18:
-                        chip8->registers.sound_timer = chip8->registers.V[x];
-                        break;
-
-                    /* Fx1E : Set I = I + Vx */
-                    case 0x1e:
-                        chip8->registers.I += chip8->registers.V[x];
-                        break;
-
-                    /* Fx29 : Set I = location of sprite for digit Vx */
-                    case 0x29:
-                        chip8->registers.I = chip8->registers.V[x] * CHIP8_DEFAULT_SPRITE_HEIGHT;
-                        break;
-
-                    /* Fx33 : Store BCD representation of Vx in memory locations I, I+1, and I+2 */
-                    case 0x33:
-                        {
-                            unsigned char hundreds = chip8->registers.V[x] / 100;
-                            unsigned char tens = chip8->registers.V[x] / 10 % 10;
-                            unsigned char units = chip8->registers.V[x] % 10;
-
-                            chip8_memory_set(&chip8->memory, chip8->registers.I, hundreds);
-                            chip8_memory_set(&chip8->memory, chip8->registers.I+1, tens);
-                            chip8_memory_set(&chip8->memory, chip8->registers.I+2, units);
-                        }
-                        break;
-
-                    /* Fx55 : Store the registers V0 through Vx in memory starting at location I */
-                    case 0x55:
-                        for (int i = 0; i <= x; i++) 
-                        {
-                            chip8_memory_set(&chip8->memory, chip8->registers.I+i, chip8->registers.V[i]);        
-                        } /* End of for loop */
-                        break;
-
-                    /* Fx65 : Read registers V0 through Vx from memory starting at location I */
-                    case 0x65:
-                        for (int i = 0; i <= x; i++) 
-                        {
-                            chip8->registers.V[i] = chip8_memory_get(&chip8->memory, chip8->registers.I+i);
-                        } /* End of for loop */
-                        break;
-                } /* End of switch statement */
-            } /* End of scope */
-            break;
-    } /* End of switch statement */
-} /* End of exec extended function */
+        chip8_memory_write_block(&chip8->memory, CHIP8_MEMORY_SIZE, chip8->registers.I,
+                &chip8->registers.V[x], y - x + 1);
+        return;
+    } /* End of if statement */
+
+    unsigned char values[CHIP8_TOTAL_DATA_REGISTERS];
+    for (int i = 0; i <= x - y; i++)
+    {
+        values[i] = chip8->registers.V[x - i];
+    } /* End of for loop */
+    chip8_memory_write_block(&chip8->memory, CHIP8_MEMORY_SIZE, chip8->registers.I,
+                values, x - y + 1);
+} /* End of save range function */
+
+static void chip8_load_range(struct chip8* chip8, unsigned char x, unsigned char y)
+{
+    if (x <= y)
+    {
+        chip8_memory_read_block(&chip8->memory, CHIP8_MEMORY_SIZE, chip8->registers.I,
+                &chip8->registers.V[x], y - x + 1);
+        return;
+    } /* End of if statement */
+
+    unsigned char values[CHIP8_TOTAL_DATA_REGISTERS];
+    chip8_memory_read_block(&chip8->memory, CHIP8_MEMORY_SIZE, chip8->registers.I,
+                values, x - y + 1);
+    for (int i = 0; i <= x - y; i++)
+    {
+        chip8->registers.V[x - i] = values[i];
+    } /* End of for loop */
+} /* End of load range function */
+
+/* One interpreter per quirk profile, see chip8exec.h */
+#define CHIP8_EXEC_PROFILE default
+#define CHIP8_EXEC_QUIRKS CHIP8_PROFILE_DEFAULT_QUIRKS
+#include "chip8exec.h"
+
+#define CHIP8_EXEC_PROFILE vip
+#define CHIP8_EXEC_QUIRKS CHIP8_PROFILE_VIP_QUIRKS
+#include "chip8exec.h"
+
+#define CHIP8_EXEC_PROFILE schip
+#define CHIP8_EXEC_QUIRKS CHIP8_PROFILE_SCHIP_QUIRKS
+#include "chip8exec.h"
+
+#define CHIP8_EXEC_PROFILE xochip
+#define CHIP8_EXEC_QUIRKS CHIP8_PROFILE_XOCHIP_QUIRKS
+#include "chip8exec.h"
+
+const struct chip8_profile chip8_profiles[] = {
+    { "default", CHIP8_PROFILE_DEFAULT_QUIRKS, chip8_exec_default, chip8_step_default, chip8_run_default,
+        chip8_step_predecoded_default, chip8_run_predecoded_default },
+    { "vip", CHIP8_PROFILE_VIP_QUIRKS, chip8_exec_vip, chip8_step_vip, chip8_run_vip,
+        chip8_step_predecoded_vip, chip8_run_predecoded_vip },
+    { "schip", CHIP8_PROFILE_SCHIP_QUIRKS, chip8_exec_schip, chip8_step_schip, chip8_run_schip,
+        chip8_step_predecoded_schip, chip8_run_predecoded_schip },
+    { "xochip", CHIP8_PROFILE_XOCHIP_QUIRKS, chip8_exec_xochip, chip8_step_xochip, chip8_run_xochip,
+        chip8_step_predecoded_xochip, chip8_run_predecoded_xochip },
+};
+
+const int chip8_total_profiles = sizeof(chip8_profiles) / sizeof(chip8_profiles[0]);
+
+const struct chip8_profile* chip8_profile_find(const char* name)
+{
+    for (int i = 0; i < chip8_total_profiles; i++)
+    {
+        if (strcmp(chip8_profiles[i].name, name) == 0)
+        {
+            return &chip8_profiles[i];
+        } /* End of if statement */
+    } /* End of for loop */
+
+    return NULL;
+} /* End of profile find function */
+
+/* Selects the interpreter used from now on; normally done once, when a
+ * ROM is loaded */
+void chip8_set_profile(struct chip8* chip8, const struct chip8_profile* profile)
+{
+    chip8->profile = profile;
+} /* End of set profile function */
 
 void chip8_exec(struct chip8* chip8, unsigned short opcode)
 {
-    switch (opcode)
+    chip8->profile->exec(chip8, opcode);
+} /* End of exec function */
+
+void chip8_step(struct chip8* chip8)
+{
+    chip8->profile->step(chip8);
+} /* End of step function */
+
+/* Runs one 60Hz frame headless. The frame's timer tick needs no work of
+ * its own : it is implied by the cycle count reaching the end of the
+ * frame. The frame is cut short if the core faults. */
+void chip8_run_frame(struct chip8* chip8)
+{
+    chip8->profile->run(chip8, CHIP8_CYCLES_PER_FRAME);
+} /* End of run frame function */
+
+/* Moves emulated time on by frames without running anything, the
+ * instructions that would have run counted as run. Exact while the core
+ * is idle on a key or halted, as every one of them would have gone back
+ * to the same instruction; the timers run down just as they would. A
+ * core polling the delay timer runs the frames instead, so it lands on
+ * the pass of the loop it would have reached and carries on once the
+ * timer runs out : each frame of the poll costs one pass. */
+void chip8_skip_frames(struct chip8* chip8, unsigned long long frames)
+{
+    if (chip8->idle == CHIP8_IDLE_TIMER)
+    {
+        for (unsigned long long i = 0; i < frames && chip8->fault == CHIP8_FAULT_NONE; i++)
+        {
+            chip8_run_frame(chip8);
+        } /* End of for loop */
+        return;
+    } /* End of if statement */
+    chip8->cycles += frames * CHIP8_CYCLES_PER_FRAME;
+} /* End of skip frames function */
+
+/* True when running more frames would change nothing but the time
+ * until a key goes down : the last frame idled on Fx0A with no key held
+ * now, or halted, or polls a delay timer that runs through the next
+ * frame. Frontends set the keyboard before asking, sleep for at most
+ * chip8_sleep_frames and catch up on the frames they slept through with
+ * chip8_skip_frames. */
+bool chip8_can_sleep(struct chip8* chip8)
+{
+    return chip8->idle == CHIP8_IDLE_HALT
+        || (chip8->idle == CHIP8_IDLE_KEY && chip8_pressed_key(chip8) == -1)
+        || (chip8->idle == CHIP8_IDLE_TIMER && chip8_sleep_frames(chip8) > 0);
+} /* End of can sleep function */
+
+/* How many whole frames a core that can sleep stays idle : until the
+ * delay timer runs out for a timer poll, ULLONG_MAX for a key wait or a
+ * halt, which only a key (or nothing) ends */
+unsigned long long chip8_sleep_frames(const struct chip8* chip8)
+{
+    if (chip8->idle != CHIP8_IDLE_TIMER)
     {
-        /* CLS : Clears the screen */
-        case 0x00E0:
-            chip8_screen_clear(&chip8->screen);
-            break;
-
-        /* Ret : Return from subroutine */
-        case 0x00EE:
-            chip8->registers.PC = chip8_stack_pop(chip8);
-            break;
-
-        default:
-            chip8_exec_extended(chip8, opcode);
+        return ULLONG_MAX;
+    } /* End of if statement */
+    return chip8->wake_cycle > chip8->cycles ? (chip8->wake_cycle - chip8->cycles) / CHIP8_CYCLES_PER_FRAME : 0;
+} /* End of sleep frames function */
+
+const char* chip8_fault_name(enum chip8_fault fault)
+{
+    switch (fault)
+    {
+        case CHIP8_FAULT_NONE:
+            return "none";
+        case CHIP8_FAULT_MEMORY:
+            return "memory access out of range";
+        case CHIP8_FAULT_STACK_OVERFLOW:
+            return "stack overflow";
+        case CHIP8_FAULT_STACK_UNDERFLOW:
+            return "stack underflow";
     } /* End of switch statement */
-} /* End of exec function */
+
+    return "unknown";
+} /* End of fault name function */
@@ -0,0 +1,118 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8atlas.c */
+
+#include <stdlib.h>
+
+#include "chip8atlas.h"
+#include "chip8scale.h"
+
+#define CHIP8_ATLAS_STEP_X (CHIP8_ATLAS_TILE_WIDTH + CHIP8_ATLAS_GUTTER)
+#define CHIP8_ATLAS_STEP_Y (CHIP8_ATLAS_TILE_HEIGHT + CHIP8_ATLAS_GUTTER)
+
+/* Lays count tiles out in the fewest columns that make the atlas at
+ * least as wide as the target aspect ratio, fills it with the border
+ * colour and marks it all dirty for the first upload. Returns -1 if
+ * the image cannot be allocated. */
+int chip8_atlas_init(struct chip8_atlas* atlas, int count, const uint32_t palette[4])
+{
+    int columns = 1;
+    int rows = count;
+    while (columns * CHIP8_ATLAS_STEP_X * CHIP8_ATLAS_ASPECT_HEIGHT < rows * CHIP8_ATLAS_STEP_Y * CHIP8_ATLAS_ASPECT_WIDTH)
+    {
+        columns++;
+        rows = (count + columns - 1) / columns;
+    } /* End of while loop */
+
+    atlas->count = count;
+    atlas->columns = columns;
+    atlas->rows = rows;
+    atlas->width = columns * CHIP8_ATLAS_STEP_X - CHIP8_ATLAS_GUTTER;
+    atlas->height = rows * CHIP8_ATLAS_STEP_Y - CHIP8_ATLAS_GUTTER;
+    atlas->pitch = atlas->width * sizeof(uint32_t);
+    atlas->pixels = malloc(atlas->pitch * atlas->height);
+    if (!atlas->pixels)
+    {
+        return -1;
+    } /* End of if statement */
+
+    for (int i = 0; i < 4; i++)
+    {
+        atlas->palette[i] = palette[i];
+    } /* End of for loop */
+    for (size_t i = 0; i < (size_t) atlas->width * atlas->height; i++)
+    {
+        atlas->pixels[i] = CHIP8_ATLAS_BORDER;
+    } /* End of for loop */
+    atlas->dirty_top = 0;
+    atlas->dirty_bottom = rows - 1;
+    return 0;
+} /* End of atlas init function */
+
+void chip8_atlas_free(struct chip8_atlas* atlas)
+{
+    free(atlas->pixels);
+    atlas->pixels = NULL;
+} /* End of atlas free function */
+
+/* Redraws tile index from frame and widens the dirty band to cover it */
+void chip8_atlas_draw(struct chip8_atlas* atlas, int index, const struct chip8_frame* frame)
+{
+    int column = index % atlas->columns;
+    int row = index / atlas->columns;
+    uint32_t* tile = atlas->pixels + (size_t) row * CHIP8_ATLAS_STEP_Y * atlas->width + column * CHIP8_ATLAS_STEP_X;
+
+    struct chip8_frame halved;
+    if (frame->width > CHIP8_ATLAS_TILE_WIDTH)
+    {
+        chip8_scale_halve(frame, &halved);
+        frame = &halved;
+    } /* End of if statement */
+    chip8_scale_rgba(frame, atlas->palette, 1, tile, atlas->pitch);
+
+    if (atlas->dirty_top > atlas->dirty_bottom)
+    {
+        atlas->dirty_top = atlas->dirty_bottom = row;
+    }
+    else if (row < atlas->dirty_top)
+    {
+        atlas->dirty_top = row;
+    }
+    else if (row > atlas->dirty_bottom)
+    {
+        atlas->dirty_bottom = row;
+    } /* End of if else statement */
+} /* End of atlas draw function */
+
+/* Hands out the band of texel rows redrawn since the last call, false
+ * if nothing was */
+bool chip8_atlas_take_dirty(struct chip8_atlas* atlas, int* y, int* height)
+{
+    if (atlas->dirty_top > atlas->dirty_bottom)
+    {
+        return false;
+    } /* End of if statement */
+
+    *y = atlas->dirty_top * CHIP8_ATLAS_STEP_Y;
+    *height = (atlas->dirty_bottom - atlas->dirty_top + 1) * CHIP8_ATLAS_STEP_Y;
+    if (*y + *height > atlas->height)
+    {
+        *height = atlas->height - *y;
+    } /* End of if statement */
+    atlas->dirty_top = atlas->rows;
+    atlas->dirty_bottom = -1;
+    return true;
+} /* End of atlas take dirty function */
+
+/* Instance whose tile holds texel (x, y), or -1 for a gutter or past
+ * the last tile */
+int chip8_atlas_find(const struct chip8_atlas* atlas, int x, int y)
+{
+    if (x < 0 || y < 0 || x % CHIP8_ATLAS_STEP_X >= CHIP8_ATLAS_TILE_WIDTH || y % CHIP8_ATLAS_STEP_Y >= CHIP8_ATLAS_TILE_HEIGHT)
+    {
+        return -1;
+    } /* End of if statement */
+
+    int column = x / CHIP8_ATLAS_STEP_X;
+    int index = y / CHIP8_ATLAS_STEP_Y * atlas->columns + column;
+    return column < atlas->columns && index < atlas->count ? index : -1;
+} /* End of atlas find function */
@@ -0,0 +1,28 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8backend.c */
+
+#include <string.h>
+#include "chip8backend.h"
+#include "chip8.h"
+#include "chip8predecode.h"
+
+const struct chip8_backend chip8_backends[] = {
+    { "switch", chip8_step, NULL },
+    { "predecode", chip8_predecode_backend_step, NULL },
+    { "fused", chip8_predecode_backend_step, chip8_predecode_backend_run },
+};
+
+const int chip8_total_backends = sizeof(chip8_backends) / sizeof(chip8_backends[0]);
+
+const struct chip8_backend* chip8_backend_find(const char* name)
+{
+    for (int i = 0; i < chip8_total_backends; i++)
+    {
+        if (strcmp(chip8_backends[i].name, name) == 0)
+        {
+            return &chip8_backends[i];
+        } /* End of if statement */
+    } /* End of for loop */
+
+    return NULL;
+} /* End of backend find function */
@@ -0,0 +1,124 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8disasm.c */
+
+#include <stdio.h>
+#include "chip8disasm.h"
+
+/* Writes the Cowgod mnemonic for opcode into out, falling back to a raw
+ * data word for anything the interpreter does not execute. */
+void chip8_disassemble(unsigned short opcode, char* out, size_t size)
+{
+    unsigned short nnn = opcode & 0x0fff;
+    unsigned char x = (opcode >> 8) & 0x000f;
+    unsigned char y = (opcode >> 4) & 0x000f;
+    unsigned char kk = opcode & 0x00ff;
+    unsigned char n = opcode & 0x000f;
+
+    switch (opcode & 0xf000)
+    {
+        case 0x0000:
+            if (opcode == 0x00E0)
+            {
+                snprintf(out, size, "CLS");
+                return;
+            } /* End of if statement */
+            if (opcode == 0x00EE)
+            {
+                snprintf(out, size, "RET");
+                return;
+            } /* End of if statement */
+            switch (opcode)
+            {
+                case 0x00FB: snprintf(out, size, "SCR"); return;
+                case 0x00FC: snprintf(out, size, "SCL"); return;
+                case 0x00FE: snprintf(out, size, "LOW"); return;
+                case 0x00FF: snprintf(out, size, "HIGH"); return;
+            } /* End of nested switch */
+            if ((opcode & 0xfff0) == 0x00C0)
+            {
+                snprintf(out, size, "SCD  %d", n);
+                return;
+            } /* End of if statement */
+            if ((opcode & 0xfff0) == 0x00D0)
+            {
+                snprintf(out, size, "SCU  %d", n);
+                return;
+            } /* End of if statement */
+            snprintf(out, size, "SYS  0x%03X", nnn);
+            return;
+
+        case 0x1000: snprintf(out, size, "JP   0x%03X", nnn); return;
+        case 0x2000: snprintf(out, size, "CALL 0x%03X", nnn); return;
+        case 0x3000: snprintf(out, size, "SE   V%X, 0x%02X", x, kk); return;
+        case 0x4000: snprintf(out, size, "SNE  V%X, 0x%02X", x, kk); return;
+        case 0x5000:
+            switch (n)
+            {
+                case 0x00: snprintf(out, size, "SE   V%X, V%X", x, y); return;
+                case 0x02: snprintf(out, size, "SAVE V%X - V%X", x, y); return;
+                case 0x03: snprintf(out, size, "LOAD V%X - V%X", x, y); return;
+            } /* End of nested switch */
+            break;
+        case 0x6000: snprintf(out, size, "LD   V%X, 0x%02X", x, kk); return;
+        case 0x7000: snprintf(out, size, "ADD  V%X, 0x%02X", x, kk); return;
+
+        case 0x8000:
+            switch (n)
+            {
+                case 0x00: snprintf(out, size, "LD   V%X, V%X", x, y); return;
+                case 0x01: snprintf(out, size, "OR   V%X, V%X", x, y); return;
+                case 0x02: snprintf(out, size, "AND  V%X, V%X", x, y); return;
+                case 0x03: snprintf(out, size, "XOR  V%X, V%X", x, y); return;
+                case 0x04: snprintf(out, size, "ADD  V%X, V%X", x, y); return;
+                case 0x05: snprintf(out, size, "SUB  V%X, V%X", x, y); return;
+                case 0x06: snprintf(out, size, "SHR  V%X", x); return;
+                case 0x07: snprintf(out, size, "SUBN V%X, V%X", x, y); return;
+                case 0x0e: snprintf(out, size, "SHL  V%X", x); return;
+            } /* End of nested switch */
+            break;
+
+        case 0x9000: snprintf(out, size, "SNE  V%X, V%X", x, y); return;
+        case 0xA000: snprintf(out, size, "LD   I, 0x%03X", nnn); return;
+        case 0xB000: snprintf(out, size, "JP   V0, 0x%03X", nnn); return;
+        case 0xC000: snprintf(out, size, "RND  V%X, 0x%02X", x, kk); return;
+        case 0xD000: snprintf(out, size, "DRW  V%X, V%X, %d", x, y, n); return;
+
+        case 0xE000:
+            switch (kk)
+            {
+                case 0x9e: snprintf(out, size, "SKP  V%X", x); return;
+                case 0xa1: snprintf(out, size, "SKNP V%X", x); return;
+            } /* End of nested switch */
+            break;
+
+        case 0xF000:
+            if (opcode == 0xF000)
+            {
+                snprintf(out, size, "LD   I, LONG");
+                return;
+            } /* End of if statement */
+            if (opcode == 0xF002)
+            {
+                snprintf(out, size, "AUDIO");
+                return;
+            } /* End of if statement */
+            switch (kk)
+            {
+                case 0x01: snprintf(out, size, "PLANE %d", x); return;
+                case 0x07: snprintf(out, size, "LD   V%X, DT", x); return;
+                case 0x0a: snprintf(out, size, "LD   V%X, K", x); return;
+                case 0x15: snprintf(out, size, "LD   DT, V%X", x); return;
+                case 0x18: snprintf(out, size, "LD   ST, V%X", x); return;
+                case 0x1e: snprintf(out, size, "ADD  I, V%X", x); return;
+                case 0x29: snprintf(out, size, "LD   F, V%X", x); return;
+                case 0x30: snprintf(out, size, "LD   HF, V%X", x); return;
+                case 0x33: snprintf(out, size, "LD   B, V%X", x); return;
+                case 0x3a: snprintf(out, size, "PITCH V%X", x); return;
+                case 0x55: snprintf(out, size, "LD   [I], V%X", x); return;
+                case 0x65: snprintf(out, size, "LD   V%X, [I]", x); return;
+            } /* End of nested switch */
+            break;
+    } /* End of switch statement */
+
+    snprintf(out, size, "DW   0x%04X", opcode);
+} /* End of disassemble function */
@@ -0,0 +1,83 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8fleet.c */
+
+#include <stdlib.h>
+
+#include "chip8fleet.h"
+
+/* Copies the loaded program into count instances, reseeding each so
+ * that games using random numbers play out differently. Returns -1 if
+ * the instances cannot be allocated. */
+int chip8_fleet_init(struct chip8_fleet* fleet, const struct chip8* program, int count)
+{
+    fleet->instances = malloc(sizeof(struct chip8_fleet_instance) * count);
+    if (!fleet->instances)
+    {
+        return -1;
+    } /* End of if statement */
+
+    fleet->count = count;
+    fleet->powersave = true;
+    atomic_init(&fleet->keys, 0);
+    atomic_init(&fleet->focus, CHIP8_FLEET_ALL);
+    for (int i = 0; i < count; i++)
+    {
+        struct chip8_fleet_instance* instance = &fleet->instances[i];
+        instance->chip8 = *program;
+        instance->chip8.trace = NULL;
+        chip8_seed(&instance->chip8, program->random_state + i * 2654435761u);
+        chip8_triple_init(&instance->triple);
+        instance->frames = 0;
+        instance->slept = 0;
+    } /* End of for loop */
+    return 0;
+} /* End of fleet init function */
+
+void chip8_fleet_free(struct chip8_fleet* fleet)
+{
+    free(fleet->instances);
+    fleet->instances = NULL;
+    fleet->count = 0;
+} /* End of fleet free function */
+
+/* Runs one frame of every live instance in the worker's shard and
+ * publishes those whose screen changed. The first frame is always
+ * published so the viewer has something to draw for each instance.
+ * Returns how many instances actually ran. */
+int chip8_fleet_run_frame(struct chip8_fleet* fleet, int worker, int workers)
+{
+    int first = (long long) fleet->count * worker / workers;
+    int last = (long long) fleet->count * (worker + 1) / workers;
+    unsigned int keys = atomic_load_explicit(&fleet->keys, memory_order_relaxed);
+    int focus = atomic_load_explicit(&fleet->focus, memory_order_relaxed);
+    int ran = 0;
+
+    for (int i = first; i < last; i++)
+    {
+        struct chip8_fleet_instance* instance = &fleet->instances[i];
+        struct chip8* chip8 = &instance->chip8;
+        if (chip8->fault != CHIP8_FAULT_NONE)
+        {
+            continue;
+        } /* End of if statement */
+
+        chip8_keyboard_set_mask(&chip8->keyboard, focus == CHIP8_FLEET_ALL || focus == i ? keys : 0);
+        if (fleet->powersave && chip8_can_sleep(chip8))
+        {
+            chip8_skip_frames(chip8, 1);
+            instance->frames++;
+            instance->slept++;
+            continue;
+        } /* End of if statement */
+
+        chip8_run_frame(chip8);
+        ran++;
+        if (chip8_screen_take_dirty_rows(&chip8->screen) || instance->frames == 0)
+        {
+            chip8_frame_capture(chip8_triple_back(&instance->triple), chip8, instance->frames);
+            chip8_triple_publish(&instance->triple);
+        } /* End of if statement */
+        instance->frames++;
+    } /* End of for loop */
+    return ran;
+} /* End of fleet run frame function */
@@ -0,0 +1,23 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8frame.c */
+
+#include <string.h>
+
+#include "chip8frame.h"
+
+void chip8_frame_capture(struct chip8_frame* frame, const struct chip8* chip8, unsigned long long number)
+{
+    frame->frame = number;
+    frame->width = chip8_screen_width(&chip8->screen);
+    frame->height = chip8_screen_height(&chip8->screen);
+    frame->I = chip8->registers.I;
+    frame->PC = chip8->registers.PC;
+    memcpy(frame->V, chip8->registers.V, sizeof(frame->V));
+    frame->SP = chip8->registers.SP;
+    frame->delay_timer = chip8_delay_timer(chip8);
+    frame->sound_timer = chip8_sound_timer(chip8);
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        chip8_screen_pack(&chip8->screen, plane, frame->pixels[plane]);
+    } /* End of for loop */
+} /* End of frame capture function */
@@ -0,0 +1,63 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8hash.c */
+
+#include "chip8hash.h"
+#include "chip8.h"
+
+#define CHIP8_FNV_OFFSET 0xcbf29ce484222325ULL
+#define CHIP8_FNV_PRIME 0x100000001b3ULL
+
+static unsigned long long chip8_fnv(unsigned long long hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= CHIP8_FNV_PRIME;
+    } /* End of for loop */
+    return hash;
+} /* End of fnv function */
+
+static unsigned long long chip8_fnv_short(unsigned long long hash, unsigned short val)
+{
+    unsigned char bytes[2] = { val >> 8, val & 0xff };
+    return chip8_fnv(hash, bytes, sizeof(bytes));
+} /* End of fnv short function */
+
+/* The screen is hashed as packed rows, MSB first, one plane after the
+ * other, so the digest does not depend on how chip8_screen stores its
+ * pixels */
+unsigned long long chip8_hash_screen(const struct chip8* chip8)
+{
+    unsigned char packed[CHIP8_SCREEN_PACKED_SIZE];
+    unsigned long long hash = CHIP8_FNV_OFFSET;
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        chip8_screen_pack(&chip8->screen, plane, packed);
+        hash = chip8_fnv(hash, packed, chip8_screen_packed_size(&chip8->screen));
+    } /* End of for loop */
+    return hash;
+} /* End of hash screen function */
+
+void chip8_hash(const struct chip8* chip8, struct chip8_hashes* hashes)
+{
+    const struct chip8_registers* registers = &chip8->registers;
+
+    /* Hashed field by field so struct padding never leaks in */
+    unsigned long long hash = chip8_fnv(CHIP8_FNV_OFFSET, registers->V, sizeof(registers->V));
+    hash = chip8_fnv_short(hash, registers->I);
+    unsigned char timers[2] = { chip8_delay_timer(chip8), chip8_sound_timer(chip8) };
+    hash = chip8_fnv(hash, timers, sizeof(timers));
+    hash = chip8_fnv_short(hash, registers->PC);
+    hash = chip8_fnv(hash, &registers->SP, 1);
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++)
+    {
+        hash = chip8_fnv_short(hash, chip8->stack.stack[i]);
+    } /* End of for loop */
+    hash = chip8_fnv(hash, chip8->audio.pattern, sizeof(chip8->audio.pattern));
+    hash = chip8_fnv(hash, &chip8->audio.pitch, 1);
+    hashes->registers = hash;
+
+    hashes->screen = chip8_hash_screen(chip8);
+    hashes->memory = chip8_fnv(CHIP8_FNV_OFFSET, chip8->memory.memory, sizeof(chip8->memory.memory));
+} /* End of hash function */
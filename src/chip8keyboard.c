@@ -22,8 +22,8 @@ int chip8_keyboard_map(struct chip8_keyboard* keyboard, char key)
         {
             return i;
         } /* End if nested if statement */
-        return -1;
     } /* End for loop */
+    return -1;
 }
 
 void chip8_keyboard_down(struct chip8_keyboard *keyboard, int key)
@@ -36,6 +36,16 @@ void chip8_keyboard_up(struct chip8_keyboard *keyboard, int key)
     keyboard->keyboard[key] = false;
 } /* End keyboard up function */
 
+/* Replaces the whole key state with a bitmask, bit n for key n. This is
+ * how a frontend on another thread passes its input in. */
+void chip8_keyboard_set_mask(struct chip8_keyboard* keyboard, unsigned int mask)
+{
+    for (int i = 0; i < CHIP8_TOTAL_KEYS; i++)
+    {
+        keyboard->keyboard[i] = (mask >> i) & 1;
+    } /* End for loop */
+} /* End keyboard set mask function */
+
 bool chip8_keyboard_is_down(struct chip8_keyboard *keyboard, int key)
 {
     return keyboard->keyboard[key];
@@ -0,0 +1,72 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8loader.c */
+
+#include <stdio.h>
+#include <string.h>
+#include "chip8loader.h"
+
+/* Reads a ROM straight into the program region with no intermediate
+ * buffer. Oversized files are rejected before anything is read where the
+ * file can be measured up front; otherwise a failed load may leave part
+ * of the program region overwritten. */
+enum chip8_load_result chip8_load_file(struct chip8* chip8, const char* filename)
+{
+    FILE* f = fopen(filename, "rb");
+    if (!f)
+    {
+        return CHIP8_LOAD_OPEN_FAILED;
+    } /* End of if statement */
+
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0)
+    {
+        size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+    } /* End of if statement */
+    if (size > CHIP8_PROGRAM_MAX_SIZE)
+    {
+        fclose(f);
+        return CHIP8_LOAD_TOO_LARGE;
+    } /* End of if statement */
+
+    unsigned char* program = &chip8->memory.memory[CHIP8_PROGRAM_LOAD_ADDRESS];
+    size_t read = fread(program, 1, CHIP8_PROGRAM_MAX_SIZE, f);
+    if (read > 0)
+    {
+        chip8_memory_mark(&chip8->memory, CHIP8_PROGRAM_LOAD_ADDRESS, read);
+    } /* End of if statement */
+    if (ferror(f))
+    {
+        fclose(f);
+        return CHIP8_LOAD_READ_FAILED;
+    } /* End of if statement */
+
+    /* Unseekable input is only known to be too large once it has filled
+     * the program region with more to come */
+    if (read == CHIP8_PROGRAM_MAX_SIZE && fgetc(f) != EOF)
+    {
+        fclose(f);
+        return CHIP8_LOAD_TOO_LARGE;
+    } /* End of if statement */
+    fclose(f);
+
+    chip8_loaded(chip8, read);
+    return CHIP8_LOAD_OK;
+} /* End of load file function */
+
+/* Picks a quirk profile from the conventional file extensions: .sc8 for
+ * SUPER-CHIP and .xo8 for XO-CHIP. Anything else gets the default
+ * profile. */
+const struct chip8_profile* chip8_profile_for_file(const char* filename)
+{
+    const char* extension = strrchr(filename, '.');
+    if (extension && strcmp(extension, ".sc8") == 0)
+    {
+        return chip8_profile_find("schip");
+    } /* End of if statement */
+    if (extension && strcmp(extension, ".xo8") == 0)
+    {
+        return chip8_profile_find("xochip");
+    } /* End of if statement */
+    return &chip8_profiles[0];
+} /* End of profile for file function */
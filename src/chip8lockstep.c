@@ -0,0 +1,218 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8lockstep.c */
+
+#include <string.h>
+#include "chip8lockstep.h"
+#include "chip8disasm.h"
+
+/* Compares everything a ROM can observe. Bookkeeping such as the cycle
+ * counter and the attached trace is ignored; the timers and the display
+ * wait are compared as they read now rather than by the cycle they
+ * were set at. */
+bool chip8_state_equal(const struct chip8* a, const struct chip8* b)
+{
+    const struct chip8_registers* ra = &a->registers;
+    const struct chip8_registers* rb = &b->registers;
+
+    return memcmp(ra->V, rb->V, sizeof(ra->V)) == 0
+        && ra->I == rb->I
+        && chip8_delay_timer(a) == chip8_delay_timer(b)
+        && chip8_sound_timer(a) == chip8_sound_timer(b)
+        && ra->PC == rb->PC
+        && ra->SP == rb->SP
+        && a->random_state == b->random_state
+        && a->fault == b->fault
+        && (chip8_frame_at(a->cycles) > a->vblank_frame) == (chip8_frame_at(b->cycles) > b->vblank_frame)
+        && a->profile == b->profile
+        && memcmp(a->stack.stack, b->stack.stack, sizeof(a->stack.stack)) == 0
+        && memcmp(a->keyboard.keyboard, b->keyboard.keyboard, sizeof(a->keyboard.keyboard)) == 0
+        && memcmp(a->memory.memory, b->memory.memory, sizeof(a->memory.memory)) == 0
+        && a->screen.hires == b->screen.hires
+        && a->screen.planes == b->screen.planes
+        && memcmp(a->audio.pattern, b->audio.pattern, sizeof(a->audio.pattern)) == 0
+        && a->audio.pitch == b->audio.pitch
+        && memcmp(a->screen.rows, b->screen.rows, sizeof(a->screen.rows)) == 0;
+} /* End of state equal function */
+
+void chip8_lockstep_init(struct chip8_lockstep* lockstep, const struct chip8_backend* backend_a,
+        const struct chip8_backend* backend_b, const struct chip8* start, unsigned int interval)
+{
+    lockstep->backend_a = backend_a;
+    lockstep->backend_b = backend_b;
+    lockstep->a = *start;
+    lockstep->a.trace = NULL;
+    lockstep->b = lockstep->a;
+    lockstep->checkpoint = lockstep->a;
+    lockstep->interval = interval ? interval : 1;
+} /* End of lockstep init function */
+
+/* Runs a core for up to cycles instructions, stopping on a fault as
+ * the run loops do. A backend with a run function gets them as a single
+ * run, fused however it likes. */
+static void chip8_lockstep_advance_core(const struct chip8_backend* backend, struct chip8* chip8,
+        unsigned long long cycles)
+{
+    if (backend->run)
+    {
+        backend->run(chip8, cycles);
+        return;
+    } /* End of if statement */
+
+    unsigned long long end = chip8->cycles + cycles;
+    while (chip8->cycles < end && chip8->fault == CHIP8_FAULT_NONE)
+    {
+        backend->step(chip8);
+    } /* End of while loop */
+} /* End of lockstep advance core function */
+
+static void chip8_lockstep_advance(struct chip8_lockstep* lockstep, unsigned long long cycles)
+{
+    chip8_lockstep_advance_core(lockstep->backend_a, &lockstep->a, cycles);
+    chip8_lockstep_advance_core(lockstep->backend_b, &lockstep->b, cycles);
+} /* End of lockstep advance function */
+
+/* Both cores last agreed at the checkpoint, so replay from there one
+ * instruction at a time until they part ways. A backend with a run
+ * function is only compared at the end of a run, so it is replayed as
+ * ever longer runs from the checkpoint instead, and the first run that
+ * ends in disagreement names the instruction. A backend that doesn't
+ * behave the same way twice may not diverge again, so the replay stops
+ * after the interval that was checked; the divergence is then reported
+ * as found, without the instruction that caused it. */
+static void chip8_lockstep_bisect(struct chip8_lockstep* lockstep, struct chip8_divergence* divergence)
+{
+    struct chip8* a = &lockstep->a;
+    struct chip8* b = &lockstep->b;
+    bool runs = lockstep->backend_a->run || lockstep->backend_b->run;
+    divergence->reproduced = false;
+    divergence->cycle = a->cycles;
+    divergence->a = *a;
+    divergence->b = *b;
+
+    *a = lockstep->checkpoint;
+    *b = lockstep->checkpoint;
+    for (unsigned int i = 0; i < lockstep->interval; i++)
+    {
+        divergence->before = *a;
+        if (runs)
+        {
+            *a = lockstep->checkpoint;
+            *b = lockstep->checkpoint;
+            chip8_lockstep_advance(lockstep, i + 1);
+        }
+        else
+        {
+            chip8_lockstep_advance(lockstep, 1);
+        } /* End of if statement */
+        if (!chip8_state_equal(a, b))
+        {
+            divergence->reproduced = true;
+            divergence->cycle = divergence->before.cycles;
+            divergence->PC = divergence->before.registers.PC;
+            divergence->opcode = chip8_memory_get_short(&divergence->before.memory,
+                    chip8_address_space(&divergence->before), divergence->PC);
+            divergence->a = *a;
+            divergence->b = *b;
+            return;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    /* Leave the cores as they were found */
+    divergence->before = lockstep->checkpoint;
+    divergence->PC = lockstep->checkpoint.registers.PC;
+    divergence->opcode = chip8_memory_get_short(&lockstep->checkpoint.memory,
+            chip8_address_space(&lockstep->checkpoint), divergence->PC);
+    *a = divergence->a;
+    *b = divergence->b;
+} /* End of lockstep bisect function */
+
+/* Runs both cores for up to cycles instructions, comparing state every
+ * interval instructions. Returns 1 and fills divergence if they disagree. */
+int chip8_lockstep_run(struct chip8_lockstep* lockstep, unsigned long long cycles, struct chip8_divergence* divergence)
+{
+    struct chip8* a = &lockstep->a;
+    struct chip8* b = &lockstep->b;
+    unsigned long long done = 0;
+
+    while (done < cycles)
+    {
+        unsigned long long batch = cycles - done < lockstep->interval ? cycles - done : lockstep->interval;
+        chip8_lockstep_advance(lockstep, batch);
+        done += batch;
+
+        if (!chip8_state_equal(a, b))
+        {
+            chip8_lockstep_bisect(lockstep, divergence);
+            return 1;
+        } /* End of if statement */
+        lockstep->checkpoint = *a;
+    } /* End of while loop */
+
+    return 0;
+} /* End of lockstep run function */
+
+static void chip8_lockstep_print_state(FILE* f, const char* label, const struct chip8* chip8)
+{
+    const struct chip8_registers* registers = &chip8->registers;
+    fprintf(f, "  %-8s PC=%03X I=%03X SP=%02X DT=%02X ST=%02X\n          ", label,
+            registers->PC, registers->I, registers->SP, chip8_delay_timer(chip8), chip8_sound_timer(chip8));
+    for (int i = 0; i < CHIP8_TOTAL_DATA_REGISTERS; i++)
+    {
+        fprintf(f, "V%X=%02X ", i, registers->V[i]);
+    } /* End of for loop */
+    fprintf(f, "\n");
+} /* End of lockstep print state function */
+
+void chip8_lockstep_print(FILE* f, const struct chip8_lockstep* lockstep, const struct chip8_divergence* divergence)
+{
+    char text[32];
+    if (divergence->reproduced)
+    {
+        chip8_disassemble(divergence->opcode, text, sizeof(text));
+        fprintf(f, "Divergence at cycle %llu: %03X  %04X  %s\n", divergence->cycle,
+                divergence->PC, divergence->opcode, text);
+        chip8_lockstep_print_state(f, "before", &divergence->before);
+    }
+    else
+    {
+        fprintf(f, "Divergence by cycle %llu not reproducible from checkpoint at cycle %llu\n",
+                divergence->cycle, divergence->before.cycles);
+        chip8_lockstep_print_state(f, "checkpt", &divergence->before);
+    } /* End of if statement */
+    chip8_lockstep_print_state(f, lockstep->backend_a->name, &divergence->a);
+    chip8_lockstep_print_state(f, lockstep->backend_b->name, &divergence->b);
+
+    const struct chip8* a = &divergence->a;
+    const struct chip8* b = &divergence->b;
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++)
+    {
+        if (a->stack.stack[i] != b->stack.stack[i])
+        {
+            fprintf(f, "  stack[%d] %03X != %03X\n", i, a->stack.stack[i], b->stack.stack[i]);
+        } /* End of nested if statement */
+    } /* End of for loop */
+    for (int i = 0; i < CHIP8_MEMORY_SIZE; i++)
+    {
+        if (a->memory.memory[i] != b->memory.memory[i])
+        {
+            fprintf(f, "  memory[%04X] %02X != %02X\n", i, a->memory.memory[i], b->memory.memory[i]);
+        } /* End of nested if statement */
+    } /* End of for loop */
+    if (a->screen.hires != b->screen.hires)
+    {
+        fprintf(f, "  hires %d != %d\n", a->screen.hires, b->screen.hires);
+        return;
+    } /* End of if statement */
+    for (int y = 0; y < chip8_screen_height(&a->screen); y++)
+    {
+        for (int x = 0; x < chip8_screen_width(&a->screen); x++)
+        {
+            int pixel_a = chip8_screen_pixel(&a->screen, x, y);
+            int pixel_b = chip8_screen_pixel(&b->screen, x, y);
+            if (pixel_a != pixel_b)
+            {
+                fprintf(f, "  pixel (%d, %d) %d != %d\n", x, y, pixel_a, pixel_b);
+            } /* End of if statement */
+        } /* End of nested for loop */
+    } /* End of for loop */
+} /* End of lockstep print function */
@@ -2,28 +2,51 @@
  * File name : chip8memory.c */
 
 #include "chip8memory.h"
-#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
 
-static void chip8_is_memory_in_bounds(int index)
+/* Slow path for the TRAP and REPORT policies, kept out of line so the
+ * inlined accessors stay small */
+int chip8_memory_out_of_bounds(struct chip8_memory* memory, int space, int index)
 {
-    assert(index >= 0 && index < CHIP8_MEMORY_SIZE);
-} /* End static void function */
+#if CHIP8_MEMORY_POLICY == CHIP8_MEMORY_TRAP
+    fprintf(stderr, "chip8: memory access out of range at 0x%X\n", index);
+    abort();
+#endif
+    memory->fault = true;
+    return index & (space - 1);
+} /* End of out of bounds function */
 
-void chip8_memory_set(struct chip8_memory *memory, int index, unsigned char val)
+/* Applies the policy once for the whole block, then copies it as at most
+ * two runs split at the end of the address space */
+static int chip8_memory_block_start(struct chip8_memory* memory, int space, int index, int size)
 {
-    chip8_is_memory_in_bounds(index);
-    memory->memory[index] = val;
-} /* End memory set function */
+#if CHIP8_MEMORY_POLICY != CHIP8_MEMORY_WRAP
+    if (index < 0 || index + size > space)
+    {
+        chip8_memory_out_of_bounds(memory, space, index);
+    } /* End of if statement */
+#endif
+    return index & (space - 1);
+} /* End of block start function */
 
-unsigned char chip8_memory_get(struct chip8_memory *memory, int index)
+void chip8_memory_write_block_wrapped(struct chip8_memory* memory, int space, int index, const unsigned char* src, int size)
 {
-    chip8_is_memory_in_bounds(index);
-    return memory->memory[index];
-} /* End memory get function */
+    int start = chip8_memory_block_start(memory, space, index, size);
+    int first = space - start < size ? space - start : size;
+    memcpy(&memory->memory[start], src, first);
+    chip8_memory_mark(memory, start, first);
+    if (size > first)
+    {
+        memcpy(memory->memory, src + first, size - first);
+        chip8_memory_mark(memory, 0, size - first);
+    } /* End of if statement */
+} /* End of write block wrapped function */
 
-unsigned short chip8_memory_get_short(struct chip8_memory* memory, int index)
+void chip8_memory_read_block_wrapped(struct chip8_memory* memory, int space, int index, unsigned char* dst, int size)
 {
-    unsigned char byte1 = chip8_memory_get(memory, index);
-    unsigned char byte2 = chip8_memory_get(memory, index+1);
-    return byte1 << 8 | byte2;
-} /* End of get short function */
+    int start = chip8_memory_block_start(memory, space, index, size);
+    int first = space - start < size ? space - start : size;
+    memcpy(dst, &memory->memory[start], first);
+    memcpy(dst + first, memory->memory, size - first);
+} /* End of read block wrapped function */
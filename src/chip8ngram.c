@@ -0,0 +1,265 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8ngram.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8ngram.h"
+
+#define CHIP8_NGRAM_TRIPLE(a, b, c) (((a) * CHIP8_TOTAL_OPS + (b)) * CHIP8_TOTAL_OPS + (c))
+#define CHIP8_NGRAM_TOTAL_TRIPLES (CHIP8_TOTAL_OPS * CHIP8_TOTAL_OPS * CHIP8_TOTAL_OPS)
+
+int chip8_ngrams_init(struct chip8_ngrams* ngrams)
+{
+    memset(ngrams, 0, sizeof(struct chip8_ngrams));
+    ngrams->triples = calloc(CHIP8_NGRAM_TOTAL_TRIPLES, sizeof(unsigned long long));
+    if (!ngrams->triples)
+    {
+        return -1;
+    } /* End of if statement */
+    ngrams->previous[0] = -1;
+    ngrams->previous[1] = -1;
+    return 0;
+} /* End of ngrams init function */
+
+void chip8_ngrams_free(struct chip8_ngrams* ngrams)
+{
+    free(ngrams->triples);
+    ngrams->triples = NULL;
+} /* End of ngrams free function */
+
+/* Counts the instruction about to run at pc. It extends the run before
+ * it only if it sits straight after the last one recorded, so a jump,
+ * a taken skip or a wait starts a new run. */
+void chip8_ngrams_record(struct chip8_ngrams* ngrams, unsigned short pc, unsigned short opcode)
+{
+    int op = chip8_op_decode(opcode);
+    ngrams->singles[op]++;
+    if (pc != ngrams->next_pc)
+    {
+        ngrams->previous[0] = -1;
+        ngrams->previous[1] = -1;
+    } /* End of if statement */
+
+    if (ngrams->previous[1] >= 0)
+    {
+        ngrams->pairs[ngrams->previous[1]][op]++;
+        if (ngrams->previous[0] >= 0)
+        {
+            ngrams->triples[CHIP8_NGRAM_TRIPLE(ngrams->previous[0], ngrams->previous[1], op)]++;
+        } /* End of nested if statement */
+    } /* End of if statement */
+    ngrams->previous[0] = ngrams->previous[1];
+    ngrams->previous[1] = op;
+    ngrams->next_pc = pc + 2;
+} /* End of ngrams record function */
+
+/* The profile's run loop one step at a time, recording every
+ * instruction it runs. Idle waits are counted once, not once per
+ * instruction they stand for, as a run never executes the repeats. */
+void chip8_ngrams_run(struct chip8_ngrams* ngrams, struct chip8* chip8, int cycles)
+{
+    unsigned long long end = chip8->cycles + cycles;
+    chip8->idle = CHIP8_IDLE_NONE;
+    while (chip8->cycles < end && chip8->fault == CHIP8_FAULT_NONE)
+    {
+        unsigned short pc = chip8->registers.PC;
+        chip8_ngrams_record(ngrams, pc, chip8_memory_get_short(&chip8->memory, chip8_address_space(chip8), pc));
+        chip8_step(chip8);
+        if (chip8->idle != CHIP8_IDLE_NONE && !chip8->trace && chip8_idle_forward(chip8, end))
+        {
+            break;
+        } /* End of if statement */
+    } /* End of while loop */
+} /* End of ngrams run function */
+
+/* One line per non-zero count : the count, then the forms by their
+ * opcode patterns, e.g. "1024 Annn Dxyn" */
+void chip8_ngrams_write(const struct chip8_ngrams* ngrams, FILE* f)
+{
+    for (int a = 0; a < CHIP8_TOTAL_OPS; a++)
+    {
+        if (ngrams->singles[a])
+        {
+            fprintf(f, "%llu %s\n", ngrams->singles[a], chip8_op_name(a));
+        } /* End of if statement */
+    } /* End of for loop */
+    for (int a = 0; a < CHIP8_TOTAL_OPS; a++)
+    {
+        for (int b = 0; b < CHIP8_TOTAL_OPS; b++)
+        {
+            if (ngrams->pairs[a][b])
+            {
+                fprintf(f, "%llu %s %s\n", ngrams->pairs[a][b], chip8_op_name(a), chip8_op_name(b));
+            } /* End of if statement */
+        } /* End of nested for loop */
+    } /* End of for loop */
+    for (int i = 0; i < CHIP8_NGRAM_TOTAL_TRIPLES; i++)
+    {
+        if (ngrams->triples[i])
+        {
+            fprintf(f, "%llu %s %s %s\n", ngrams->triples[i], chip8_op_name(i / (CHIP8_TOTAL_OPS * CHIP8_TOTAL_OPS)),
+                    chip8_op_name(i / CHIP8_TOTAL_OPS % CHIP8_TOTAL_OPS), chip8_op_name(i % CHIP8_TOTAL_OPS));
+        } /* End of if statement */
+    } /* End of for loop */
+} /* End of ngrams write function */
+
+/* Adds the counts of one line written by chip8_ngrams_write. Returns -1
+ * if the line is malformed or names no known form. */
+int chip8_ngrams_parse(struct chip8_ngrams* ngrams, const char* line)
+{
+    char names[3][16];
+    unsigned long long count;
+    int fields = sscanf(line, "%llu %15s %15s %15s", &count, names[0], names[1], names[2]);
+    if (fields < 2)
+    {
+        return -1;
+    } /* End of if statement */
+
+    int ops[3];
+    for (int i = 0; i < fields - 1; i++)
+    {
+        ops[i] = chip8_op_find(names[i]);
+        if (ops[i] < 0)
+        {
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    if (fields == 2)
+    {
+        ngrams->singles[ops[0]] += count;
+    }
+    else if (fields == 3)
+    {
+        ngrams->pairs[ops[0]][ops[1]] += count;
+    }
+    else
+    {
+        ngrams->triples[CHIP8_NGRAM_TRIPLE(ops[0], ops[1], ops[2])] += count;
+    } /* End of if statement */
+    return 0;
+} /* End of ngrams parse function */
+
+int chip8_ngrams_save(const struct chip8_ngrams* ngrams, const char* filename)
+{
+    FILE* f = fopen(filename, "w");
+    if (!f)
+    {
+        return -1;
+    } /* End of if statement */
+
+    fprintf(f, "# chip8 n-grams : count, then the instruction forms run back to back\n");
+    chip8_ngrams_write(ngrams, f);
+    int res = ferror(f) ? -1 : 0;
+    fclose(f);
+    return res;
+} /* End of ngrams save function */
+
+/* Adds the counts saved in filename to ngrams. Lines of the other
+ * records a profiling build writes (see chip8profiler.h) start with a
+ * letter and are skipped, so its counts load here too. Returns -1 if
+ * the file can't be read or an n-gram line is malformed. */
+int chip8_ngrams_load(struct chip8_ngrams* ngrams, const char* filename)
+{
+    FILE* f = fopen(filename, "r");
+    if (!f)
+    {
+        return -1;
+    } /* End of if statement */
+
+    char line[256];
+    int res = 0;
+    while (res == 0 && fgets(line, sizeof(line), f))
+    {
+        if (line[0] >= '0' && line[0] <= '9')
+        {
+            res = chip8_ngrams_parse(ngrams, line);
+        } /* End of if statement */
+    } /* End of while loop */
+
+    fclose(f);
+    return res;
+} /* End of ngrams load function */
+
+/* Picks up to max runs to fuse, best first by the dispatches they save
+ * on the profile : a run of n forms executed as one saves n - 1 each
+ * time. What a pick already saves is taken off the rest, so a pair only
+ * counts the times it ran without a picked triple's third form after
+ * it, and a triple over a picked pair saves one dispatch rather than
+ * two. Runs that store to memory before their last form are never
+ * picked. Returns the number of runs picked, -1 without memory. */
+int chip8_fusion_select(struct chip8_fusion* fusion, const struct chip8_ngrams* ngrams, int max)
+{
+    memset(fusion, 0, sizeof(struct chip8_fusion));
+    if (max > CHIP8_FUSION_MAX_PATTERNS)
+    {
+        max = CHIP8_FUSION_MAX_PATTERNS;
+    } /* End of if statement */
+
+    bool pair_picked[CHIP8_TOTAL_OPS][CHIP8_TOTAL_OPS] = { { false } };
+    unsigned long long covered[CHIP8_TOTAL_OPS][CHIP8_TOTAL_OPS] = { { 0 } };
+    bool* triple_picked = calloc(CHIP8_NGRAM_TOTAL_TRIPLES, sizeof(bool));
+    if (!triple_picked)
+    {
+        return -1;
+    } /* End of if statement */
+
+    while (fusion->count < max)
+    {
+        struct chip8_fusion_pattern best = { { 0 }, 0, 0 };
+        unsigned long long best_saving = 0;
+        for (int a = 0; a < CHIP8_TOTAL_OPS; a++)
+        {
+            if (chip8_op_writes_memory(a))
+            {
+                continue;
+            } /* End of if statement */
+
+            for (int b = 0; b < CHIP8_TOTAL_OPS; b++)
+            {
+                unsigned long long saving = ngrams->pairs[a][b] > covered[a][b] ? ngrams->pairs[a][b] - covered[a][b] : 0;
+                if (!pair_picked[a][b] && saving > best_saving)
+                {
+                    best = (struct chip8_fusion_pattern) { { a, b }, 2, ngrams->pairs[a][b] };
+                    best_saving = saving;
+                } /* End of if statement */
+
+                if (chip8_op_writes_memory(b))
+                {
+                    continue;
+                } /* End of if statement */
+                for (int c = 0; c < CHIP8_TOTAL_OPS; c++)
+                {
+                    int i = CHIP8_NGRAM_TRIPLE(a, b, c);
+                    saving = ngrams->triples[i] * (pair_picked[a][b] ? 1 : 2);
+                    if (!triple_picked[i] && saving > best_saving)
+                    {
+                        best = (struct chip8_fusion_pattern) { { a, b, c }, 3, ngrams->triples[i] };
+                        best_saving = saving;
+                    } /* End of if statement */
+                } /* End of nested for loop */
+            } /* End of nested for loop */
+        } /* End of for loop */
+
+        if (best_saving == 0)
+        {
+            break;
+        } /* End of if statement */
+
+        if (best.length == 2)
+        {
+            pair_picked[best.ops[0]][best.ops[1]] = true;
+        }
+        else
+        {
+            triple_picked[CHIP8_NGRAM_TRIPLE(best.ops[0], best.ops[1], best.ops[2])] = true;
+            covered[best.ops[0]][best.ops[1]] += best.count;
+        } /* End of if statement */
+        fusion->patterns[fusion->count++] = best;
+    } /* End of while loop */
+
+    free(triple_picked);
+    return fusion->count;
+} /* End of fusion select function */
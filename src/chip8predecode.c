@@ -0,0 +1,368 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8predecode.c */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8predecode.h"
+#include "chip8super.h"
+
+/* The generated superinstructions, ending in an empty pattern */
+static const struct chip8_fusion_pattern chip8_supers[] = { CHIP8_SUPER_PATTERNS };
+
+static const char* chip8_op_names[CHIP8_TOTAL_OPS] = {
+    "00E0", "00EE", "00Cn", "00Dn", "00FB", "00FC", "00FE", "00FF",
+    "0nnn", "1nnn", "2nnn", "3xkk", "4xkk", "5xy0", "5xy2", "5xy3",
+    "6xkk", "7xkk", "8xy0", "8xy1", "8xy2", "8xy3", "8xy4", "8xy5",
+    "8xy6", "8xy7", "8xyE", "9xy0", "Annn", "Bnnn", "Cxkk", "Dxyn",
+    "Ex9E", "ExA1", "F000", "Fn01", "F002", "Fx07", "Fx0A", "Fx15",
+    "Fx18", "Fx1E", "Fx29", "Fx30", "Fx33", "Fx3A", "Fx55", "Fx65",
+    "????"
+}; /* End op names array */
+
+/* Classifies opcode the way chip8_exec dispatches it */
+enum chip8_op chip8_op_decode(unsigned short opcode)
+{
+    unsigned char x = (opcode >> 8) & 0x000f;
+    unsigned char kk = opcode & 0x00ff;
+    unsigned char n = opcode & 0x000f;
+
+    switch (opcode & 0xf000)
+    {
+        case 0x0000:
+            switch (opcode)
+            {
+                case 0x00E0:
+                    return CHIP8_OP_CLS;
+                case 0x00EE:
+                    return CHIP8_OP_RET;
+                case 0x00FB:
+                    return CHIP8_OP_SCROLL_RIGHT;
+                case 0x00FC:
+                    return CHIP8_OP_SCROLL_LEFT;
+                case 0x00FE:
+                    return CHIP8_OP_LORES;
+                case 0x00FF:
+                    return CHIP8_OP_HIRES;
+            } /* End of nested switch */
+            switch (opcode & 0xfff0)
+            {
+                case 0x00C0:
+                    return CHIP8_OP_SCROLL_DOWN;
+                case 0x00D0:
+                    return CHIP8_OP_SCROLL_UP;
+            } /* End of nested switch */
+            return CHIP8_OP_SYS;
+        case 0x1000:
+            return CHIP8_OP_JP;
+        case 0x2000:
+            return CHIP8_OP_CALL;
+        case 0x3000:
+            return CHIP8_OP_SE_BYTE;
+        case 0x4000:
+            return CHIP8_OP_SNE_BYTE;
+        case 0x5000:
+            switch (n)
+            {
+                case 0x00:
+                    return CHIP8_OP_SE_REG;
+                case 0x02:
+                    return CHIP8_OP_SAVE_RANGE;
+                case 0x03:
+                    return CHIP8_OP_LOAD_RANGE;
+            } /* End of nested switch */
+            return CHIP8_OP_INVALID;
+        case 0x6000:
+            return CHIP8_OP_LD_BYTE;
+        case 0x7000:
+            return CHIP8_OP_ADD_BYTE;
+        case 0x8000:
+            switch (n)
+            {
+                case 0x00:
+                    return CHIP8_OP_LD_REG;
+                case 0x01:
+                    return CHIP8_OP_OR;
+                case 0x02:
+                    return CHIP8_OP_AND;
+                case 0x03:
+                    return CHIP8_OP_XOR;
+                case 0x04:
+                    return CHIP8_OP_ADD_REG;
+                case 0x05:
+                    return CHIP8_OP_SUB;
+                case 0x06:
+                    return CHIP8_OP_SHR;
+                case 0x07:
+                    return CHIP8_OP_SUBN;
+                case 0x0e:
+                    return CHIP8_OP_SHL;
+            } /* End of nested switch */
+            return CHIP8_OP_INVALID;
+        case 0x9000:
+            return CHIP8_OP_SNE_REG;
+        case 0xA000:
+            return CHIP8_OP_LD_I;
+        case 0xB000:
+            return CHIP8_OP_JP_V0;
+        case 0xC000:
+            return CHIP8_OP_RND;
+        case 0xD000:
+            return CHIP8_OP_DRW;
+        case 0xE000:
+            switch (kk)
+            {
+                case 0x9e:
+                    return CHIP8_OP_SKP;
+                case 0xa1:
+                    return CHIP8_OP_SKNP;
+            } /* End of nested switch */
+            return CHIP8_OP_INVALID;
+    } /* End of switch statement */
+
+    switch (kk)
+    {
+        case 0x00:
+            return x == 0 ? CHIP8_OP_LD_I_LONG : CHIP8_OP_INVALID;
+        case 0x01:
+            return CHIP8_OP_PLANES;
+        case 0x02:
+            return x == 0 ? CHIP8_OP_AUDIO : CHIP8_OP_INVALID;
+        case 0x07:
+            return CHIP8_OP_LD_VX_DT;
+        case 0x0A:
+            return CHIP8_OP_LD_VX_K;
+        case 0x15:
+            return CHIP8_OP_LD_DT_VX;
+        case 0x18:
+            return CHIP8_OP_LD_ST_VX;
+        case 0x1e:
+            return CHIP8_OP_ADD_I;
+        case 0x29:
+            return CHIP8_OP_LD_F;
+        case 0x30:
+            return CHIP8_OP_LD_HF;
+        case 0x33:
+            return CHIP8_OP_BCD;
+        case 0x3a:
+            return CHIP8_OP_PITCH;
+        case 0x55:
+            return CHIP8_OP_STORE;
+        case 0x65:
+            return CHIP8_OP_READ;
+    } /* End of switch statement */
+    return CHIP8_OP_INVALID;
+} /* End of op decode function */
+
+const char* chip8_op_name(enum chip8_op op)
+{
+    return op < CHIP8_TOTAL_OPS ? chip8_op_names[op] : "????";
+} /* End of op name function */
+
+/* Returns the op named by its opcode pattern, e.g. "Dxyn", or -1 */
+int chip8_op_find(const char* name)
+{
+    for (int i = 0; i < CHIP8_TOTAL_OPS; i++)
+    {
+        if (strcmp(chip8_op_names[i], name) == 0)
+        {
+            return i;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    return -1;
+} /* End of op find function */
+
+/* Forms that store to memory. They only ever end a fused run, as the
+ * instructions after them were checked against memory before the run
+ * started. */
+bool chip8_op_writes_memory(enum chip8_op op)
+{
+    return op == CHIP8_OP_SAVE_RANGE || op == CHIP8_OP_BCD || op == CHIP8_OP_STORE;
+} /* End of op writes memory function */
+
+/* Forms that never touch PC, memory or the stack and never wait, so a
+ * run of them needs no checks between instructions */
+bool chip8_op_straight(enum chip8_op op)
+{
+    switch (op)
+    {
+        case CHIP8_OP_CLS:
+        case CHIP8_OP_SCROLL_DOWN:
+        case CHIP8_OP_SCROLL_UP:
+        case CHIP8_OP_SCROLL_RIGHT:
+        case CHIP8_OP_SCROLL_LEFT:
+        case CHIP8_OP_LORES:
+        case CHIP8_OP_HIRES:
+        case CHIP8_OP_SYS:
+        case CHIP8_OP_LD_BYTE:
+        case CHIP8_OP_ADD_BYTE:
+        case CHIP8_OP_LD_REG:
+        case CHIP8_OP_OR:
+        case CHIP8_OP_AND:
+        case CHIP8_OP_XOR:
+        case CHIP8_OP_ADD_REG:
+        case CHIP8_OP_SUB:
+        case CHIP8_OP_SHR:
+        case CHIP8_OP_SUBN:
+        case CHIP8_OP_SHL:
+        case CHIP8_OP_LD_I:
+        case CHIP8_OP_RND:
+        case CHIP8_OP_PLANES:
+        case CHIP8_OP_LD_VX_DT:
+        case CHIP8_OP_LD_DT_VX:
+        case CHIP8_OP_LD_ST_VX:
+        case CHIP8_OP_ADD_I:
+        case CHIP8_OP_LD_F:
+        case CHIP8_OP_LD_HF:
+        case CHIP8_OP_PITCH:
+        case CHIP8_OP_INVALID:
+            return true;
+        default:
+            return false;
+    } /* End of switch statement */
+} /* End of op straight function */
+
+int chip8_predecode_init(struct chip8_predecode* predecode, const struct chip8_fusion* fusion)
+{
+    memset(predecode, 0, sizeof(struct chip8_predecode));
+    predecode->entries = calloc(CHIP8_MEMORY_SIZE, sizeof(struct chip8_decoded));
+    if (!predecode->entries)
+    {
+        return -1;
+    } /* End of if statement */
+    if (fusion)
+    {
+        predecode->fusion = *fusion;
+    } /* End of if statement */
+    return 0;
+} /* End of predecode init function */
+
+void chip8_predecode_free(struct chip8_predecode* predecode)
+{
+    free(predecode->entries);
+    predecode->entries = NULL;
+} /* End of predecode free function */
+
+/* Sets the entry's length to the longest superinstruction or fusion
+ * pattern its ops start with, 1 if none does */
+static void chip8_predecode_match(const struct chip8_fusion* fusion, struct chip8_decoded* decoded)
+{
+    decoded->length = 1;
+    decoded->super = 0;
+    for (int i = 0; chip8_supers[i].length; i++)
+    {
+        if (chip8_supers[i].length > decoded->length
+                && memcmp(chip8_supers[i].ops, decoded->ops, chip8_supers[i].length) == 0)
+        {
+            decoded->length = chip8_supers[i].length;
+            decoded->super = i + 1;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    for (int i = 0; i < fusion->count; i++)
+    {
+        const struct chip8_fusion_pattern* pattern = &fusion->patterns[i];
+        if (pattern->length > decoded->length && memcmp(pattern->ops, decoded->ops, pattern->length) == 0)
+        {
+            decoded->length = pattern->length;
+            decoded->super = 0;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    for (int i = 0; i < decoded->length - 1; i++)
+    {
+        if (chip8_op_writes_memory(decoded->ops[i]))
+        {
+            decoded->length = i + 1;
+            decoded->super = 0;
+        } /* End of if statement */
+    } /* End of for loop */
+} /* End of predecode match function */
+
+/* Decodes the instructions at pc into decoded, as one fused run if they
+ * start one of the fusion's patterns. code is the memory from pc that
+ * the entry is checked against from now on. */
+void chip8_predecode_decode(struct chip8_predecode* predecode, const struct chip8* chip8,
+        unsigned short pc, struct chip8_decoded* decoded, unsigned long long code)
+{
+    const unsigned char* memory = &chip8->memory.memory[pc];
+    for (int i = 0; i < CHIP8_FUSE_MAX; i++)
+    {
+        decoded->opcodes[i] = memory[2*i] << 8 | memory[2*i + 1];
+        decoded->ops[i] = chip8_op_decode(decoded->opcodes[i]);
+    } /* End of for loop */
+    chip8_predecode_match(&predecode->fusion, decoded);
+
+    /* The mask is built in memory order so it lines up with code on
+     * hosts of either byte order */
+    unsigned char mask[sizeof(decoded->mask)] = { 0 };
+    memset(mask, 0xff, 2 * decoded->length);
+    memcpy(&decoded->mask, mask, sizeof(decoded->mask));
+    decoded->code = code;
+    predecode->decodes++;
+} /* End of predecode decode function */
+
+/* The profile's run loop over the decode cache, see chip8exec.h */
+void chip8_predecode_run(struct chip8_predecode* predecode, struct chip8* chip8, int cycles)
+{
+    chip8->profile->run_predecoded(predecode, chip8, cycles);
+} /* End of predecode run function */
+
+void chip8_predecode_run_frame(struct chip8_predecode* predecode, struct chip8* chip8)
+{
+    chip8->profile->run_predecoded(predecode, chip8, CHIP8_CYCLES_PER_FRAME);
+} /* End of predecode run frame function */
+
+/* Runs the one instruction at PC, never a whole fused run */
+void chip8_predecode_step(struct chip8_predecode* predecode, struct chip8* chip8)
+{
+    chip8->profile->step_predecoded(predecode, chip8);
+} /* End of predecode step function */
+
+/* The "predecode" backend, a step over one cache shared by every core
+ * the caller's thread steps with it. Without memory for the cache it
+ * falls back on the profile's step. */
+void chip8_predecode_backend_step(struct chip8* chip8)
+{
+    static _Thread_local struct chip8_predecode predecode;
+    static _Thread_local bool ready;
+    if (!ready)
+    {
+        ready = chip8_predecode_init(&predecode, NULL) == 0;
+        if (!ready)
+        {
+            chip8->profile->step(chip8);
+            return;
+        } /* End of nested if statement */
+    } /* End of if statement */
+    chip8_predecode_step(&predecode, chip8);
+} /* End of predecode backend step function */
+
+/* The fusion table for the "fused" backend. Caches made before it is
+ * set keep the table they were made with. */
+static struct chip8_fusion chip8_backend_fusion;
+
+void chip8_predecode_backend_fuse(const struct chip8_fusion* fusion)
+{
+    chip8_backend_fusion = *fusion;
+} /* End of predecode backend fuse function */
+
+/* The "fused" backend's run, chip8_predecode_run over a cache with the
+ * superinstructions and chip8_predecode_backend_fuse's table. Without
+ * memory for the cache it falls back on the profile's run. */
+void chip8_predecode_backend_run(struct chip8* chip8, int cycles)
+{
+    static _Thread_local struct chip8_predecode predecode;
+    static _Thread_local bool ready;
+    if (!ready)
+    {
+        ready = chip8_predecode_init(&predecode, &chip8_backend_fusion) == 0;
+        if (!ready)
+        {
+            chip8->profile->run(chip8, cycles);
+            return;
+        } /* End of nested if statement */
+    } /* End of if statement */
+    chip8_predecode_run(&predecode, chip8, cycles);
+} /* End of predecode backend run function */
@@ -0,0 +1,290 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8profiler.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8profiler.h"
+
+#define CHIP8_PROFILER_INITIAL_EDGES 1024
+
+int chip8_profiler_init(struct chip8_profiler* profiler)
+{
+    memset(profiler, 0, sizeof(struct chip8_profiler));
+    profiler->counts = calloc(CHIP8_MEMORY_SIZE, sizeof(unsigned long long));
+    profiler->opcodes = calloc(CHIP8_MEMORY_SIZE, sizeof(unsigned short));
+    profiler->edges = calloc(CHIP8_PROFILER_INITIAL_EDGES, sizeof(struct chip8_profiler_edge));
+    profiler->edge_capacity = CHIP8_PROFILER_INITIAL_EDGES;
+    if (!profiler->counts || !profiler->opcodes || !profiler->edges || chip8_ngrams_init(&profiler->ngrams) != 0)
+    {
+        chip8_profiler_free(profiler);
+        return -1;
+    } /* End of if statement */
+    return 0;
+} /* End of profiler init function */
+
+void chip8_profiler_free(struct chip8_profiler* profiler)
+{
+    free(profiler->counts);
+    free(profiler->opcodes);
+    free(profiler->edges);
+    chip8_ngrams_free(&profiler->ngrams);
+    memset(profiler, 0, sizeof(struct chip8_profiler));
+} /* End of profiler free function */
+
+/* The slot holding the edge, or the empty one it would go in. Empty
+ * slots have a count of 0. */
+static size_t chip8_profiler_find(const struct chip8_profiler_edge* edges, size_t capacity,
+        unsigned short from, unsigned short to)
+{
+    unsigned int key = (unsigned int) from << 16 | to;
+    size_t slot = (key * 2654435761u) & (capacity - 1);
+    while (edges[slot].count && (edges[slot].from != from || edges[slot].to != to))
+    {
+        slot = (slot + 1) & (capacity - 1);
+    } /* End of while loop */
+    return slot;
+} /* End of profiler find function */
+
+/* Doubles the edge table once it is three quarters full. Returns -1
+ * without memory, leaving the table as it was. */
+static int chip8_profiler_reserve(struct chip8_profiler* profiler)
+{
+    if ((profiler->edge_count + 1) * 4 <= profiler->edge_capacity * 3)
+    {
+        return 0;
+    } /* End of if statement */
+
+    size_t capacity = profiler->edge_capacity * 2;
+    struct chip8_profiler_edge* edges = calloc(capacity, sizeof(struct chip8_profiler_edge));
+    if (!edges)
+    {
+        return -1;
+    } /* End of if statement */
+    for (size_t i = 0; i < profiler->edge_capacity; i++)
+    {
+        const struct chip8_profiler_edge* edge = &profiler->edges[i];
+        if (edge->count)
+        {
+            edges[chip8_profiler_find(edges, capacity, edge->from, edge->to)] = *edge;
+        } /* End of if statement */
+    } /* End of for loop */
+    free(profiler->edges);
+    profiler->edges = edges;
+    profiler->edge_capacity = capacity;
+    return 0;
+} /* End of profiler reserve function */
+
+/* Adds count takings of the edge. Without memory for a new edge it is
+ * dropped. */
+void chip8_profiler_add_edge(struct chip8_profiler* profiler, unsigned short from, unsigned short to, unsigned long long count)
+{
+    size_t slot = chip8_profiler_find(profiler->edges, profiler->edge_capacity, from, to);
+    if (!profiler->edges[slot].count)
+    {
+        if (count == 0 || chip8_profiler_reserve(profiler) != 0)
+        {
+            return;
+        } /* End of nested if statement */
+        slot = chip8_profiler_find(profiler->edges, profiler->edge_capacity, from, to);
+        profiler->edges[slot].from = from;
+        profiler->edges[slot].to = to;
+        profiler->edge_count++;
+    } /* End of if statement */
+    profiler->edges[slot].count += count;
+} /* End of profiler add edge function */
+
+/* Records the instruction at pc, opcode, as run, with next the PC it
+ * left behind */
+void chip8_profiler_record(struct chip8_profiler* profiler, unsigned short pc, unsigned short opcode, unsigned short next)
+{
+    profiler->counts[pc]++;
+    profiler->opcodes[pc] = opcode;
+    if (next != (unsigned short) (pc + 2))
+    {
+        chip8_profiler_add_edge(profiler, pc, next, 1);
+    } /* End of if statement */
+    chip8_ngrams_record(&profiler->ngrams, pc, opcode);
+} /* End of profiler record function */
+
+/* Writes the counts as text : "pc ADDR OPCODE COUNT" lines, then
+ * "edge FROM TO COUNT" lines, addresses and opcodes in hex, then the
+ * n-grams as chip8_ngrams_write writes them */
+int chip8_profiler_save(const struct chip8_profiler* profiler, const char* filename)
+{
+    FILE* f = fopen(filename, "w");
+    if (!f)
+    {
+        return -1;
+    } /* End of if statement */
+
+    fprintf(f, "# chip8 profile : runs per address, edges taken and n-grams\n");
+    for (int pc = 0; pc < CHIP8_MEMORY_SIZE; pc++)
+    {
+        if (profiler->counts[pc])
+        {
+            fprintf(f, "pc %04x %04x %llu\n", pc, profiler->opcodes[pc], profiler->counts[pc]);
+        } /* End of if statement */
+    } /* End of for loop */
+    for (size_t i = 0; i < profiler->edge_capacity; i++)
+    {
+        const struct chip8_profiler_edge* edge = &profiler->edges[i];
+        if (edge->count)
+        {
+            fprintf(f, "edge %04x %04x %llu\n", edge->from, edge->to, edge->count);
+        } /* End of if statement */
+    } /* End of for loop */
+    chip8_ngrams_write(&profiler->ngrams, f);
+
+    int res = ferror(f) ? -1 : 0;
+    fclose(f);
+    return res;
+} /* End of profiler save function */
+
+/* Adds the counts saved in filename, or n-grams saved on their own, to
+ * profiler. Returns -1 if the file can't be read or a line is
+ * malformed. */
+int chip8_profiler_load(struct chip8_profiler* profiler, const char* filename)
+{
+    FILE* f = fopen(filename, "r");
+    if (!f)
+    {
+        return -1;
+    } /* End of if statement */
+
+    char line[256];
+    int res = 0;
+    while (res == 0 && fgets(line, sizeof(line), f))
+    {
+        unsigned int a;
+        unsigned int b;
+        unsigned long long count;
+        if (line[0] == '#' || strspn(line, " \t\r\n") == strlen(line))
+        {
+            continue;
+        }
+        else if (sscanf(line, "pc %x %x %llu", &a, &b, &count) == 3 && a < CHIP8_MEMORY_SIZE)
+        {
+            profiler->counts[a] += count;
+            profiler->opcodes[a] = b;
+        }
+        else if (sscanf(line, "edge %x %x %llu", &a, &b, &count) == 3 && a < CHIP8_MEMORY_SIZE && b < CHIP8_MEMORY_SIZE)
+        {
+            chip8_profiler_add_edge(profiler, a, b, count);
+        }
+        else
+        {
+            res = chip8_ngrams_parse(&profiler->ngrams, line);
+        } /* End of if statement */
+    } /* End of while loop */
+
+    fclose(f);
+    return res;
+} /* End of profiler load function */
+
+static int chip8_profiler_compare_ops(const void* a, const void* b)
+{
+    return memcmp(((const struct chip8_fusion_pattern*) a)->ops, ((const struct chip8_fusion_pattern*) b)->ops, CHIP8_FUSE_MAX);
+} /* End of profiler compare ops function */
+
+static int chip8_profiler_compare_counts(const void* a, const void* b)
+{
+    unsigned long long x = ((const struct chip8_fusion_pattern*) a)->count;
+    unsigned long long y = ((const struct chip8_fusion_pattern*) b)->count;
+    return x < y ? 1 : x > y ? -1 : 0;
+} /* End of profiler compare counts function */
+
+/* Appends the windows of profiler that ran straight through to
+ * windows, returning how many there now are */
+static size_t chip8_profiler_windows(const struct chip8_profiler* profiler, unsigned long long* taken,
+        struct chip8_fusion_pattern* windows, size_t count)
+{
+    memset(taken, 0, CHIP8_MEMORY_SIZE * sizeof(unsigned long long));
+    for (size_t i = 0; i < profiler->edge_capacity; i++)
+    {
+        taken[profiler->edges[i].from] += profiler->edges[i].count;
+    } /* End of for loop */
+
+    for (int pc = 0; pc <= CHIP8_MEMORY_SIZE - 2 * CHIP8_FUSE_MAX; pc++)
+    {
+        struct chip8_fusion_pattern window = { { 0 }, CHIP8_FUSE_MAX, profiler->counts[pc] };
+        for (int i = 0; i < CHIP8_FUSE_MAX && window.count; i++)
+        {
+            int address = pc + 2 * i;
+            unsigned long long through = profiler->counts[address];
+            window.ops[i] = chip8_op_decode(profiler->opcodes[address]);
+            if (i < CHIP8_FUSE_MAX - 1)
+            {
+                through = chip8_op_writes_memory(window.ops[i]) || taken[address] >= through ? 0 : through - taken[address];
+            } /* End of if statement */
+            if (through < window.count)
+            {
+                window.count = through;
+            } /* End of if statement */
+        } /* End of for loop */
+
+        if (window.count)
+        {
+            windows[count++] = window;
+        } /* End of if statement */
+    } /* End of for loop */
+    return count;
+} /* End of profiler windows function */
+
+/* Picks up to max hot traces : runs of CHIP8_FUSE_MAX forms that the
+ * counts say ran straight through from one address to the next. How
+ * often a window of addresses ran through is estimated as the fewest
+ * times any instruction in it fell through to the next, i.e. ran less
+ * the edges taken from it. Addresses only mean anything within one ROM,
+ * so windows are found in each of the count profilers on its own, then
+ * the windows running the same forms add up wherever they were. Returns
+ * the number of traces picked, -1 without memory. */
+int chip8_profiler_traces(const struct chip8_profiler* profilers, int count, struct chip8_fusion* traces, int max)
+{
+    memset(traces, 0, sizeof(struct chip8_fusion));
+    if (max > CHIP8_FUSION_MAX_PATTERNS)
+    {
+        max = CHIP8_FUSION_MAX_PATTERNS;
+    } /* End of if statement */
+
+    unsigned long long* taken = malloc(CHIP8_MEMORY_SIZE * sizeof(unsigned long long));
+    struct chip8_fusion_pattern* windows = malloc(((size_t) count + 1) * CHIP8_MEMORY_SIZE * sizeof(struct chip8_fusion_pattern));
+    if (!taken || !windows)
+    {
+        free(taken);
+        free(windows);
+        return -1;
+    } /* End of if statement */
+
+    size_t total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        total = chip8_profiler_windows(&profilers[i], taken, windows, total);
+    } /* End of for loop */
+
+    /* Merge the windows running the same forms, then keep the hottest */
+    qsort(windows, total, sizeof(struct chip8_fusion_pattern), chip8_profiler_compare_ops);
+    size_t merged = 0;
+    for (size_t i = 0; i < total; i++)
+    {
+        if (merged && chip8_profiler_compare_ops(&windows[merged - 1], &windows[i]) == 0)
+        {
+            windows[merged - 1].count += windows[i].count;
+        }
+        else
+        {
+            windows[merged++] = windows[i];
+        } /* End of if statement */
+    } /* End of for loop */
+    qsort(windows, merged, sizeof(struct chip8_fusion_pattern), chip8_profiler_compare_counts);
+
+    for (size_t i = 0; i < merged && traces->count < max; i++)
+    {
+        traces->patterns[traces->count++] = windows[i];
+    } /* End of for loop */
+
+    free(taken);
+    free(windows);
+    return traces->count;
+} /* End of profiler traces function */
@@ -0,0 +1,113 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8publish.c */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "chip8publish.h"
+
+#define CHIP8_SUBSCRIBER_RETRIES 1000
+
+/* Creates (or takes over) the shared memory segment called name, which
+ * must start with a slash */
+int chip8_publisher_open(struct chip8_publisher* publisher, const char* name)
+{
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        return -1;
+    } /* End of if statement */
+
+    if (ftruncate(fd, sizeof(struct chip8_shared_frame)) != 0)
+    {
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    } /* End of if statement */
+
+    void* shared = mmap(NULL, sizeof(struct chip8_shared_frame), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shared == MAP_FAILED)
+    {
+        shm_unlink(name);
+        return -1;
+    } /* End of if statement */
+
+    publisher->shared = shared;
+    snprintf(publisher->name, sizeof(publisher->name), "%s", name);
+    memset(publisher->shared, 0, sizeof(struct chip8_shared_frame));
+    return 0;
+} /* End of publisher open function */
+
+void chip8_publisher_publish(struct chip8_publisher* publisher, const struct chip8* chip8, unsigned long long frame)
+{
+    struct chip8_shared_frame* shared = publisher->shared;
+    uint32_t sequence = atomic_load_explicit(&shared->sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&shared->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    chip8_frame_capture(&shared->data, chip8, frame);
+
+    atomic_store_explicit(&shared->sequence, sequence + 2, memory_order_release);
+} /* End of publisher publish function */
+
+void chip8_publisher_close(struct chip8_publisher* publisher)
+{
+    munmap(publisher->shared, sizeof(struct chip8_shared_frame));
+    shm_unlink(publisher->name);
+    publisher->shared = NULL;
+} /* End of publisher close function */
+
+int chip8_subscriber_open(struct chip8_subscriber* subscriber, const char* name)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return -1;
+    } /* End of if statement */
+
+    void* shared = mmap(NULL, sizeof(struct chip8_shared_frame), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shared == MAP_FAILED)
+    {
+        return -1;
+    } /* End of if statement */
+
+    subscriber->shared = shared;
+    return 0;
+} /* End of subscriber open function */
+
+/* Copies out a consistent frame. Gives up with -1 only if the publisher
+ * keeps writing over every attempt. */
+int chip8_subscriber_read(const struct chip8_subscriber* subscriber, struct chip8_frame* frame)
+{
+    const struct chip8_shared_frame* shared = subscriber->shared;
+    for (int attempt = 0; attempt < CHIP8_SUBSCRIBER_RETRIES; attempt++)
+    {
+        uint32_t before = atomic_load_explicit(&shared->sequence, memory_order_acquire);
+        if (before & 1)
+        {
+            continue;
+        } /* End of if statement */
+
+        memcpy(frame, &shared->data, sizeof(struct chip8_frame));
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&shared->sequence, memory_order_relaxed) == before)
+        {
+            return 0;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    return -1;
+} /* End of subscriber read function */
+
+void chip8_subscriber_close(struct chip8_subscriber* subscriber)
+{
+    munmap((void*) subscriber->shared, sizeof(struct chip8_shared_frame));
+    subscriber->shared = NULL;
+} /* End of subscriber close function */
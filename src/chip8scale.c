@@ -0,0 +1,242 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8scale.c */
+
+#include <string.h>
+
+#include "chip8scale.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/* One row at scale 1 : a byte per pixel from the two plane bytes that
+ * hold it */
+static void chip8_scale_expand_row(const unsigned char* plane0, const unsigned char* plane1, int width, const unsigned char lut[4], unsigned char* out)
+{
+    int x = 0;
+#ifdef __SSE2__
+    /* 16 pixels at a time : spread each source byte over 8 lanes, test
+     * one bit per lane, and pick the colour with the two plane masks */
+    const __m128i bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, (char) 128, 1, 2, 4, 8, 16, 32, 64, (char) 128);
+    const __m128i colour0 = _mm_set1_epi8(lut[0]);
+    const __m128i colour1 = _mm_set1_epi8(lut[1]);
+    const __m128i colour2 = _mm_set1_epi8(lut[2]);
+    const __m128i colour3 = _mm_set1_epi8(lut[3]);
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i p0 = _mm_cvtsi32_si128(plane0[x / 8] | plane0[x / 8 + 1] << 8);
+        __m128i p1 = _mm_cvtsi32_si128(plane1[x / 8] | plane1[x / 8 + 1] << 8);
+        p0 = _mm_unpacklo_epi8(p0, p0);
+        p1 = _mm_unpacklo_epi8(p1, p1);
+        p0 = _mm_unpacklo_epi16(p0, p0);
+        p1 = _mm_unpacklo_epi16(p1, p1);
+        p0 = _mm_unpacklo_epi32(p0, p0);
+        p1 = _mm_unpacklo_epi32(p1, p1);
+        __m128i m0 = _mm_cmpeq_epi8(_mm_and_si128(p0, bits), bits);
+        __m128i m1 = _mm_cmpeq_epi8(_mm_and_si128(p1, bits), bits);
+        __m128i low = _mm_or_si128(_mm_andnot_si128(m0, colour0), _mm_and_si128(m0, colour1));
+        __m128i high = _mm_or_si128(_mm_andnot_si128(m0, colour2), _mm_and_si128(m0, colour3));
+        __m128i v = _mm_or_si128(_mm_andnot_si128(m1, low), _mm_and_si128(m1, high));
+        _mm_storeu_si128((__m128i*) (out + x), v);
+    } /* End of for loop */
+#endif
+    for (; x < width; x++)
+    {
+        int shift = 7 - x % 8;
+        out[x] = lut[((plane0[x / 8] >> shift) & 1) | ((plane1[x / 8] >> shift) & 1) << 1];
+    } /* End of for loop */
+} /* End of scale expand row function */
+
+void chip8_scale_indexed(const struct chip8_frame* frame, const unsigned char lut[4], int scale, unsigned char* out)
+{
+    int width = frame->width;
+    int stride = width / 8;
+    int out_width = width * scale;
+    unsigned char line[CHIP8_HIRES_WIDTH];
+
+    for (int y = 0; y < frame->height; y++)
+    {
+        unsigned char* row = out + (size_t) y * scale * out_width;
+        if (scale == 1)
+        {
+            chip8_scale_expand_row(frame->pixels[0] + y * stride, frame->pixels[1] + y * stride, width, lut, row);
+            continue;
+        } /* End of if statement */
+
+        chip8_scale_expand_row(frame->pixels[0] + y * stride, frame->pixels[1] + y * stride, width, lut, line);
+        for (int x = 0; x < width; x++)
+        {
+            memset(row + x * scale, line[x], scale);
+        } /* End of for loop */
+        for (int copy = 1; copy < scale; copy++)
+        {
+            memcpy(row + copy * out_width, row, out_width);
+        } /* End of for loop */
+    } /* End of for loop */
+} /* End of scale indexed function */
+
+/* One row at scale 1 in 32-bit colours */
+static void chip8_scale_expand_rgba(const unsigned char* plane0, const unsigned char* plane1, int width, const uint32_t palette[4], uint32_t* out)
+{
+    int x = 0;
+#ifdef __AVX2__
+    /* 8 pixels, one source byte per plane, at a time : the two plane
+     * bits of each lane pick one of the four palette entries with a byte
+     * shuffle, the whole palette fitting in one 128-bit lane */
+    const __m256i bits = _mm256_setr_epi32(128, 64, 32, 16, 8, 4, 2, 1);
+    const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) palette));
+    const __m256i bytes = _mm256_set1_epi32(0x03020100);
+    const __m256i select0 = _mm256_set1_epi32(0x04040404);
+    const __m256i select1 = _mm256_set1_epi32(0x08080808);
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256i m0 = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(plane0[x / 8]), bits), bits);
+        __m256i m1 = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(plane1[x / 8]), bits), bits);
+        __m256i control = _mm256_or_si256(bytes, _mm256_or_si256(_mm256_and_si256(m0, select0), _mm256_and_si256(m1, select1)));
+        _mm256_storeu_si256((__m256i*) (out + x), _mm256_shuffle_epi8(table, control));
+    } /* End of for loop */
+#endif
+#ifdef __SSE2__
+    /* 4 pixels, half a source byte, at a time, picking the colour with
+     * the two plane masks */
+    const __m128i bits_high = _mm_setr_epi32(128, 64, 32, 16);
+    const __m128i bits_low = _mm_setr_epi32(8, 4, 2, 1);
+    const __m128i colour0 = _mm_set1_epi32(palette[0]);
+    const __m128i colour1 = _mm_set1_epi32(palette[1]);
+    const __m128i colour2 = _mm_set1_epi32(palette[2]);
+    const __m128i colour3 = _mm_set1_epi32(palette[3]);
+    for (; x + 4 <= width; x += 4)
+    {
+        const __m128i bits = x % 8 ? bits_low : bits_high;
+        __m128i m0 = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(plane0[x / 8]), bits), bits);
+        __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(plane1[x / 8]), bits), bits);
+        __m128i low = _mm_or_si128(_mm_andnot_si128(m0, colour0), _mm_and_si128(m0, colour1));
+        __m128i high = _mm_or_si128(_mm_andnot_si128(m0, colour2), _mm_and_si128(m0, colour3));
+        _mm_storeu_si128((__m128i*) (out + x), _mm_or_si128(_mm_andnot_si128(m1, low), _mm_and_si128(m1, high)));
+    } /* End of for loop */
+#endif
+    for (; x < width; x++)
+    {
+        int shift = 7 - x % 8;
+        out[x] = palette[((plane0[x / 8] >> shift) & 1) | ((plane1[x / 8] >> shift) & 1) << 1];
+    } /* End of for loop */
+} /* End of scale expand rgba function */
+
+/* Widens a row of width pixels scale times by nearest neighbour */
+static void chip8_scale_widen_rgba(const uint32_t* line, int width, int scale, uint32_t* out)
+{
+    int out_width = width * scale;
+    int x = 0;
+#ifdef __AVX2__
+    /* Each block of 8 output pixels comes from at most 8 neighbouring
+     * source pixels, so it is one load and one lane permute. The
+     * permutes repeat every scale blocks. */
+    __m256i permutes[CHIP8_SCALE_MAX];
+    for (int block = 0; block < scale; block++)
+    {
+        int base = block * 8 / scale;
+        int lanes[8];
+        for (int i = 0; i < 8; i++)
+        {
+            lanes[i] = (block * 8 + i) / scale - base;
+        } /* End of nested for loop */
+        permutes[block] = _mm256_loadu_si256((const __m256i*) lanes);
+    } /* End of for loop */
+    for (int block = 0; x + 8 <= out_width; x += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (line + x / scale));
+        _mm256_storeu_si256((__m256i*) (out + x), _mm256_permutevar8x32_epi32(v, permutes[block]));
+        block = block + 1 == scale ? 0 : block + 1;
+    } /* End of for loop */
+#endif
+#ifdef __SSE2__
+    if (scale == 1)
+    {
+        memcpy(out + x, line + x, (out_width - x) * sizeof(uint32_t));
+        return;
+    } /* End of if statement */
+
+    if (scale == 2)
+    {
+        for (; x + 8 <= out_width; x += 8)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*) (line + x / 2));
+            _mm_storeu_si128((__m128i*) (out + x), _mm_unpacklo_epi32(v, v));
+            _mm_storeu_si128((__m128i*) (out + x + 4), _mm_unpackhi_epi32(v, v));
+        } /* End of for loop */
+    } /* End of if statement */
+
+    /* Broadcast each pixel and store it in steps of 4. A step that runs
+     * past the pixel's span is overwritten by the next pixel, so only
+     * the last pixel of the row needs the scalar loop. */
+    for (; x + scale < out_width; x += scale)
+    {
+        __m128i v = _mm_set1_epi32(line[x / scale]);
+        for (int i = 0; i < scale; i += 4)
+        {
+            _mm_storeu_si128((__m128i*) (out + x + i), v);
+        } /* End of nested for loop */
+    } /* End of for loop */
+#endif
+    for (; x < out_width; x++)
+    {
+        out[x] = line[x / scale];
+    } /* End of for loop */
+} /* End of scale widen rgba function */
+
+void chip8_scale_rgba(const struct chip8_frame* frame, const uint32_t palette[4], int scale, uint32_t* out, size_t pitch)
+{
+    int width = frame->width;
+    int stride = width / 8;
+    size_t row_bytes = (size_t) width * scale * sizeof(uint32_t);
+    /* Room for the 8-pixel loads past the end of the row when widening */
+    uint32_t line[CHIP8_HIRES_WIDTH + 8];
+
+    for (int y = 0; y < frame->height; y++)
+    {
+        uint32_t* row = (uint32_t*) ((unsigned char*) out + (size_t) y * scale * pitch);
+        if (scale == 1)
+        {
+            chip8_scale_expand_rgba(frame->pixels[0] + y * stride, frame->pixels[1] + y * stride, width, palette, row);
+            continue;
+        } /* End of if statement */
+        chip8_scale_expand_rgba(frame->pixels[0] + y * stride, frame->pixels[1] + y * stride, width, palette, line);
+        chip8_scale_widen_rgba(line, width, scale, row);
+        for (int copy = 1; copy < scale; copy++)
+        {
+            memcpy((unsigned char*) row + copy * pitch, row, row_bytes);
+        } /* End of for loop */
+    } /* End of for loop */
+} /* End of scale rgba function */
+
+/* Each nibble of a byte ORed down to 2 bits, adjacent pixel pairs
+ * merged */
+static unsigned char chip8_scale_pair(unsigned char b)
+{
+    b |= b << 1;
+    return (b >> 7 & 1) << 3 | (b >> 5 & 1) << 2 | (b >> 3 & 1) << 1 | (b >> 1 & 1);
+} /* End of scale pair function */
+
+void chip8_scale_halve(const struct chip8_frame* frame, struct chip8_frame* out)
+{
+    int stride = frame->width / 8;
+    out->width = frame->width / 2;
+    out->height = frame->height / 2;
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        const unsigned char* in = frame->pixels[plane];
+        unsigned char* row = out->pixels[plane];
+        for (int y = 0; y < out->height; y++, in += 2 * stride, row += stride / 2)
+        {
+            for (int x = 0; x < stride / 2; x++)
+            {
+                unsigned char high = in[2 * x] | in[stride + 2 * x];
+                unsigned char low = in[2 * x + 1] | in[stride + 2 * x + 1];
+                row[x] = chip8_scale_pair(high) << 4 | chip8_scale_pair(low);
+            } /* End of nested for loop */
+        } /* End of for loop */
+    } /* End of for loop */
+} /* End of scale halve function */
@@ -0,0 +1,155 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8scheduler.c */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "chip8scheduler.h"
+
+/* Returns -1 if the heap cannot be allocated. handler may be NULL when
+ * only key events are scheduled. */
+int chip8_scheduler_init(struct chip8_scheduler* scheduler, size_t capacity, chip8_event_handler handler, void* context)
+{
+    scheduler->heap = malloc(sizeof(struct chip8_event) * (capacity ? capacity : 1));
+    if (!scheduler->heap)
+    {
+        return -1;
+    } /* End of if statement */
+
+    scheduler->count = 0;
+    scheduler->capacity = capacity;
+    scheduler->order = 0;
+    scheduler->handler = handler;
+    scheduler->context = context;
+    return 0;
+} /* End of scheduler init function */
+
+void chip8_scheduler_free(struct chip8_scheduler* scheduler)
+{
+    free(scheduler->heap);
+    scheduler->heap = NULL;
+    scheduler->count = 0;
+    scheduler->capacity = 0;
+} /* End of scheduler free function */
+
+void chip8_scheduler_clear(struct chip8_scheduler* scheduler)
+{
+    scheduler->count = 0;
+} /* End of scheduler clear function */
+
+static bool chip8_event_before(const struct chip8_event* a, const struct chip8_event* b)
+{
+    return a->cycle < b->cycle || (a->cycle == b->cycle && a->order < b->order);
+} /* End of event before function */
+
+static void chip8_scheduler_insert(struct chip8_scheduler* scheduler, struct chip8_event event)
+{
+    size_t i = scheduler->count++;
+    while (i > 0 && chip8_event_before(&event, &scheduler->heap[(i - 1) / 2]))
+    {
+        scheduler->heap[i] = scheduler->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    } /* End of while loop */
+    scheduler->heap[i] = event;
+} /* End of scheduler insert function */
+
+static struct chip8_event chip8_scheduler_pop(struct chip8_scheduler* scheduler)
+{
+    struct chip8_event top = scheduler->heap[0];
+    struct chip8_event last = scheduler->heap[--scheduler->count];
+    size_t i = 0;
+    for (;;)
+    {
+        size_t child = 2 * i + 1;
+        if (child >= scheduler->count)
+        {
+            break;
+        } /* End of if statement */
+        if (child + 1 < scheduler->count && chip8_event_before(&scheduler->heap[child + 1], &scheduler->heap[child]))
+        {
+            child++;
+        } /* End of if statement */
+        if (!chip8_event_before(&scheduler->heap[child], &last))
+        {
+            break;
+        } /* End of if statement */
+        scheduler->heap[i] = scheduler->heap[child];
+        i = child;
+    } /* End of for loop */
+    if (scheduler->count > 0)
+    {
+        scheduler->heap[i] = last;
+    } /* End of if statement */
+    return top;
+} /* End of scheduler pop function */
+
+/* Returns -1 if the queue is full */
+int chip8_scheduler_push(struct chip8_scheduler* scheduler, unsigned long long cycle, unsigned long long period,
+        enum chip8_event_type type, int key)
+{
+    if (scheduler->count == scheduler->capacity)
+    {
+        return -1;
+    } /* End of if statement */
+
+    struct chip8_event event = { cycle, period, scheduler->order++, type, key };
+    chip8_scheduler_insert(scheduler, event);
+    return 0;
+} /* End of scheduler push function */
+
+/* Runs the core until it has executed up to cycle until, faults, or a
+ * handler asks to stop. Events due at or before the current cycle are
+ * dispatched first, then the core runs straight to whichever comes
+ * sooner of the next event and until. Returns the handler's non-zero
+ * value if one stopped the run, or 0. */
+int chip8_scheduler_run(struct chip8_scheduler* scheduler, struct chip8* chip8, unsigned long long until)
+{
+    while (chip8->cycles < until && chip8->fault == CHIP8_FAULT_NONE)
+    {
+        while (scheduler->count > 0 && scheduler->heap[0].cycle <= chip8->cycles)
+        {
+            struct chip8_event event = chip8_scheduler_pop(scheduler);
+            if (event.period)
+            {
+                struct chip8_event again = event;
+                again.cycle += event.period;
+                again.order = scheduler->order++;
+                chip8_scheduler_insert(scheduler, again);
+            } /* End of if statement */
+
+            int result = 0;
+            switch (event.type)
+            {
+                case CHIP8_EVENT_KEY_DOWN:
+                    chip8_keyboard_down(&chip8->keyboard, event.key);
+                    break;
+
+                case CHIP8_EVENT_KEY_UP:
+                    chip8_keyboard_up(&chip8->keyboard, event.key);
+                    break;
+
+                case CHIP8_EVENT_FRAME:
+                case CHIP8_EVENT_CHECKPOINT:
+                    if (scheduler->handler)
+                    {
+                        result = scheduler->handler(scheduler->context, chip8, &event);
+                    } /* End of if statement */
+                    break;
+            } /* End of switch statement */
+            if (result)
+            {
+                return result;
+            } /* End of if statement */
+        } /* End of while loop */
+
+        unsigned long long stop = until;
+        if (scheduler->count > 0 && scheduler->heap[0].cycle < stop)
+        {
+            stop = scheduler->heap[0].cycle;
+        } /* End of if statement */
+        unsigned long long chunk = stop - chip8->cycles;
+        chip8->profile->run(chip8, chunk > INT_MAX ? INT_MAX : (int) chunk);
+    } /* End of while loop */
+    return 0;
+} /* End of scheduler run function */
@@ -5,46 +5,390 @@
 #include <memory.h>
 #include "chip8screen.h"
 
-static void chip8_screen_check_bounds(int x, int y)
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+static void chip8_screen_check_bounds(const struct chip8_screen* screen, int x, int y)
 {
-    assert(x >= 0 && x < CHIP8_WIDTH && y >= 0 && y < CHIP8_HEIGHT);
+    assert(x >= 0 && x < chip8_screen_width(screen) && y >= 0 && y < chip8_screen_height(screen));
 } /* End check bounds function */
 
+/* Mask with a bit set for every row in the current mode */
+static unsigned long long chip8_screen_all_rows(const struct chip8_screen* screen)
+{
+    int height = chip8_screen_height(screen);
+    return height == 64 ? ~0ULL : (1ULL << height) - 1;
+} /* End of all rows function */
+
+/* A cleared lo-res screen drawing into plane 0 */
+void chip8_screen_init(struct chip8_screen* screen)
+{
+    memset(screen, 0, sizeof(struct chip8_screen));
+    screen->planes = 1;
+} /* End of screen init function */
+
+/* 00E0 : Clears the selected planes */
 void chip8_screen_clear(struct chip8_screen* screen)
 {
-    memset(screen->pixels, 0, sizeof(screen->pixels));
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        if (screen->planes & (1 << plane))
+        {
+            memset(screen->rows[plane], 0, sizeof(screen->rows[plane]));
+        } /* End of if statement */
+    } /* End of for loop */
+    screen->dirty_rows = chip8_screen_all_rows(screen);
 } /* End of screen clear function */
 
+/* 00FE / 00FF : switching resolution clears every plane */
+void chip8_screen_set_hires(struct chip8_screen* screen, bool hires)
+{
+    screen->hires = hires;
+    memset(screen->rows, 0, sizeof(screen->rows));
+    screen->dirty_rows = chip8_screen_all_rows(screen);
+} /* End of set hires function */
+
+/* Fn01 : Selects the planes later instructions draw to */
+void chip8_screen_select_planes(struct chip8_screen* screen, int planes)
+{
+    screen->planes = planes & ((1 << CHIP8_SCREEN_PLANES) - 1);
+} /* End of select planes function */
+
+/* Sets the pixel in every selected plane */
 void chip8_screen_set(struct chip8_screen* screen, int x, int y)
 {
-    chip8_screen_check_bounds(x, y);
-    screen->pixels[y][x] = true;
+    chip8_screen_check_bounds(screen, x, y);
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        if (screen->planes & (1 << plane))
+        {
+            screen->rows[plane][y][x / 64] |= 1ULL << (63 - x % 64);
+        } /* End of if statement */
+    } /* End of for loop */
+    screen->dirty_rows |= 1ULL << y;
 } /* End screen set function */
 
-bool chip8_screen_is_set(struct chip8_screen* screen, int x, int y)
+/* Colour of a pixel, one bit per plane */
+int chip8_screen_pixel(const struct chip8_screen* screen, int x, int y)
 {
-    chip8_screen_check_bounds(x, y);
-    return screen->pixels[y][x];
+    chip8_screen_check_bounds(screen, x, y);
+    int colour = 0;
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        colour |= ((screen->rows[plane][y][x / 64] >> (63 - x % 64)) & 1) << plane;
+    } /* End of for loop */
+    return colour;
+} /* End of screen pixel function */
+
+bool chip8_screen_is_set(const struct chip8_screen* screen, int x, int y)
+{
+    return chip8_screen_pixel(screen, x, y) != 0;
 } /* End screen is set function */
 
-bool chip8_screen_draw_sprite(struct chip8_screen* screen, int x, int y, const char* sprite, int num)
+/* Where the columns of a sprite land, worked out once per sprite. The
+ * sprite row is held left aligned in a word, MSB first; screen word w
+ * receives it shifted right by right[w] and, for the part that runs
+ * across a word boundary or wraps round the right edge, shifted left by
+ * left[w]. A mask of zero switches a contribution off, so the per-row
+ * work is the same shifts whatever the placement. */
+struct chip8_sprite_columns
 {
-    bool pixel_collison = false;
+    int words;
+    int right[CHIP8_SCREEN_ROW_WORDS];
+    int left[CHIP8_SCREEN_ROW_WORDS];
+    unsigned long long right_mask[CHIP8_SCREEN_ROW_WORDS];
+    unsigned long long left_mask[CHIP8_SCREEN_ROW_WORDS];
+}; /* End chip8 sprite columns struct */
 
-    for (int ly = 0; ly < num; ly++)
+/* x is already on the screen. Word w starts at column 64*w, so the
+ * sprite sits at offset x - 64*w in it and, when wrapping, also at
+ * x - 64*w - width. A non negative offset below 64 is a right shift and
+ * a negative one above -64 a left shift; anything else misses the word.
+ * A sprite is at most 16 pixels wide, so each word gets at most one of
+ * each. */
+static void chip8_sprite_columns(struct chip8_sprite_columns* columns, int x, int width, bool clip)
+{
+    columns->words = width / 64;
+    for (int w = 0; w < columns->words; w++)
     {
-        char c = sprite[ly];
-        for (int lx = 0; lx < 8; lx++)
+        columns->right[w] = 0;
+        columns->left[w] = 0;
+        columns->right_mask[w] = 0;
+        columns->left_mask[w] = 0;
+        for (int pass = 0; pass < (clip ? 1 : 2); pass++)
         {
-            if ((c & (0b10000000 >> lx)) == 0)
+            int offset = x - 64 * w - pass * width;
+            if (offset >= 0 && offset < 64)
             {
-                continue;
-            } /* End of if statement */
-            if (screen->pixels[(ly+y) % CHIP8_HEIGHT][(lx+x) % CHIP8_WIDTH])
+                columns->right[w] = offset;
+                columns->right_mask[w] = ~0ULL;
+            }
+            else if (offset < 0 && offset > -64)
             {
-                pixel_collison = true;
-            } /* End of if statement */
-            screen->pixels[(ly+y) % CHIP8_HEIGHT][(lx+x) % CHIP8_WIDTH] ^= true;
+                columns->left[w] = -offset;
+                columns->left_mask[w] = ~0ULL;
+            } /* End of if else statement */
         } /* End of nested for loop */
     } /* End of for loop */
+} /* End of chip8 sprite columns function */
+
+/* XORs count sprite rows onto consecutive screen rows starting at y,
+ * which the caller has already split at the bottom edge. wide sprites
+ * hold two big endian bytes per row. Returns true on collision. */
+static inline bool chip8_screen_xor_rows(struct chip8_screen* screen, int plane, const struct chip8_sprite_columns* columns, int y, const char* sprite, int count, bool wide)
+{
+    unsigned long long (*rows)[CHIP8_SCREEN_ROW_WORDS] = &screen->rows[plane][y];
+    unsigned long long dirty = 0;
+    bool collision = false;
+
+    for (int ly = 0; ly < count; ly++)
+    {
+        unsigned long long bits = wide ?
+            ((unsigned long long) (unsigned char) sprite[ly*2] << 8 | (unsigned char) sprite[ly*2+1]) << 48 :
+            (unsigned long long) (unsigned char) sprite[ly] << 56;
+        if (bits == 0)
+        {
+            continue;
+        } /* End of if statement */
+        dirty |= 1ULL << ly;
+        for (int w = 0; w < columns->words; w++)
+        {
+            unsigned long long mask = (bits >> columns->right[w] & columns->right_mask[w]) |
+                                      (bits << columns->left[w] & columns->left_mask[w]);
+            collision |= (rows[ly][w] & mask) != 0;
+            rows[ly][w] ^= mask;
+        } /* End of nested for loop */
+    } /* End of for loop */
+
+    screen->dirty_rows |= dirty << y;
+    return collision;
+} /* End of xor rows function */
+
+/* Places a sprite of num rows at (x, y) : the origin always wraps onto
+ * the screen, the columns are worked out once, and the rows are split
+ * at the bottom edge into a run from y down and, when wrapping, a run
+ * continuing from the top. clip drops that second run and the columns
+ * past the right edge. */
+static bool chip8_screen_place(struct chip8_screen* screen, int x, int y, const char* sprite, int num, bool clip, bool wide)
+{
+    int width = chip8_screen_width(screen);
+    int height = chip8_screen_height(screen);
+    bool pixel_collison = false;
+    struct chip8_sprite_columns columns;
+
+    /* Both dimensions are powers of two */
+    x &= width - 1;
+    y &= height - 1;
+    chip8_sprite_columns(&columns, x, width, clip);
+
+    int below = height - y;
+    int first = num < below ? num : below;
+    int rest = clip ? 0 : num - first;
+    int stride = wide ? 2 : 1;
+
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        if (!(screen->planes & (1 << plane)))
+        {
+            continue;
+        } /* End of if statement */
+        pixel_collison |= chip8_screen_xor_rows(screen, plane, &columns, y, sprite, first, wide);
+        if (rest)
+        {
+            pixel_collison |= chip8_screen_xor_rows(screen, plane, &columns, 0, sprite + first * stride, rest, wide);
+        } /* End of if statement */
+        sprite += num * stride;
+    } /* End of for loop */
+
+    return pixel_collison;
+} /* End of place function */
+
+/* Draws num bytes of sprite into each selected plane in turn, so the
+ * sprite holds num bytes per selected plane. The sprite's origin always
+ * wraps onto the screen; clip decides whether the rest of the sprite
+ * wraps too or is cut off at the right and bottom edges. */
+bool chip8_screen_draw_sprite(struct chip8_screen* screen, int x, int y, const char* sprite, int num, bool clip)
+{
+    return chip8_screen_place(screen, x, y, sprite, num, clip, false);
 } /* End draw sprite */
+
+/* Dxy0 in hi-res mode : a 16x16 sprite stored as 16 big endian rows,
+ * 32 bytes per selected plane */
+bool chip8_screen_draw_sprite16(struct chip8_screen* screen, int x, int y, const char* sprite, bool clip)
+{
+    return chip8_screen_place(screen, x, y, sprite, 16, clip, true);
+} /* End draw sprite 16 function */
+
+/* 00Cn : Scroll the selected planes down num rows, shifting whole rows
+ * and clearing the top */
+void chip8_screen_scroll_down(struct chip8_screen* screen, int num)
+{
+    int height = chip8_screen_height(screen);
+    if (num > height)
+    {
+        num = height;
+    } /* End of if statement */
+
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        if (screen->planes & (1 << plane))
+        {
+            unsigned long long (*rows)[CHIP8_SCREEN_ROW_WORDS] = screen->rows[plane];
+            memmove(rows[num], rows[0], (height - num) * sizeof(rows[0]));
+            memset(rows[0], 0, num * sizeof(rows[0]));
+        } /* End of if statement */
+    } /* End of for loop */
+    screen->dirty_rows |= chip8_screen_all_rows(screen);
+} /* End of scroll down function */
+
+/* 00Dn : Scroll the selected planes up num rows, shifting whole rows
+ * and clearing the bottom */
+void chip8_screen_scroll_up(struct chip8_screen* screen, int num)
+{
+    int height = chip8_screen_height(screen);
+    if (num > height)
+    {
+        num = height;
+    } /* End of if statement */
+
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        if (screen->planes & (1 << plane))
+        {
+            unsigned long long (*rows)[CHIP8_SCREEN_ROW_WORDS] = screen->rows[plane];
+            memmove(rows[0], rows[num], (height - num) * sizeof(rows[0]));
+            memset(rows[height - num], 0, num * sizeof(rows[0]));
+        } /* End of if statement */
+    } /* End of for loop */
+    screen->dirty_rows |= chip8_screen_all_rows(screen);
+} /* End of scroll up function */
+
+/* In hi-res mode each row is a 128-bit value; the SIMD paths shift both
+ * words of a row at once and carry the four bits crossing the word
+ * boundary with a byte shift across lanes. AVX2 does two rows per
+ * instruction. */
+static void chip8_screen_shift_right(unsigned long long (*rows)[CHIP8_SCREEN_ROW_WORDS], int height, bool hires)
+{
+    int y = 0;
+    if (!hires)
+    {
+        for (; y < height; y++)
+        {
+            rows[y][0] >>= 4;
+        } /* End of for loop */
+        return;
+    } /* End of if statement */
+
+#ifdef __AVX2__
+    for (; y + 2 <= height; y += 2)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*) rows[y]);
+        __m256i carry = _mm256_slli_si256(_mm256_slli_epi64(v, 60), 8);
+        _mm256_storeu_si256((__m256i*) rows[y], _mm256_or_si256(_mm256_srli_epi64(v, 4), carry));
+    } /* End of for loop */
+#endif
+#ifdef __SSE2__
+    for (; y < height; y++)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) rows[y]);
+        __m128i carry = _mm_slli_si128(_mm_slli_epi64(v, 60), 8);
+        _mm_storeu_si128((__m128i*) rows[y], _mm_or_si128(_mm_srli_epi64(v, 4), carry));
+    } /* End of for loop */
+#endif
+    for (; y < height; y++)
+    {
+        rows[y][1] = rows[y][1] >> 4 | rows[y][0] << 60;
+        rows[y][0] >>= 4;
+    } /* End of for loop */
+} /* End of shift right function */
+
+static void chip8_screen_shift_left(unsigned long long (*rows)[CHIP8_SCREEN_ROW_WORDS], int height, bool hires)
+{
+    int y = 0;
+    if (!hires)
+    {
+        for (; y < height; y++)
+        {
+            rows[y][0] <<= 4;
+        } /* End of for loop */
+        return;
+    } /* End of if statement */
+
+#ifdef __AVX2__
+    for (; y + 2 <= height; y += 2)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*) rows[y]);
+        __m256i carry = _mm256_srli_si256(_mm256_srli_epi64(v, 60), 8);
+        _mm256_storeu_si256((__m256i*) rows[y], _mm256_or_si256(_mm256_slli_epi64(v, 4), carry));
+    } /* End of for loop */
+#endif
+#ifdef __SSE2__
+    for (; y < height; y++)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) rows[y]);
+        __m128i carry = _mm_srli_si128(_mm_srli_epi64(v, 60), 8);
+        _mm_storeu_si128((__m128i*) rows[y], _mm_or_si128(_mm_slli_epi64(v, 4), carry));
+    } /* End of for loop */
+#endif
+    for (; y < height; y++)
+    {
+        rows[y][0] = rows[y][0] << 4 | rows[y][1] >> 60;
+        rows[y][1] <<= 4;
+    } /* End of for loop */
+} /* End of shift left function */
+
+/* 00FB : Scroll the selected planes right four pixels */
+void chip8_screen_scroll_right(struct chip8_screen* screen)
+{
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        if (screen->planes & (1 << plane))
+        {
+            chip8_screen_shift_right(screen->rows[plane], chip8_screen_height(screen), screen->hires);
+        } /* End of if statement */
+    } /* End of for loop */
+    screen->dirty_rows |= chip8_screen_all_rows(screen);
+} /* End of scroll right function */
+
+/* 00FC : Scroll the selected planes left four pixels */
+void chip8_screen_scroll_left(struct chip8_screen* screen)
+{
+    for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+    {
+        if (screen->planes & (1 << plane))
+        {
+            chip8_screen_shift_left(screen->rows[plane], chip8_screen_height(screen), screen->hires);
+        } /* End of if statement */
+    } /* End of for loop */
+    screen->dirty_rows |= chip8_screen_all_rows(screen);
+} /* End of scroll left function */
+
+unsigned long long chip8_screen_take_dirty_rows(struct chip8_screen* screen)
+{
+    unsigned long long rows = screen->dirty_rows;
+    screen->dirty_rows = 0;
+    return rows;
+} /* End of take dirty rows function */
+
+/* Writes the rows of one plane in the current mode out as big endian
+ * bytes */
+void chip8_screen_pack(const struct chip8_screen* screen, int plane, unsigned char* out)
+{
+    int words = chip8_screen_width(screen) / 64;
+    int height = chip8_screen_height(screen);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int w = 0; w < words; w++)
+        {
+            for (int shift = 56; shift >= 0; shift -= 8)
+            {
+                *out++ = screen->rows[plane][y][w] >> shift;
+            } /* End of nested for loop */
+        } /* End of nested for loop */
+    } /* End of for loop */
+} /* End of screen pack function */
@@ -0,0 +1,110 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8script.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8script.h"
+#include "chip8.h"
+#include "chip8scheduler.h"
+
+int chip8_script_load(struct chip8_script* script, const char* filename)
+{
+    memset(script, 0, sizeof(struct chip8_script));
+
+    FILE* f = fopen(filename, "r");
+    if (!f)
+    {
+        return -1;
+    } /* End of if statement */
+
+    size_t capacity = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned long frame;
+        int key;
+        char state[8];
+        if (line[0] == '#' || strspn(line, " \t\r\n") == strlen(line))
+        {
+            continue;
+        } /* End of if statement */
+
+        if (sscanf(line, "%lu %x %7s", &frame, &key, state) != 3
+                || key < 0 || key >= CHIP8_TOTAL_KEYS
+                || (strcmp(state, "down") != 0 && strcmp(state, "up") != 0)
+                || (script->count > 0 && frame < script->events[script->count-1].frame))
+        {
+            fclose(f);
+            chip8_script_free(script);
+            return -1;
+        } /* End of if statement */
+
+        if (script->count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            struct chip8_script_event* events = realloc(script->events, capacity * sizeof(struct chip8_script_event));
+            if (!events)
+            {
+                fclose(f);
+                chip8_script_free(script);
+                return -1;
+            } /* End of nested if statement */
+            script->events = events;
+        } /* End of if statement */
+
+        struct chip8_script_event* event = &script->events[script->count++];
+        event->frame = frame;
+        event->key = key;
+        event->down = strcmp(state, "down") == 0;
+    } /* End of while loop */
+
+    fclose(f);
+    return 0;
+} /* End of script load function */
+
+void chip8_script_free(struct chip8_script* script)
+{
+    free(script->events);
+    memset(script, 0, sizeof(struct chip8_script));
+} /* End of script free function */
+
+void chip8_script_rewind(struct chip8_script* script)
+{
+    script->next = 0;
+} /* End of script rewind function */
+
+/* Applies every event scheduled at or before frame */
+void chip8_script_apply(struct chip8_script* script, struct chip8* chip8, unsigned long frame)
+{
+    while (script->next < script->count && script->events[script->next].frame <= frame)
+    {
+        struct chip8_script_event* event = &script->events[script->next++];
+        if (event->down)
+        {
+            chip8_keyboard_down(&chip8->keyboard, event->key);
+        }
+        else
+        {
+            chip8_keyboard_up(&chip8->keyboard, event->key);
+        } /* End of if statement */
+    } /* End of while loop */
+} /* End of script apply function */
+
+/* Queues every event as a key event at the start of its frame, which
+ * is where chip8_script_apply would apply it. Returns -1 if the
+ * scheduler has no room for them all. */
+int chip8_script_schedule(const struct chip8_script* script, struct chip8_scheduler* scheduler)
+{
+    for (size_t i = 0; i < script->count; i++)
+    {
+        const struct chip8_script_event* event = &script->events[i];
+        if (chip8_scheduler_push(scheduler, (unsigned long long) event->frame * CHIP8_CYCLES_PER_FRAME, 0,
+                event->down ? CHIP8_EVENT_KEY_DOWN : CHIP8_EVENT_KEY_UP, event->key) != 0)
+        {
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+    return 0;
+} /* End of script schedule function */
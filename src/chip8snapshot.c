@@ -0,0 +1,74 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8snapshot.c */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+#include "chip8snapshot.h"
+
+/* Everything after the memory array is small enough to copy whole */
+#define CHIP8_SNAPSHOT_TAIL offsetof(struct chip8, stack)
+
+_Static_assert(offsetof(struct chip8, memory) == 0, "memory must be the first member of struct chip8");
+
+/* Checkpoint ids, unique across every instance in the process */
+static atomic_ullong chip8_snapshot_checkpoints;
+
+/* Copies src's memory into dst, just the pages marked in dirty if dirty
+ * is non-NULL, then the rest of the state */
+static void chip8_snapshot_copy(struct chip8* dst, const struct chip8* src, const unsigned long long* dirty)
+{
+    if (!dirty)
+    {
+        memcpy(dst->memory.memory, src->memory.memory, sizeof(dst->memory.memory));
+    } /* End of if statement */
+    for (int word = 0; dirty && word < CHIP8_MEMORY_DIRTY_WORDS; word++)
+    {
+        unsigned long long pages = dirty[word];
+        while (pages)
+        {
+            int page = word * 64 + __builtin_ctzll(pages);
+            pages &= pages - 1;
+            memcpy(&dst->memory.memory[page << CHIP8_MEMORY_PAGE_SHIFT],
+                    &src->memory.memory[page << CHIP8_MEMORY_PAGE_SHIFT], CHIP8_MEMORY_PAGE_SIZE);
+        } /* End of while loop */
+    } /* End of for loop */
+
+    dst->memory.fault = src->memory.fault;
+    memcpy((char*) dst + CHIP8_SNAPSHOT_TAIL, (const char*) src + CHIP8_SNAPSHOT_TAIL,
+            sizeof(struct chip8) - CHIP8_SNAPSHOT_TAIL);
+} /* End of snapshot copy function */
+
+/* Makes the snapshot the instance's latest checkpoint */
+static void chip8_snapshot_checkpoint(struct chip8_snapshot* snapshot, struct chip8* chip8)
+{
+    snapshot->checkpoint = atomic_fetch_add(&chip8_snapshot_checkpoints, 1) + 1;
+    chip8->memory.checkpoint = snapshot->checkpoint;
+    chip8_memory_clear_dirty(&chip8->memory);
+} /* End of snapshot checkpoint function */
+
+void chip8_snapshot_take(struct chip8_snapshot* snapshot, struct chip8* chip8)
+{
+    chip8_snapshot_checkpoint(snapshot, chip8);
+    snapshot->state = *chip8;
+    snapshot->state.trace = NULL;
+} /* End of snapshot take function */
+
+void chip8_snapshot_update(struct chip8_snapshot* snapshot, struct chip8* chip8)
+{
+    bool latest = chip8->memory.checkpoint == snapshot->checkpoint;
+    chip8_snapshot_copy(&snapshot->state, chip8, latest ? chip8->memory.dirty : NULL);
+    snapshot->state.trace = NULL;
+    chip8_snapshot_checkpoint(snapshot, chip8);
+} /* End of snapshot update function */
+
+/* Restoring a snapshot makes it the instance's latest checkpoint again */
+void chip8_snapshot_restore(const struct chip8_snapshot* snapshot, struct chip8* chip8)
+{
+    struct chip8_trace* trace = chip8->trace;
+    bool latest = chip8->memory.checkpoint == snapshot->checkpoint;
+    chip8_snapshot_copy(chip8, &snapshot->state, latest ? chip8->memory.dirty : NULL);
+    chip8->memory.checkpoint = snapshot->checkpoint;
+    chip8_memory_clear_dirty(&chip8->memory);
+    chip8->trace = trace;
+} /* End of snapshot restore function */
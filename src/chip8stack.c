@@ -3,24 +3,28 @@
 
 #include "chip8stack.h"
 #include "chip8.h"
-#include <assert.h>
-
-static void chip8_stack_in_bounds(struct chip8* chip8)
-{
-    assert(chip8->registers.SP < sizeof(chip8->stack.stack));
-} /* End static void function */
 
+/* SP counts the entries, so SP == 0 is an empty stack and all
+ * CHIP8_TOTAL_STACK_DEPTH slots hold return addresses. Overflow and
+ * underflow are reported as faults. */
 void chip8_stack_push(struct chip8* chip8, unsigned short val)
 {
-    chip8->registers.SP += 1;
-    chip8_stack_in_bounds(chip8);
+    if (chip8->registers.SP >= CHIP8_TOTAL_STACK_DEPTH)
+    {
+        chip8->fault = CHIP8_FAULT_STACK_OVERFLOW;
+        return;
+    } /* End of if statement */
     chip8->stack.stack[chip8->registers.SP] = val;
+    chip8->registers.SP += 1;
 } /* End stack push function */
 
 unsigned short chip8_stack_pop(struct chip8* chip8)
 {
-    chip8_stack_in_bounds(chip8);
-    unsigned short result = chip8->stack.stack[chip8->registers.SP];
+    if (chip8->registers.SP == 0)
+    {
+        chip8->fault = CHIP8_FAULT_STACK_UNDERFLOW;
+        return chip8->registers.PC;
+    } /* End of if statement */
     chip8->registers.SP -= 1;
-    return result;
+    return chip8->stack.stack[chip8->registers.SP];
 } /* End stack pop function */
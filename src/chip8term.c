@@ -0,0 +1,158 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8term.c */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "chip8term.h"
+
+/* SGR foreground codes for each pixel colour; backgrounds are 10 more */
+static const int chip8_term_colours[4] = { 30, 97, 37, 90 };
+
+/* Braille dot bit for the pixel at column dx, row dy of a cell */
+static const unsigned char chip8_term_dots[4][2] = {
+    { 0x01, 0x08 }, { 0x02, 0x10 }, { 0x04, 0x20 }, { 0x40, 0x80 }
+};
+
+void chip8_term_init(struct chip8_term* term, enum chip8_term_mode mode)
+{
+    term->mode = mode;
+    chip8_term_invalidate(term);
+} /* End of term init function */
+
+/* Forces the next frame to be drawn in full, e.g. after the terminal
+ * was cleared or resized */
+void chip8_term_invalidate(struct chip8_term* term)
+{
+    term->columns = 0;
+    term->lines = 0;
+    term->valid = false;
+    term->foreground = -1;
+    term->background = -1;
+} /* End of term invalidate function */
+
+/* The two bits for pixels x and x+1 of a screen row, x even, left pixel
+ * in bit 1 */
+static inline unsigned int chip8_term_pair(const unsigned long long* row, int x)
+{
+    return (row[x / 64] >> (62 - x % 64)) & 3;
+} /* End of term pair function */
+
+static unsigned char chip8_term_braille(const struct chip8_screen* screen, int column, int line)
+{
+    unsigned char cell = 0;
+    for (int dy = 0; dy < 4; dy++)
+    {
+        int y = line * 4 + dy;
+        unsigned int pair = 0;
+        for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+        {
+            pair |= chip8_term_pair(screen->rows[plane][y], column * 2);
+        } /* End of nested for loop */
+        cell |= (pair & 2 ? chip8_term_dots[dy][0] : 0) | (pair & 1 ? chip8_term_dots[dy][1] : 0);
+    } /* End of for loop */
+    return cell;
+} /* End of term braille function */
+
+/* Top pixel colour in the low two bits, bottom in the next two */
+static unsigned char chip8_term_half_block(const struct chip8_screen* screen, int column, int line)
+{
+    return chip8_screen_pixel(screen, column, line * 2) | chip8_screen_pixel(screen, column, line * 2 + 1) << 2;
+} /* End of term half block function */
+
+static char* chip8_term_cell(struct chip8_term* term, char* out, unsigned char cell)
+{
+    if (term->mode == CHIP8_TERM_BRAILLE)
+    {
+        /* U+2800 + dots */
+        *out++ = (char) 0xE2;
+        *out++ = (char) (0xA0 | cell >> 6);
+        *out++ = (char) (0x80 | (cell & 0x3F));
+        return out;
+    } /* End of if statement */
+
+    int foreground = chip8_term_colours[cell & 3];
+    int background = chip8_term_colours[cell >> 2] + 10;
+    if (foreground != term->foreground && background != term->background)
+    {
+        out += sprintf(out, "\033[%d;%dm", foreground, background);
+    }
+    else if (foreground != term->foreground)
+    {
+        out += sprintf(out, "\033[%dm", foreground);
+    }
+    else if (background != term->background)
+    {
+        out += sprintf(out, "\033[%dm", background);
+    } /* End of if else statement */
+    term->foreground = foreground;
+    term->background = background;
+
+    /* U+2580 upper half block */
+    *out++ = (char) 0xE2;
+    *out++ = (char) 0x96;
+    *out++ = (char) 0x80;
+    return out;
+} /* End of term cell function */
+
+/* Builds the escape sequences that bring the terminal from the last
+ * frame to this one into term->buffer and returns their length, 0 if
+ * nothing changed. Only cell lines covering a row set in dirty_rows are
+ * looked at, unless the frame is drawn in full. Changed cells next to
+ * each other are sent as a run with a single cursor move. */
+size_t chip8_term_render(struct chip8_term* term, const struct chip8_screen* screen, unsigned long long dirty_rows)
+{
+    int cell_width = term->mode == CHIP8_TERM_BRAILLE ? 2 : 1;
+    int cell_height = term->mode == CHIP8_TERM_BRAILLE ? 4 : 2;
+    int columns = chip8_screen_width(screen) / cell_width;
+    int lines = chip8_screen_height(screen) / cell_height;
+    unsigned long long line_rows = (1ULL << cell_height) - 1;
+    char* out = term->buffer;
+
+    if (!term->valid || columns != term->columns || lines != term->lines)
+    {
+        out += sprintf(out, "\033[0m\033[H\033[2J");
+        term->valid = false;
+        term->columns = columns;
+        term->lines = lines;
+        term->foreground = -1;
+        term->background = -1;
+        dirty_rows = ~0ULL;
+    } /* End of if statement */
+
+    for (int line = 0; line < lines; line++)
+    {
+        if (!(dirty_rows >> (line * cell_height) & line_rows))
+        {
+            continue;
+        } /* End of if statement */
+
+        unsigned char* cells = &term->cells[line * columns];
+        int cursor = -1;
+        for (int column = 0; column < columns; column++)
+        {
+            unsigned char cell = term->mode == CHIP8_TERM_BRAILLE ?
+                chip8_term_braille(screen, column, line) :
+                chip8_term_half_block(screen, column, line);
+            if (term->valid && cell == cells[column])
+            {
+                continue;
+            } /* End of if statement */
+
+            if (cursor == -1)
+            {
+                out += sprintf(out, "\033[%d;%dH", line + 1, column + 1);
+            }
+            else if (cursor != column)
+            {
+                out += sprintf(out, "\033[%dC", column - cursor);
+            } /* End of if else statement */
+            out = chip8_term_cell(term, out, cell);
+            cells[column] = cell;
+            cursor = column + 1;
+        } /* End of nested for loop */
+    } /* End of for loop */
+
+    term->valid = true;
+    return out - term->buffer;
+} /* End of term render function */
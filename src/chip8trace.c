@@ -0,0 +1,177 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8trace.c */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include "config.h"
+#include "chip8trace.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+/* The abort handler writes through a descriptor opened beforehand, as
+ * fopen and stdio are not safe to call from a signal handler */
+static const struct chip8_trace* chip8_abort_trace;
+static int chip8_abort_fd = -1;
+
+int chip8_trace_init(struct chip8_trace* trace, size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    } /* End of while loop */
+
+    trace->records = calloc(size, sizeof(struct chip8_trace_record));
+    if (!trace->records)
+    {
+        return -1;
+    } /* End of if statement */
+
+    trace->mask = size - 1;
+    trace->written = 0;
+    return 0;
+} /* End of trace init function */
+
+void chip8_trace_free(struct chip8_trace* trace)
+{
+    if (chip8_abort_trace == trace)
+    {
+        chip8_abort_trace = NULL;
+        close(chip8_abort_fd);
+        chip8_abort_fd = -1;
+    } /* End of if statement */
+    free(trace->records);
+    trace->records = NULL;
+} /* End of trace free function */
+
+void chip8_trace_reset(struct chip8_trace* trace)
+{
+    trace->written = 0;
+} /* End of trace reset function */
+
+/* Writes the buffered records oldest first. */
+int chip8_trace_flush(const struct chip8_trace* trace, const char* filename)
+{
+    FILE* f = fopen(filename, "wb");
+    if (!f)
+    {
+        return -1;
+    } /* End of if statement */
+
+    size_t capacity = trace->mask + 1;
+    uint64_t count = trace->written < capacity ? trace->written : capacity;
+    size_t start = (trace->written - count) & trace->mask;
+
+    struct chip8_trace_header header;
+    memcpy(header.magic, CHIP8_TRACE_MAGIC, sizeof(header.magic));
+    header.version = CHIP8_TRACE_VERSION;
+    header.count = count;
+
+    int res = fwrite(&header, sizeof(header), 1, f) == 1 ? 0 : -1;
+
+    /* The live window may wrap around the end of the buffer */
+    size_t first = capacity - start < count ? capacity - start : count;
+    if (res == 0 && fwrite(&trace->records[start], sizeof(struct chip8_trace_record), first, f) != first)
+    {
+        res = -1;
+    } /* End of if statement */
+    if (res == 0 && fwrite(trace->records, sizeof(struct chip8_trace_record), count - first, f) != count - first)
+    {
+        res = -1;
+    } /* End of if statement */
+
+    if (fclose(f) != 0)
+    {
+        res = -1;
+    } /* End of if statement */
+    return res;
+} /* End of trace flush function */
+
+/* Writes all of len bytes, using only calls that are safe in a signal
+ * handler */
+static int chip8_trace_write_all(int fd, const void* buf, size_t len)
+{
+    const char* p = buf;
+    while (len > 0)
+    {
+        ssize_t written = write(fd, p, len);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        } /* End of if statement */
+        if (written <= 0)
+        {
+            return -1;
+        } /* End of if statement */
+        p += written;
+        len -= written;
+    } /* End of while loop */
+    return 0;
+} /* End of trace write all function */
+
+/* The records need no formatting, so the handler writes the header and
+ * the ring buffer's two runs straight to the descriptor */
+static void chip8_trace_abort_handler(int sig)
+{
+    const struct chip8_trace* trace = chip8_abort_trace;
+    if (trace && chip8_abort_fd != -1 && ftruncate(chip8_abort_fd, 0) == 0)
+    {
+        size_t capacity = trace->mask + 1;
+        uint64_t count = trace->written < capacity ? trace->written : capacity;
+        size_t start = (trace->written - count) & trace->mask;
+        size_t first = capacity - start < count ? capacity - start : count;
+
+        struct chip8_trace_header header;
+        memcpy(header.magic, CHIP8_TRACE_MAGIC, sizeof(header.magic));
+        header.version = CHIP8_TRACE_VERSION;
+        header.count = count;
+
+        if (chip8_trace_write_all(chip8_abort_fd, &header, sizeof(header)) == 0
+                && chip8_trace_write_all(chip8_abort_fd, &trace->records[start],
+                    first * sizeof(struct chip8_trace_record)) == 0)
+        {
+            chip8_trace_write_all(chip8_abort_fd, trace->records, (count - first) * sizeof(struct chip8_trace_record));
+        } /* End of if statement */
+    } /* End of if statement */
+    signal(sig, SIG_DFL);
+    raise(sig);
+} /* End of abort handler function */
+
+/* Dumps trace to filename if the process aborts, e.g. on a failed assert.
+ * The file is opened, and created if need be, here rather than in the
+ * handler. Only one trace can be registered at a time. */
+void chip8_trace_flush_on_abort(const struct chip8_trace* trace, const char* filename)
+{
+    if (chip8_abort_fd != -1)
+    {
+        close(chip8_abort_fd);
+    } /* End of if statement */
+    chip8_abort_fd = open(filename, O_WRONLY | O_CREAT | O_BINARY, 0644);
+    chip8_abort_trace = trace;
+    signal(SIGABRT, chip8_trace_abort_handler);
+} /* End of flush on abort function */
+
+/* CHIP8_TRACE=file, or filename when it is given, traces a run into a
+ * ring buffer of the default capacity that is flushed to the file on
+ * abort. Returns the file to flush to at the end of the run, or NULL
+ * when tracing is off or the buffer cannot be allocated. */
+const char* chip8_trace_start(struct chip8_trace* trace, const char* filename)
+{
+    if (!filename)
+    {
+        filename = getenv("CHIP8_TRACE");
+    } /* End of if statement */
+    if (!filename || chip8_trace_init(trace, CHIP8_TRACE_DEFAULT_CAPACITY) != 0)
+    {
+        return NULL;
+    } /* End of if statement */
+    chip8_trace_flush_on_abort(trace, filename);
+    return filename;
+} /* End of trace start function */
@@ -0,0 +1,43 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8triple.c */
+
+#include <string.h>
+
+#include "chip8triple.h"
+
+void chip8_triple_init(struct chip8_triple* triple)
+{
+    memset(triple->frames, 0, sizeof(triple->frames));
+    triple->back = 0;
+    atomic_init(&triple->middle, 1);
+    triple->front = 2;
+} /* End of triple init function */
+
+/* The buffer the writer fills next */
+struct chip8_frame* chip8_triple_back(struct chip8_triple* triple)
+{
+    return &triple->frames[triple->back];
+} /* End of triple back function */
+
+/* Hands the back buffer over as the latest frame. Release makes its
+ * contents visible to the reader that picks it up; acquire makes sure
+ * the reader is done with the buffer coming back. */
+void chip8_triple_publish(struct chip8_triple* triple)
+{
+    int previous = atomic_exchange_explicit(&triple->middle, triple->back | CHIP8_TRIPLE_FRESH, memory_order_acq_rel);
+    triple->back = previous & ~CHIP8_TRIPLE_FRESH;
+} /* End of triple publish function */
+
+/* Returns the latest frame, or NULL if nothing was published since the
+ * last call. The frame stays valid until the next call. */
+const struct chip8_frame* chip8_triple_read(struct chip8_triple* triple)
+{
+    if (!(atomic_load_explicit(&triple->middle, memory_order_relaxed) & CHIP8_TRIPLE_FRESH))
+    {
+        return NULL;
+    } /* End of if statement */
+
+    int previous = atomic_exchange_explicit(&triple->middle, triple->front, memory_order_acq_rel);
+    triple->front = previous & ~CHIP8_TRIPLE_FRESH;
+    return &triple->frames[triple->front];
+} /* End of triple read function */
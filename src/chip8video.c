@@ -0,0 +1,427 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8video.c */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8video.h"
+
+#define CHIP8_VIDEO_FRAME_RATE 60
+#define CHIP8_VIDEO_GIF_MIN_DELAY 2
+#define CHIP8_VIDEO_PNG_BLOCK 65535
+
+/* The same colours as the SDL frontend */
+static const unsigned char chip8_video_palette[4][3] = {
+    { 0, 0, 0 }, { 255, 255, 255 }, { 170, 170, 170 }, { 85, 85, 85 }};
+
+/* Y4M is written as grey, so the colours become their luma */
+static const unsigned char chip8_video_luma[4] = { 0, 255, 170, 85 };
+static const unsigned char chip8_video_indices[4] = { 0, 1, 2, 3 };
+
+static const char* chip8_video_format_names[] = { "y4m", "gif", "png" };
+
+int chip8_video_format_find(const char* name, enum chip8_video_format* format)
+{
+    for (size_t i = 0; i < sizeof(chip8_video_format_names) / sizeof(chip8_video_format_names[0]); i++)
+    {
+        if (strcmp(chip8_video_format_names[i], name) == 0)
+        {
+            *format = (enum chip8_video_format) i;
+            return 0;
+        } /* End of if statement */
+    } /* End of for loop */
+    return -1;
+} /* End of video format find function */
+
+static void chip8_video_put(struct chip8_video* video, const void* data, size_t size)
+{
+    fwrite(data, 1, size, video->out);
+    video->bytes += size;
+} /* End of video put function */
+
+static void chip8_video_put_short(struct chip8_video* video, unsigned int value)
+{
+    unsigned char bytes[2] = { value & 0xff, value >> 8 };
+    chip8_video_put(video, bytes, sizeof(bytes));
+} /* End of video put short function */
+
+/* GIF images are LZW coded, least significant bit first, in sub-blocks
+ * of up to 255 bytes */
+struct chip8_video_gif_bits
+{
+    struct chip8_video* video;
+    unsigned int bits;
+    int count;
+    unsigned char block[256];
+}; /* End video gif bits struct */
+
+static void chip8_video_gif_flush(struct chip8_video_gif_bits* gif)
+{
+    if (gif->block[0])
+    {
+        chip8_video_put(gif->video, gif->block, gif->block[0] + 1);
+        gif->block[0] = 0;
+    } /* End of if statement */
+} /* End of video gif flush function */
+
+static void chip8_video_gif_code(struct chip8_video_gif_bits* gif, unsigned int code, int size)
+{
+    gif->bits |= code << gif->count;
+    gif->count += size;
+    while (gif->count >= 8)
+    {
+        gif->block[++gif->block[0]] = gif->bits & 0xff;
+        gif->bits >>= 8;
+        gif->count -= 8;
+        if (gif->block[0] == 255)
+        {
+            chip8_video_gif_flush(gif);
+        } /* End of if statement */
+    } /* End of while loop */
+} /* End of video gif code function */
+
+/* Two bit colours : clear code 4, end code 5, codes start 3 bits wide.
+ * Strings are found through a child table indexed by colour, and the
+ * dictionary starts over once it is full. */
+static void chip8_video_gif_image(struct chip8_video* video, const unsigned char* pixels, unsigned int delay)
+{
+    static const unsigned char extension[] = { 0x21, 0xF9, 0x04, 0x04 };
+    chip8_video_put(video, extension, sizeof(extension));
+    chip8_video_put_short(video, delay);
+    static const unsigned char extension_end[] = { 0x00, 0x00, 0x2C };
+    chip8_video_put(video, extension_end, sizeof(extension_end));
+    chip8_video_put_short(video, 0);
+    chip8_video_put_short(video, 0);
+    chip8_video_put_short(video, video->width);
+    chip8_video_put_short(video, video->height);
+    static const unsigned char image_start[] = { 0x00, 0x02 };
+    chip8_video_put(video, image_start, sizeof(image_start));
+
+    const unsigned int clear = 4;
+    const unsigned int end = 5;
+    struct chip8_video_gif_bits gif = { .video = video };
+    int size = 3;
+    unsigned int last = end;
+    memset(video->gif_children, 0, sizeof(video->gif_children));
+    chip8_video_gif_code(&gif, clear, size);
+
+    size_t count = (size_t) video->width * video->height;
+    unsigned int prefix = pixels[0];
+    for (size_t i = 1; i < count; i++)
+    {
+        unsigned int colour = pixels[i];
+        unsigned int child = video->gif_children[prefix][colour];
+        if (child)
+        {
+            prefix = child;
+            continue;
+        } /* End of if statement */
+
+        chip8_video_gif_code(&gif, prefix, size);
+        video->gif_children[prefix][colour] = ++last;
+        if (last >= 1u << size)
+        {
+            size++;
+        } /* End of if statement */
+        if (last == CHIP8_VIDEO_GIF_CODES - 1)
+        {
+            chip8_video_gif_code(&gif, clear, size);
+            memset(video->gif_children, 0, sizeof(video->gif_children));
+            size = 3;
+            last = end;
+        } /* End of if statement */
+        prefix = colour;
+    } /* End of for loop */
+
+    chip8_video_gif_code(&gif, prefix, size);
+    chip8_video_gif_code(&gif, end, size);
+    chip8_video_gif_code(&gif, 0, 7);
+    chip8_video_gif_flush(&gif);
+    static const unsigned char image_end[] = { 0x00 };
+    chip8_video_put(video, image_end, sizeof(image_end));
+    video->images++;
+} /* End of video gif image function */
+
+static unsigned long chip8_video_crc_table[256];
+
+static unsigned long chip8_video_crc(unsigned long crc, const unsigned char* data, size_t size)
+{
+    if (!chip8_video_crc_table[1])
+    {
+        for (unsigned long n = 0; n < 256; n++)
+        {
+            unsigned long c = n;
+            for (int k = 0; k < 8; k++)
+            {
+                c = c & 1 ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+            } /* End of nested for loop */
+            chip8_video_crc_table[n] = c;
+        } /* End of for loop */
+    } /* End of if statement */
+
+    crc ^= 0xFFFFFFFFUL;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = chip8_video_crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    } /* End of for loop */
+    return crc ^ 0xFFFFFFFFUL;
+} /* End of video crc function */
+
+static void chip8_video_put_long_be(unsigned char* out, unsigned long value)
+{
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+} /* End of video put long be function */
+
+static void chip8_video_png_chunk(struct chip8_video* video, const char* type, const unsigned char* data, size_t size)
+{
+    unsigned char header[8];
+    chip8_video_put_long_be(header, size);
+    memcpy(header + 4, type, 4);
+    chip8_video_put(video, header, sizeof(header));
+    chip8_video_put(video, data, size);
+
+    unsigned char crc[4];
+    chip8_video_put_long_be(crc, chip8_video_crc(chip8_video_crc(0, header + 4, 4), data, size));
+    chip8_video_put(video, crc, sizeof(crc));
+} /* End of video png chunk function */
+
+/* PNGs are 2-bit palette images, four pixels to a byte. Each row gets a
+ * filter byte and the rows go out as stored deflate blocks: the images
+ * are small and flat, and keeping the encoder trivial keeps it fast. */
+static size_t chip8_video_png_row_size(int width)
+{
+    return 1 + (width + 3) / 4;
+} /* End of video png row size function */
+
+static size_t chip8_video_png_data_size(int width, int height)
+{
+    size_t raw = chip8_video_png_row_size(width) * height;
+    return 2 + raw + 5 * ((raw + CHIP8_VIDEO_PNG_BLOCK - 1) / CHIP8_VIDEO_PNG_BLOCK) + 4;
+} /* End of video png data size function */
+
+static int chip8_video_png_image(struct chip8_video* video, const unsigned char* pixels, unsigned long frame)
+{
+    char path[1100];
+    snprintf(path, sizeof(path), "%s%06lu.png", video->prefix, frame);
+    video->out = fopen(path, "wb");
+    if (!video->out)
+    {
+        return -1;
+    } /* End of if statement */
+
+    static const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    chip8_video_put(video, signature, sizeof(signature));
+
+    unsigned char header[13];
+    chip8_video_put_long_be(header, video->width);
+    chip8_video_put_long_be(header + 4, video->height);
+    header[8] = 2;
+    header[9] = 3;
+    header[10] = header[11] = header[12] = 0;
+    chip8_video_png_chunk(video, "IHDR", header, sizeof(header));
+    chip8_video_png_chunk(video, "PLTE", &chip8_video_palette[0][0], sizeof(chip8_video_palette));
+
+    /* Pack the rows after room for the zlib header and the first block
+     * header, then move them into stored blocks */
+    size_t row_size = chip8_video_png_row_size(video->width);
+    size_t raw = row_size * video->height;
+    unsigned char* rows = video->png_data + chip8_video_png_data_size(video->width, video->height) - raw - 4;
+    unsigned char* out = rows;
+    for (int y = 0; y < video->height; y++)
+    {
+        const unsigned char* row = pixels + (size_t) y * video->width;
+        *out++ = 0;
+        for (int x = 0; x < video->width; x += 4)
+        {
+            *out++ = row[x] << 6 | row[x + 1] << 4 | row[x + 2] << 2 | row[x + 3];
+        } /* End of nested for loop */
+    } /* End of for loop */
+
+    /* Adler-32, reducing modulo 65521 only as often as needed to stay
+     * within 32 bits */
+    unsigned long a = 1;
+    unsigned long b = 0;
+    for (size_t i = 0; i < raw; )
+    {
+        size_t stop = raw - i < 5552 ? raw : i + 5552;
+        for (; i < stop; i++)
+        {
+            a += rows[i];
+            b += a;
+        } /* End of nested for loop */
+        a %= 65521;
+        b %= 65521;
+    } /* End of for loop */
+
+    out = video->png_data;
+    *out++ = 0x78;
+    *out++ = 0x01;
+    for (size_t done = 0; done < raw; )
+    {
+        size_t block = raw - done < CHIP8_VIDEO_PNG_BLOCK ? raw - done : CHIP8_VIDEO_PNG_BLOCK;
+        *out++ = done + block == raw;
+        *out++ = block & 0xff;
+        *out++ = block >> 8;
+        *out++ = ~block & 0xff;
+        *out++ = (~block >> 8) & 0xff;
+        memmove(out, rows + done, block);
+        out += block;
+        done += block;
+    } /* End of for loop */
+    chip8_video_put_long_be(out, b << 16 | a);
+    out += 4;
+    chip8_video_png_chunk(video, "IDAT", video->png_data, out - video->png_data);
+    chip8_video_png_chunk(video, "IEND", NULL, 0);
+
+    int res = ferror(video->out) ? -1 : 0;
+    fclose(video->out);
+    video->out = NULL;
+    video->images++;
+    return res;
+} /* End of video png image function */
+
+/* path is the output file ("-" for stdout) or, for png, the prefix of
+ * the numbered files */
+int chip8_video_open(struct chip8_video* video, enum chip8_video_format format, const char* path, int width, int height)
+{
+    memset(video, 0, sizeof(*video));
+    video->format = format;
+    video->width = width;
+    video->height = height;
+    memcpy(video->lut, format == CHIP8_VIDEO_Y4M ? chip8_video_luma : chip8_video_indices, sizeof(video->lut));
+
+    size_t size = (size_t) width * height;
+    video->buffers[0] = malloc(size);
+    video->buffers[1] = malloc(size);
+    if (format == CHIP8_VIDEO_PNG)
+    {
+        video->prefix = path;
+        video->png_data = malloc(chip8_video_png_data_size(width, height));
+    }
+    else
+    {
+        video->out = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+        if (video->out)
+        {
+            setvbuf(video->out, NULL, _IOFBF, 1 << 20);
+        } /* End of if statement */
+    } /* End of if else statement */
+    if (!video->buffers[0] || !video->buffers[1] || (format == CHIP8_VIDEO_PNG ? !video->png_data : !video->out))
+    {
+        chip8_video_close(video, 0);
+        return -1;
+    } /* End of if statement */
+
+    if (format == CHIP8_VIDEO_Y4M)
+    {
+        char header[128];
+        int len = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 Cmono\n", width, height, CHIP8_VIDEO_FRAME_RATE);
+        chip8_video_put(video, header, len);
+    }
+    else if (format == CHIP8_VIDEO_GIF)
+    {
+        chip8_video_put(video, "GIF89a", 6);
+        chip8_video_put_short(video, width);
+        chip8_video_put_short(video, height);
+        static const unsigned char screen[] = { 0x81, 0x00, 0x00 };
+        chip8_video_put(video, screen, sizeof(screen));
+        chip8_video_put(video, chip8_video_palette, sizeof(chip8_video_palette));
+        static const unsigned char loop[] = { 0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+            0x03, 0x01, 0x00, 0x00, 0x00 };
+        chip8_video_put(video, loop, sizeof(loop));
+    } /* End of if else statement */
+    return 0;
+} /* End of video open function */
+
+/* The buffer to draw the next image into */
+unsigned char* chip8_video_buffer(struct chip8_video* video)
+{
+    return video->buffers[video->current];
+} /* End of video buffer function */
+
+/* Writes out the image waiting for its duration, which lasted until
+ * frame */
+static void chip8_video_flush(struct chip8_video* video, unsigned long frame)
+{
+    const unsigned char* pending = video->buffers[video->current ^ 1];
+    size_t size = (size_t) video->width * video->height;
+
+    if (video->format == CHIP8_VIDEO_Y4M)
+    {
+        for (unsigned long i = video->pending_frame; i < frame; i++)
+        {
+            chip8_video_put(video, "FRAME\n", 6);
+            chip8_video_put(video, pending, size);
+            video->images++;
+        } /* End of for loop */
+    }
+    else if (video->format == CHIP8_VIDEO_GIF)
+    {
+        unsigned long start = video->pending_frame * 100 / CHIP8_VIDEO_FRAME_RATE;
+        unsigned long stop = frame * 100 / CHIP8_VIDEO_FRAME_RATE;
+        chip8_video_gif_image(video, pending, stop - start > 0xFFFF ? 0xFFFF : stop - start);
+    } /* End of if else statement */
+    video->pending_frame = frame;
+} /* End of video flush function */
+
+/* Hands over the image drawn into the buffer as the one shown from
+ * frame on. Frames must be handed over in increasing order. */
+int chip8_video_write(struct chip8_video* video, unsigned long frame)
+{
+    if (video->format == CHIP8_VIDEO_PNG)
+    {
+        return chip8_video_png_image(video, chip8_video_buffer(video), frame);
+    } /* End of if statement */
+
+    if (video->pending)
+    {
+        bool too_short = video->format == CHIP8_VIDEO_GIF &&
+            frame * 100 / CHIP8_VIDEO_FRAME_RATE - video->pending_frame * 100 / CHIP8_VIDEO_FRAME_RATE < CHIP8_VIDEO_GIF_MIN_DELAY;
+        if (!too_short)
+        {
+            chip8_video_flush(video, frame);
+        } /* End of if statement */
+    }
+    else
+    {
+        video->pending_frame = frame;
+    } /* End of if else statement */
+
+    video->pending = true;
+    video->current ^= 1;
+    return ferror(video->out) ? -1 : 0;
+} /* End of video write function */
+
+/* Writes out the last image, which lasts until end_frame, and finishes
+ * the file */
+int chip8_video_close(struct chip8_video* video, unsigned long end_frame)
+{
+    int res = 0;
+    if (video->out)
+    {
+        if (video->pending)
+        {
+            chip8_video_flush(video, end_frame);
+        } /* End of if statement */
+        if (video->format == CHIP8_VIDEO_GIF)
+        {
+            chip8_video_put(video, ";", 1);
+        } /* End of if statement */
+        res = fflush(video->out) != 0 || ferror(video->out) ? -1 : 0;
+        if (video->out != stdout)
+        {
+            fclose(video->out);
+        } /* End of if statement */
+        video->out = NULL;
+    } /* End of if statement */
+
+    free(video->buffers[0]);
+    free(video->buffers[1]);
+    free(video->png_data);
+    video->buffers[0] = video->buffers[1] = NULL;
+    video->png_data = NULL;
+    return res;
+} /* End of video close function */
@@ -1,19 +1,181 @@
 /* Program name : Chip-8 emulator 
  * File name : main.c */
 
+#include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
 #include <Windows.h>
 
 #include "SDL2/SDL.h"
 #include "chip8.h"
 #include "chip8keyboard.h"
+#include "chip8loader.h"
+#include "chip8profiler.h"
+#include "chip8scale.h"
+#include "chip8triple.h"
 
 const char keyboard_map[CHIP8_TOTAL_KEYS] = {
     SDLK_0, SDLK_1, SDLK_2, SDLK_3, SDLK_4, SDLK_5,
     SDLK_6, SDLK_7, SDLK_8, SDLK_9, SDLK_a, SDLK_b,
     SDLK_c, SDLK_d, SDLK_e, SDLK_f};
 
+/* RGB for each pixel colour, plane 0 | plane 1 << 1. Plain CHIP-8 and
+ * SUPER-CHIP only ever use the first two. */
+const unsigned char palette[4][3] = {
+    { 0, 0, 0 }, { 255, 255, 255 }, { 170, 170, 170 }, { 85, 85, 85 }};
+
+/* State shared between the SDL thread and the emulation thread. The
+ * emulation thread owns chip8 while it runs; frames travel out through
+ * the triple buffer and key presses come in through the keys bitmask. */
+struct emulator
+{
+    struct chip8 chip8;
+    struct chip8_triple triple;
+    _Atomic unsigned int keys;
+    atomic_bool quit;
+    bool throttled;
+    bool powersave;
+    SDL_sem* wake;
+    Uint32 frame_event;
+    unsigned long long frames;
+    unsigned long long sleeps;
+    Uint64 ticks;
+}; /* End emulator struct */
+
+/* Runs the emulator a frame at a time, paced to 60Hz unless unthrottled,
+ * and publishes every frame that changed the screen or started a sound.
+ * Never touches SDL video, so a stalled present cannot hold it up. In
+ * power saving mode it announces each frame with an event so the SDL
+ * thread can block, and while the core sits idle it sleeps until a key
+ * changes, or the delay timer it polls runs out, instead of running
+ * frames that would change nothing. */
+static int emulator_thread(void* data)
+{
+    struct emulator* emulator = data;
+    struct chip8* chip8 = &emulator->chip8;
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 period = frequency / CHIP8_TIMER_HZ;
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 next = start;
+    unsigned char sound_timer = 0;
+
+    while (!atomic_load_explicit(&emulator->quit, memory_order_relaxed))
+    {
+        chip8_keyboard_set_mask(&chip8->keyboard, atomic_load_explicit(&emulator->keys, memory_order_relaxed));
+        chip8_run_frame(chip8);
+        emulator->frames++;
+
+        bool sound_started = chip8_sound_timer(chip8) > 0 && sound_timer == 0;
+        sound_timer = chip8_sound_timer(chip8);
+        if (chip8_screen_take_dirty_rows(&chip8->screen) || sound_started)
+        {
+            chip8_frame_capture(chip8_triple_back(&emulator->triple), chip8, emulator->frames);
+            chip8_triple_publish(&emulator->triple);
+            if (emulator->powersave)
+            {
+                SDL_Event event = { .type = emulator->frame_event };
+                SDL_PushEvent(&event);
+            } /* End of if statement */
+        } /* End of if statement */
+
+        if (chip8->fault != CHIP8_FAULT_NONE)
+        {
+            SDL_Event event = { .type = SDL_QUIT };
+            SDL_PushEvent(&event);
+            break;
+        } /* End of if statement */
+
+        if (emulator->powersave && chip8_can_sleep(chip8))
+        {
+            Uint64 asleep = SDL_GetPerformanceCounter();
+            unsigned long long frames = chip8_sleep_frames(chip8);
+            Uint64 deadline = asleep + frames * period;
+            emulator->sleeps++;
+            while (!atomic_load_explicit(&emulator->quit, memory_order_relaxed))
+            {
+                chip8_keyboard_set_mask(&chip8->keyboard, atomic_load_explicit(&emulator->keys, memory_order_relaxed));
+                if (!chip8_can_sleep(chip8))
+                {
+                    break;
+                } /* End of if statement */
+                if (frames == ULLONG_MAX)
+                {
+                    SDL_SemWait(emulator->wake);
+                    continue;
+                } /* End of if statement */
+
+                /* A timer poll only sleeps until the timer runs out */
+                Uint64 now = SDL_GetPerformanceCounter();
+                if (now >= deadline)
+                {
+                    break;
+                } /* End of if statement */
+                SDL_SemWaitTimeout(emulator->wake, (Uint32) ((deadline - now) * 1000 / frequency) + 1);
+            } /* End of while loop */
+
+            /* The frames slept through pass in one step, timers and all */
+            next = SDL_GetPerformanceCounter();
+            unsigned long long slept = (next - asleep) / period;
+            chip8_skip_frames(chip8, slept);
+            emulator->frames += slept;
+            sound_timer = chip8_sound_timer(chip8);
+            continue;
+        } /* End of if statement */
+
+        if (emulator->throttled)
+        {
+            next += period;
+            Uint64 now = SDL_GetPerformanceCounter();
+            if (next > now)
+            {
+                SDL_Delay((Uint32) ((next - now) * 1000 / frequency));
+            }
+            else
+            {
+                next = now;
+            } /* End of if else statement */
+        } /* End of if statement */
+    } /* End of while loop */
+
+    emulator->ticks = SDL_GetPerformanceCounter() - start;
+    return 0;
+} /* End of emulator thread function */
+
+/* Streaming textures for the two resolutions, filled at one texel per
+ * pixel and stretched to the window by the renderer */
+struct display
+{
+    SDL_Renderer* renderer;
+    SDL_Texture* textures[2];
+    Uint32 colours[4];
+}; /* End display struct */
+
+static void draw_frame(struct display* display, const struct chip8_frame* frame)
+{
+    bool hires = frame->width == CHIP8_HIRES_WIDTH;
+    if (!display->textures[hires])
+    {
+        display->textures[hires] = SDL_CreateTexture(display->renderer, SDL_PIXELFORMAT_ARGB8888,
+                SDL_TEXTUREACCESS_STREAMING, frame->width, frame->height);
+    } /* End of if statement */
+
+    SDL_Texture* texture = display->textures[hires];
+    void* pixels;
+    int pitch;
+    if (SDL_LockTexture(texture, NULL, &pixels, &pitch) == 0)
+    {
+        chip8_scale_rgba(frame, display->colours, 1, pixels, pitch);
+        SDL_UnlockTexture(texture);
+    } /* End of if statement */
+
+    SDL_RenderCopy(display->renderer, texture, NULL, NULL);
+    SDL_RenderPresent(display->renderer);
+} /* End of draw frame function */
+
 int main(int argc, char **argv)
 {
     if (argc < 2)
@@ -25,29 +187,67 @@ int main(int argc, char **argv)
     const char* filename = argv[1];
     printf("The filename to load into memory is: %s\n", filename);
 
-    FILE* f = fopen(filename, "rb");
-    if (!f)
+    static struct emulator emulator;
+    struct chip8* chip8 = &emulator.chip8;
+    chip8_init(chip8);
+    chip8_seed(chip8, time(NULL));
+
+    enum chip8_load_result res = chip8_load_file(chip8, filename);
+    if (res != CHIP8_LOAD_OK)
     {
-        printf("Failed to open file!\n");
+        printf("Failed to load %s: %s\n", filename, chip8_load_result_name(res));
         return -1;
     } /* End of if statement */
 
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    chip8_keyboard_set_map(&chip8->keyboard, keyboard_map);
 
-    char buf[size];
-    int res = fread(buf, size, 1, f);
-    if (res != 1)
+    /* CHIP8_PROFILE=name overrides the quirk profile implied by the
+     * file extension */
+    const struct chip8_profile* profile = chip8_profile_for_file(filename);
+    const char* profile_name = getenv("CHIP8_PROFILE");
+    if (profile_name)
     {
-        printf("Failed to read from the file!\n");
-        return -1;
+        profile = chip8_profile_find(profile_name);
+        if (!profile)
+        {
+            printf("Unknown profile %s\n", profile_name);
+            return -1;
+        } /* End of if statement */
     } /* End of if statement */
+    chip8_set_profile(chip8, profile);
 
-    struct chip8 chip8;
-    chip8_init(&chip8);
-    chip8_load(&chip8, buf, size);
-    chip8_keyboard_set_map(&chip8.keyboard, keyboard_map);
+    /* CHIP8_TRACE=file keeps the last instructions in a ring buffer and
+     * writes them out on exit or abort */
+    struct chip8_trace trace;
+    const char* trace_filename = chip8_trace_start(&trace, NULL);
+    if (trace_filename)
+    {
+        chip8->trace = &trace;
+    } /* End of if statement */
+
+#ifdef CHIP8_PROFILING
+    /* Profiling builds (make profiling) write what the session ran to
+     * CHIP8_COUNTS=file on exit, for fusegen */
+    static struct chip8_profiler profiler;
+    const char* counts_filename = getenv("CHIP8_COUNTS");
+    if (counts_filename && chip8_profiler_init(&profiler) == 0)
+    {
+        chip8->profiler = &profiler;
+    } /* End of if statement */
+#endif
+
+    /* CHIP8_VSYNC=0 presents without waiting for the display, and
+     * CHIP8_UNTHROTTLED=1 runs the emulator flat out, so the throughput
+     * printed on exit shows what a present costs the core */
+    const char* vsync = getenv("CHIP8_VSYNC");
+    bool use_vsync = !vsync || strcmp(vsync, "0") != 0;
+    const char* unthrottled = getenv("CHIP8_UNTHROTTLED");
+    emulator.throttled = !unthrottled || strcmp(unthrottled, "1") != 0;
+
+    /* CHIP8_POWERSAVE=0 goes back to polling for events and frames
+     * every millisecond and running idle frames, for comparison */
+    const char* powersave = getenv("CHIP8_POWERSAVE");
+    emulator.powersave = !powersave || strcmp(powersave, "0") != 0;
 
     SDL_Init(SDL_INIT_EVERYTHING);
     SDL_Window *window = SDL_CreateWindow(
@@ -58,12 +258,31 @@ int main(int argc, char **argv)
         CHIP8_HEIGHT * CHIP8_WINDOW_MULTIPLIER,
         SDL_WINDOW_SHOWN);
 
-    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_TEXTUREACCESS_TARGET);
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1,
+            SDL_RENDERER_ACCELERATED | (use_vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
 
+    struct display display = { .renderer = renderer };
+    for (int i = 0; i < 4; i++)
+    {
+        display.colours[i] = 0xff000000 | palette[i][0] << 16 | palette[i][1] << 8 | palette[i][2];
+    } /* End of for loop */
+
+    chip8_triple_init(&emulator.triple);
+    atomic_init(&emulator.keys, 0);
+    atomic_init(&emulator.quit, false);
+    emulator.wake = SDL_CreateSemaphore(0);
+    emulator.frame_event = SDL_RegisterEvents(1);
+    SDL_Thread* thread = SDL_CreateThread(emulator_thread, "chip8", &emulator);
+
+    unsigned long long presented = 0;
+    unsigned char sound_timer = 0;
     while (1)
     {
+        /* Powersave blocks until input or the emulator's next frame */
         SDL_Event event;
-        while (SDL_PollEvent(&event))
+        bool have_event = emulator.powersave ? SDL_WaitEvent(&event) : SDL_PollEvent(&event);
+        for (; have_event; have_event = SDL_PollEvent(&event))
         {
             switch (event.type)
             {
@@ -74,10 +293,11 @@ int main(int argc, char **argv)
             case SDL_KEYDOWN:
             {
                 char key = event.key.keysym.sym;
-                int vkey = chip8_keyboard_map(&chip8.keyboard, key);
+                int vkey = chip8_keyboard_map(&chip8->keyboard, key);
                 if (vkey != -1)
                 {
-                    chip8_keyboard_down(&chip8.keyboard, vkey);
+                    atomic_fetch_or_explicit(&emulator.keys, 1u << vkey, memory_order_relaxed);
+                    SDL_SemPost(emulator.wake);
                 }
             } /* End case SDL_KEYDOWN */
                 break;
@@ -85,10 +305,11 @@ int main(int argc, char **argv)
             case SDL_KEYUP:
             {
                 char key = event.key.keysym.sym;
-                int vkey = chip8_keyboard_map(&chip8.keyboard, key);
+                int vkey = chip8_keyboard_map(&chip8->keyboard, key);
                 if (vkey != -1)
                 {
-                    chip8_keyboard_up(&chip8.keyboard, vkey);
+                    atomic_fetch_and_explicit(&emulator.keys, ~(1u << vkey), memory_order_relaxed);
+                    SDL_SemPost(emulator.wake);
                 }
             } /* End case SDL_KEYUP */
                 break;
@@ -96,47 +317,72 @@ int main(int argc, char **argv)
             default:
                 break;
             } /* End switch statement */
-        } /* End nested while */
-
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
-        SDL_RenderClear(renderer);
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 0);
+        } /* End nested for */
 
-        for (int x = 0; x < CHIP8_WIDTH; x++)
+        /* Only redraw once the emulator has published a new frame */
+        const struct chip8_frame* frame = chip8_triple_read(&emulator.triple);
+        if (!frame)
         {
-            for (int y = 0; y < CHIP8_HEIGHT; y++)
+            if (!emulator.powersave)
             {
-                if (chip8_screen_is_set(&chip8.screen, x, y))
-                {
-                    SDL_Rect r;
-                    r.x = x * CHIP8_WINDOW_MULTIPLIER;
-                    r.y = y * CHIP8_WINDOW_MULTIPLIER;
-                    r.w = CHIP8_WINDOW_MULTIPLIER;
-                    r.h = CHIP8_WINDOW_MULTIPLIER;
-                    SDL_RenderFillRect(renderer, &r);
-                } /* End nested if statement */
-            } /* End nested for loop */
-        } /* End for loop */
-        SDL_RenderPresent(renderer);
-
-        if (chip8.registers.delay_timer > 0)
-        {
-            Sleep(100);
-            chip8.registers.delay_timer -= 1;
+                SDL_Delay(1);
+            } /* End of if statement */
+            continue;
         } /* End of if statement */
 
-        if (chip8.registers.sound_timer > 0)
+        draw_frame(&display, frame);
+        presented++;
+
+        /* Beep blocks, but only this thread now */
+        if (frame->sound_timer > 0 && sound_timer == 0)
         {
-            Beep(15000, 100 * chip8.registers.sound_timer);
-            chip8.registers.sound_timer = 0;
+            Beep(15000, frame->sound_timer * 1000 / CHIP8_TIMER_HZ);
         } /* End of if statement */
-
-        unsigned short opcode = chip8_memory_get_short(&chip8.memory, chip8.registers.PC);
-        chip8.registers.PC += 2;
-        chip8_exec(&chip8, opcode);
+        sound_timer = frame->sound_timer;
     } /* End infinite while */
 
 out:
+    atomic_store(&emulator.quit, true);
+    SDL_SemPost(emulator.wake);
+    SDL_WaitThread(thread, NULL);
+    SDL_DestroySemaphore(emulator.wake);
+
+    if (chip8->fault != CHIP8_FAULT_NONE)
+    {
+        printf("Stopped at PC %03X: %s\n", chip8->registers.PC, chip8_fault_name(chip8->fault));
+    } /* End of if statement */
+
+    double seconds = (double) emulator.ticks / SDL_GetPerformanceFrequency();
+    if (seconds > 0)
+    {
+        printf("vsync %s: emulated %llu frames in %.2fs (%.0f frames/s, %.0f instructions/s), presented %llu, slept %llu times\n",
+                use_vsync ? "on" : "off", emulator.frames, seconds, emulator.frames / seconds,
+                chip8->cycles / seconds, presented, emulator.sleeps);
+    } /* End of if statement */
+
+    if (chip8->trace)
+    {
+        chip8_trace_flush(chip8->trace, trace_filename);
+        chip8_trace_free(chip8->trace);
+    } /* End of if statement */
+#ifdef CHIP8_PROFILING
+    if (chip8->profiler)
+    {
+        if (chip8_profiler_save(chip8->profiler, counts_filename) != 0)
+        {
+            printf("Failed to write counts to %s\n", counts_filename);
+        } /* End of nested if statement */
+        chip8_profiler_free(chip8->profiler);
+    } /* End of if statement */
+#endif
+    for (int i = 0; i < 2; i++)
+    {
+        if (display.textures[i])
+        {
+            SDL_DestroyTexture(display.textures[i]);
+        } /* End of if statement */
+    } /* End of for loop */
+    SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     return 0;
 } /* End main function */
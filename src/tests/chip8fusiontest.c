@@ -0,0 +1,340 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8fusiontest.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8.h"
+#include "chip8lockstep.h"
+#include "chip8ngram.h"
+#include "chip8predecode.h"
+#include "chip8super.h"
+
+/* Differential test of the predecoded run loop against the switch
+ * interpreter. Each case runs from one start state both ways, a chunk
+ * of instructions at a time, and compares the full state after every
+ * chunk. The chunk sizes vary so fused runs get cut short at the end of
+ * a chunk too. Built once per memory policy that does not abort. */
+
+#define FUSION_TEST_CYCLES 200000
+#define FUSION_TEST_PROFILE_CYCLES 20000
+#define FUSION_TEST_INSTANCES 200
+
+static const int fusion_test_chunks[] = { 1, 3, 17, 64, CHIP8_CYCLES_PER_FRAME };
+
+static const char* fusion_test_profiles[] = { "default", "vip", "schip", "xochip" };
+
+static int checks;
+static int failures;
+
+static void check(int ok, const char* what)
+{
+    checks++;
+    if (!ok)
+    {
+        failures++;
+    } /* End of if statement */
+    printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+} /* End of check function */
+
+static unsigned long long fusion_test_state = 1;
+
+static unsigned long long fusion_test_random(void)
+{
+    fusion_test_state ^= fusion_test_state << 13;
+    fusion_test_state ^= fusion_test_state >> 7;
+    fusion_test_state ^= fusion_test_state << 17;
+    return fusion_test_state;
+} /* End of fusion test random function */
+
+/* Runs start for cycles instructions with the profile's run loop and
+ * with chip8_predecode_run over predecode. Returns 0 if the two agreed
+ * after every chunk, else prints where they parted. */
+static int run_both(const char* name, const struct chip8* start, struct chip8_predecode* predecode,
+        unsigned long long cycles)
+{
+    static struct chip8 reference;
+    static struct chip8 fused;
+    reference = *start;
+    fused = *start;
+    for (int chunk = 0; reference.cycles - start->cycles < cycles && reference.fault == CHIP8_FAULT_NONE; chunk++)
+    {
+        int n = fusion_test_chunks[chunk % (sizeof(fusion_test_chunks) / sizeof(fusion_test_chunks[0]))];
+        unsigned short pc = reference.registers.PC;
+        unsigned long long cycle = reference.cycles;
+        reference.profile->run(&reference, n);
+        chip8_predecode_run(predecode, &fused, n);
+        if (!chip8_state_equal(&reference, &fused) || reference.cycles != fused.cycles)
+        {
+            printf("     %s: %d instructions from PC %03X at cycle %llu end at PC %03X (cycle %llu) "
+                    "but %03X (cycle %llu) fused\n", name, n, pc, cycle, reference.registers.PC,
+                    reference.cycles, fused.registers.PC, fused.cycles);
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+    return 0;
+} /* End of run both function */
+
+/* The runs chip8_fusion_select picks from a profile of start */
+static int select_fusion(const struct chip8* start, struct chip8_fusion* fusion)
+{
+    static struct chip8 profiled;
+    struct chip8_ngrams ngrams;
+    if (chip8_ngrams_init(&ngrams) != 0)
+    {
+        return -1;
+    } /* End of if statement */
+    profiled = *start;
+    chip8_ngrams_run(&ngrams, &profiled, FUSION_TEST_PROFILE_CYCLES);
+    int res = chip8_fusion_select(fusion, &ngrams, CHIP8_FUSION_MAX_PATTERNS);
+    chip8_ngrams_free(&ngrams);
+    return res;
+} /* End of select fusion function */
+
+/* A loop of register arithmetic, random numbers, skips and draws, with
+ * I stepping on by up to 15 a pass until it runs past the end of the
+ * address space */
+static const unsigned char program_arithmetic[] = {
+    0x60, 0x00,     /* 200: LD V0, 0 */
+    0x61, 0x01,     /* 202: LD V1, 1 */
+    0xA3, 0x00,     /* 204: LD I, 0x300 */
+    0x70, 0x01,     /* 206: ADD V0, 1 */
+    0x80, 0x14,     /* 208: ADD V0, V1 */
+    0x82, 0x06,     /* 20A: SHR V2, V0 */
+    0xC3, 0x0F,     /* 20C: RND V3, 0x0F */
+    0xF3, 0x1E,     /* 20E: ADD I, V3 */
+    0xD1, 0x25,     /* 210: DRW V1, V2, 5 */
+    0x30, 0x80,     /* 212: SE V0, 0x80 */
+    0x12, 0x06,     /* 214: JP 0x206 */
+    0x60, 0x00,     /* 216: LD V0, 0 */
+    0x12, 0x06,     /* 218: JP 0x206 */
+};
+
+/* Stores inside the loop rewrite its own code : store A patches the
+ * ADD V2 at 0x210, two instructions into the run after it, and store B
+ * the loop's first instruction, which the next pass runs fused */
+static const unsigned char program_self_modifying[] = {
+    0x68, 0x00,     /* 200: LD V8, 0 */
+    0x78, 0x01,     /* 202: ADD V8, 1 or 2, patched by store B */
+    0x60, 0x72,     /* 204: LD V0, 0x72 */
+    0x81, 0x80,     /* 206: LD V1, V8 */
+    0xA2, 0x10,     /* 208: LD I, 0x210 */
+    0xF1, 0x55,     /* 20A: LD [I], V1 (store A) */
+    0x63, 0x00,     /* 20C: LD V3, 0 */
+    0x73, 0x01,     /* 20E: ADD V3, 1 */
+    0x72, 0x00,     /* 210: ADD V2, V8, patched by store A */
+    0x73, 0x01,     /* 212: ADD V3, 1 */
+    0x60, 0x78,     /* 214: LD V0, 0x78 */
+    0x81, 0x80,     /* 216: LD V1, V8 */
+    0x66, 0x01,     /* 218: LD V6, 1 */
+    0x81, 0x62,     /* 21A: AND V1, V6 */
+    0x71, 0x01,     /* 21C: ADD V1, 1 */
+    0xA2, 0x02,     /* 21E: LD I, 0x202 */
+    0xF1, 0x55,     /* 220: LD [I], V1 (store B) */
+    0xA4, 0x00,     /* 222: LD I, 0x400 */
+    0xF8, 0x33,     /* 224: LD B, V8 */
+    0xF2, 0x65,     /* 226: LD V2, [I] */
+    0x12, 0x02,     /* 228: JP 0x202 */
+};
+
+/* The last eight bytes of the address space : a run that ends exactly
+ * at its end, leaving PC to wrap, and reads across it from I */
+static const unsigned char program_wrap_tail[] = {
+    0x60, 0x01,     /* LD V0, 1 */
+    0x70, 0x01,     /* ADD V0, 1 */
+    0xF0, 0x1E,     /* ADD I, V0 */
+    0xF3, 0x65,     /* LD V3, [I] */
+};
+
+/* What PC comes back to once it has wrapped : I just short of the end,
+ * then on to the tail again */
+static const unsigned char program_wrap_head[] = {
+    0xAF, 0xFC,     /* 200: LD I, 0xFFC */
+    0x1F, 0xF8,     /* 202: JP 0xFF8 */
+};
+
+static void start_program(struct chip8* chip8, const char* profile, const unsigned char* program, size_t size)
+{
+    chip8_init(chip8);
+    chip8_seed(chip8, 1);
+    chip8_set_profile(chip8, chip8_profile_find(profile));
+    chip8_load(chip8, (const char*) program, size);
+} /* End of start program function */
+
+static void test_program(const char* profile, const char* name, const struct chip8* start)
+{
+    char what[128];
+    struct chip8_fusion fusion;
+    struct chip8_predecode predecode;
+    int picked = select_fusion(start, &fusion);
+    int ok = picked > 0 && chip8_predecode_init(&predecode, &fusion) == 0;
+    if (ok)
+    {
+        snprintf(what, sizeof(what), "%s: %s", profile, name);
+        ok = run_both(what, start, &predecode, FUSION_TEST_CYCLES) == 0;
+        chip8_predecode_free(&predecode);
+    } /* End of if statement */
+    snprintf(what, sizeof(what), "%s: %s fuses %d runs and agrees with switch", profile, name, picked);
+    check(ok, what);
+} /* End of test program function */
+
+static void test_programs(void)
+{
+    static struct chip8 start;
+    for (size_t i = 0; i < sizeof(fusion_test_profiles) / sizeof(fusion_test_profiles[0]); i++)
+    {
+        const char* profile = fusion_test_profiles[i];
+        start_program(&start, profile, program_arithmetic, sizeof(program_arithmetic));
+        test_program(profile, "arithmetic", &start);
+
+        start_program(&start, profile, program_self_modifying, sizeof(program_self_modifying));
+        test_program(profile, "self-modifying stores", &start);
+
+        /* The tail sits at the end of the profile's space and at 0xFF8,
+         * where the head jumps, so XO-CHIP also crosses 0xFFF */
+        start_program(&start, profile, program_wrap_head, sizeof(program_wrap_head));
+        int space = chip8_address_space(&start);
+        memcpy(&start.memory.memory[space - sizeof(program_wrap_tail)], program_wrap_tail, sizeof(program_wrap_tail));
+        memcpy(&start.memory.memory[0xFF8], program_wrap_tail, sizeof(program_wrap_tail));
+        start.registers.PC = space - sizeof(program_wrap_tail);
+        start.registers.I = space - 4;
+        test_program(profile, "PC and I wrapping", &start);
+    } /* End of for loop */
+} /* End of test programs function */
+
+/* A random opcode that decodes as op */
+static unsigned short random_opcode(enum chip8_op op)
+{
+    unsigned short opcode;
+    do
+    {
+        opcode = fusion_test_random();
+    } while (chip8_op_decode(opcode) != op);
+    return opcode;
+} /* End of random opcode function */
+
+/* Random instances of a pattern, each run from a random state over a
+ * cache with fusion as its table. Every other instance is planted at
+ * the end of the address space. The instances share the cache, so each
+ * also runs over the entries the last one left. */
+static int test_instances(const char* profile, const struct chip8_fusion* fusion,
+        const struct chip8_fusion_pattern* pattern)
+{
+    static struct chip8 start;
+    struct chip8_predecode predecode;
+    if (chip8_predecode_init(&predecode, fusion) != 0)
+    {
+        return -1;
+    } /* End of if statement */
+
+    for (int instance = 0; instance < FUSION_TEST_INSTANCES; instance++)
+    {
+        chip8_init(&start);
+        chip8_seed(&start, fusion_test_random());
+        chip8_set_profile(&start, chip8_profile_find(profile));
+        int space = chip8_address_space(&start);
+        for (int i = CHIP8_PROGRAM_LOAD_ADDRESS; i < space; i++)
+        {
+            start.memory.memory[i] = fusion_test_random();
+        } /* End of for loop */
+        for (int i = 0; i < CHIP8_TOTAL_DATA_REGISTERS; i++)
+        {
+            start.registers.V[i] = fusion_test_random();
+        } /* End of for loop */
+        start.registers.I = fusion_test_random() % space;
+        start.keyboard.keyboard[fusion_test_random() % CHIP8_TOTAL_KEYS] = true;
+
+        unsigned short pc = instance % 2 ? space - 2 * CHIP8_FUSE_MAX
+                : CHIP8_PROGRAM_LOAD_ADDRESS + 2 * (fusion_test_random() % 0x600);
+        for (int i = 0; i < pattern->length; i++)
+        {
+            unsigned short opcode = random_opcode(pattern->ops[i]);
+            start.memory.memory[pc + 2 * i] = opcode >> 8;
+            start.memory.memory[pc + 2 * i + 1] = opcode & 0xff;
+        } /* End of for loop */
+        start.registers.PC = pc;
+
+        if (run_both(profile, &start, &predecode, 4 * CHIP8_FUSE_MAX) != 0)
+        {
+            chip8_predecode_free(&predecode);
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    chip8_predecode_free(&predecode);
+    return 0;
+} /* End of test instances function */
+
+/* The runs picked from a profile of random programs, which covers far
+ * more forms than the programs above do. A program is profiled until it
+ * faults, then the next one takes over. */
+static void test_random_fusion(void)
+{
+    static struct chip8 profiled;
+    char what[128];
+    for (size_t i = 0; i < sizeof(fusion_test_profiles) / sizeof(fusion_test_profiles[0]); i++)
+    {
+        const char* profile = fusion_test_profiles[i];
+        struct chip8_ngrams ngrams;
+        struct chip8_fusion fusion;
+        int picked = -1;
+        if (chip8_ngrams_init(&ngrams) == 0)
+        {
+            for (int program = 0; program < 100; program++)
+            {
+                chip8_init(&profiled);
+                chip8_seed(&profiled, fusion_test_random());
+                chip8_set_profile(&profiled, chip8_profile_find(profile));
+                for (int j = CHIP8_PROGRAM_LOAD_ADDRESS; j < CHIP8_CLASSIC_MEMORY_SIZE; j++)
+                {
+                    profiled.memory.memory[j] = fusion_test_random();
+                } /* End of nested for loop */
+                chip8_ngrams_run(&ngrams, &profiled, FUSION_TEST_PROFILE_CYCLES / 100);
+            } /* End of nested for loop */
+            picked = chip8_fusion_select(&fusion, &ngrams, CHIP8_FUSION_MAX_PATTERNS);
+            chip8_ngrams_free(&ngrams);
+        } /* End of if statement */
+
+        int ok = picked > 0;
+        for (int j = 0; ok && j < fusion.count; j++)
+        {
+            struct chip8_fusion alone = { .count = 1 };
+            alone.patterns[0] = fusion.patterns[j];
+            ok = test_instances(profile, &alone, &fusion.patterns[j]) == 0;
+        } /* End of for loop */
+        snprintf(what, sizeof(what), "%s: random instances of %d runs picked from random code agree with switch",
+                profile, picked);
+        check(ok, what);
+    } /* End of for loop */
+} /* End of test random fusion function */
+
+/* Random instances of each superinstruction generated into
+ * chip8super.h, run with an empty fusion table so only its handler can
+ * claim the run */
+static void test_supers(void)
+{
+    static const struct chip8_fusion_pattern supers[] = { CHIP8_SUPER_PATTERNS };
+    char what[128];
+    for (size_t i = 0; i < sizeof(fusion_test_profiles) / sizeof(fusion_test_profiles[0]); i++)
+    {
+        int ok = CHIP8_TOTAL_SUPERS > 0;
+        for (int j = 0; ok && supers[j].length; j++)
+        {
+            ok = test_instances(fusion_test_profiles[i], NULL, &supers[j]) == 0;
+        } /* End of for loop */
+        snprintf(what, sizeof(what), "%s: random instances of the %d generated superinstructions agree with switch",
+                fusion_test_profiles[i], CHIP8_TOTAL_SUPERS);
+        check(ok, what);
+    } /* End of for loop */
+} /* End of test supers function */
+
+int main(void)
+{
+    test_programs();
+    test_random_fusion();
+    test_supers();
+
+    printf("%d checks, %d failures\n", checks, failures);
+    return failures ? 1 : 0;
+} /* End of main function */
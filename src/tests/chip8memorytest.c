@@ -0,0 +1,142 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8memorytest.c */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "chip8.h"
+
+/* Built once per memory policy; each build checks the behaviour its
+ * policy promises for accesses past the end of the address space. */
+
+static int checks;
+static int failures;
+
+static void check(int ok, const char* what)
+{
+    checks++;
+    if (!ok)
+    {
+        failures++;
+    } /* End of if statement */
+    printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+} /* End of check function */
+
+/* I = 0xFFE, then Fx1E steps it past the end of the 4 KB space and
+ * F165 loads from there. The bytes at both 0x002 and 0x1002 are set
+ * so the test can tell which one was read. */
+static const unsigned char past_end[] = {
+    0xAF, 0xFE,     /* LD I, 0xFFE */
+    0x60, 0x04,     /* LD V0, 4 */
+    0xF0, 0x1E,     /* ADD I, V0 */
+    0xF1, 0x65,     /* LD V1, [I] */
+};
+
+/* I = 0xFFE, then F365 loads four bytes running across 0xFFF */
+static const unsigned char across_end[] = {
+    0xAF, 0xFE,     /* LD I, 0xFFE */
+    0xF3, 0x65,     /* LD V3, [I] */
+};
+
+static void load(struct chip8* chip8, const char* profile, const unsigned char* program, size_t size)
+{
+    chip8_init(chip8);
+    chip8_set_profile(chip8, chip8_profile_find(profile));
+    chip8_load(chip8, (const char*) program, size);
+    chip8->memory.memory[0x000] = 0x10;
+    chip8->memory.memory[0x001] = 0x11;
+    chip8->memory.memory[0x002] = 0x12;
+    chip8->memory.memory[0x003] = 0x13;
+    chip8->memory.memory[0xFFE] = 0x1E;
+    chip8->memory.memory[0xFFF] = 0x1F;
+    chip8->memory.memory[0x1000] = 0x20;
+    chip8->memory.memory[0x1001] = 0x21;
+    chip8->memory.memory[0x1002] = 0x22;
+    chip8->memory.memory[0x1003] = 0x23;
+} /* End of load function */
+
+static void run(struct chip8* chip8, int instructions)
+{
+    for (int i = 0; i < instructions && chip8->fault == CHIP8_FAULT_NONE; i++)
+    {
+        chip8_step(chip8);
+    } /* End of for loop */
+} /* End of run function */
+
+/* XO-CHIP has 64 KB, so the same programs never leave its space */
+static void test_xochip(void)
+{
+    static struct chip8 chip8;
+
+    load(&chip8, "xochip", past_end, sizeof(past_end));
+    run(&chip8, 4);
+    check(chip8.fault == CHIP8_FAULT_NONE && chip8.registers.V[0] == 0x22 && chip8.registers.V[1] == 0x23,
+            "xochip: F165 at I = 0x1002 reads 0x1002");
+
+    load(&chip8, "xochip", across_end, sizeof(across_end));
+    run(&chip8, 2);
+    check(chip8.fault == CHIP8_FAULT_NONE && chip8.registers.V[2] == 0x20 && chip8.registers.V[3] == 0x21,
+            "xochip: F365 at I = 0xFFE reads on past 0xFFF");
+} /* End of test xochip function */
+
+#if CHIP8_MEMORY_POLICY == CHIP8_MEMORY_TRAP
+/* Runs the program in a child, which must die with SIGABRT */
+static int traps(const char* profile, const unsigned char* program, size_t size, int instructions)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        static struct chip8 chip8;
+        freopen("/dev/null", "w", stderr);
+        load(&chip8, profile, program, size);
+        run(&chip8, instructions);
+        exit(0);
+    } /* End of if statement */
+
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+} /* End of traps function */
+#endif
+
+int main(void)
+{
+    static const char* classic[] = { "default", "vip", "schip" };
+    char what[128];
+
+    for (int i = 0; i < 3; i++)
+    {
+#if CHIP8_MEMORY_POLICY == CHIP8_MEMORY_TRAP
+        snprintf(what, sizeof(what), "%s: F165 at I = 0x1002 traps", classic[i]);
+        check(traps(classic[i], past_end, sizeof(past_end), 4), what);
+        snprintf(what, sizeof(what), "%s: F365 at I = 0xFFE traps", classic[i]);
+        check(traps(classic[i], across_end, sizeof(across_end), 2), what);
+#else
+        static struct chip8 chip8;
+        bool report = CHIP8_MEMORY_POLICY == CHIP8_MEMORY_REPORT;
+
+        load(&chip8, classic[i], past_end, sizeof(past_end));
+        run(&chip8, 4);
+        snprintf(what, sizeof(what), "%s: F165 at I = 0x1002 wraps to 0x002", classic[i]);
+        check(chip8.registers.V[0] == 0x12 && chip8.registers.V[1] == 0x13, what);
+        snprintf(what, sizeof(what), "%s: F165 at I = 0x1002 %s", classic[i], report ? "faults" : "does not fault");
+        check(chip8.fault == (report ? CHIP8_FAULT_MEMORY : CHIP8_FAULT_NONE), what);
+
+        load(&chip8, classic[i], across_end, sizeof(across_end));
+        run(&chip8, 2);
+        snprintf(what, sizeof(what), "%s: F365 at I = 0xFFE wraps to 0x000", classic[i]);
+        check(chip8.registers.V[0] == 0x1E && chip8.registers.V[1] == 0x1F
+                && chip8.registers.V[2] == 0x10 && chip8.registers.V[3] == 0x11, what);
+        snprintf(what, sizeof(what), "%s: F365 at I = 0xFFE %s", classic[i], report ? "faults" : "does not fault");
+        check(chip8.fault == (report ? CHIP8_FAULT_MEMORY : CHIP8_FAULT_NONE), what);
+#endif
+    } /* End of for loop */
+
+    test_xochip();
+
+    printf("%d checks, %d failures\n", checks, failures);
+    return failures ? 1 : 0;
+} /* End of main function */
@@ -0,0 +1,80 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8stacktest.c */
+
+#include <stdio.h>
+
+#include "chip8.h"
+
+static int checks;
+static int failures;
+
+static void check(int ok, const char* what)
+{
+    checks++;
+    if (!ok)
+    {
+        failures++;
+    } /* End of if statement */
+    printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+} /* End of check function */
+
+/* Each instruction from 0x200 calls the next one, sixteen deep, and the
+ * returns are run as 00EE from the innermost call at 0x220 */
+static void test_depth(void)
+{
+    static struct chip8 chip8;
+    unsigned char program[CHIP8_TOTAL_STACK_DEPTH * 2];
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++)
+    {
+        unsigned short target = CHIP8_PROGRAM_LOAD_ADDRESS + 2 * (i + 1);
+        program[2 * i] = 0x20 | target >> 8;
+        program[2 * i + 1] = target & 0xff;
+    } /* End of for loop */
+
+    chip8_init(&chip8);
+    chip8_load(&chip8, (const char*) program, sizeof(program));
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++)
+    {
+        chip8_step(&chip8);
+    } /* End of for loop */
+    check(chip8.fault == CHIP8_FAULT_NONE && chip8.registers.SP == CHIP8_TOTAL_STACK_DEPTH
+            && chip8.registers.PC == CHIP8_PROGRAM_LOAD_ADDRESS + 2 * CHIP8_TOTAL_STACK_DEPTH,
+            "16 nested calls fit on the stack");
+
+    int ordered = 1;
+    for (int i = CHIP8_TOTAL_STACK_DEPTH; i > 0; i--)
+    {
+        chip8_exec(&chip8, 0x00EE);
+        ordered &= chip8.registers.PC == CHIP8_PROGRAM_LOAD_ADDRESS + 2 * i;
+    } /* End of for loop */
+    check(ordered && chip8.fault == CHIP8_FAULT_NONE && chip8.registers.SP == 0,
+            "16 returns come back in order");
+
+    chip8_exec(&chip8, 0x00EE);
+    check(chip8.fault == CHIP8_FAULT_STACK_UNDERFLOW, "a 17th return underflows");
+} /* End of test depth function */
+
+static void test_overflow(void)
+{
+    static struct chip8 chip8;
+
+    chip8_init(&chip8);
+    for (int i = 0; i < CHIP8_TOTAL_STACK_DEPTH; i++)
+    {
+        chip8_exec(&chip8, 0x2200);
+    } /* End of for loop */
+    check(chip8.fault == CHIP8_FAULT_NONE, "16 calls do not overflow");
+
+    chip8_exec(&chip8, 0x2200);
+    check(chip8.fault == CHIP8_FAULT_STACK_OVERFLOW && chip8.registers.SP == CHIP8_TOTAL_STACK_DEPTH,
+            "a 17th call overflows");
+} /* End of test overflow function */
+
+int main(void)
+{
+    test_depth();
+    test_overflow();
+
+    printf("%d checks, %d failures\n", checks, failures);
+    return failures ? 1 : 0;
+} /* End of main function */
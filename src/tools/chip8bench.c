@@ -0,0 +1,758 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8bench.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "chip8.h"
+#include "chip8loader.h"
+#include "chip8ngram.h"
+#include "chip8predecode.h"
+#include "chip8scheduler.h"
+#include "chip8scale.h"
+#include "chip8script.h"
+#include "chip8snapshot.h"
+
+#define BENCH_REPETITIONS 7
+#define BENCH_ITERATIONS 1000000
+#define BENCH_DEFAULT_FRAMES 600
+#define BENCH_MAX_SCALE 20
+#define BENCH_DEFAULT_FUSE 16
+
+typedef void (*bench_fn)(void* ctx, unsigned long iterations);
+
+struct bench_stats
+{
+    double ns_per_op;
+    double variance;
+}; /* End bench stats struct */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+} /* End of now ns function */
+
+/* Times BENCH_REPETITIONS batches of ops after one untimed warm up batch.
+ * The variance is taken over the per-batch ns/op figures. */
+static struct bench_stats bench_measure(bench_fn fn, void* ctx, unsigned long iterations, unsigned long ops)
+{
+    double samples[BENCH_REPETITIONS];
+    struct bench_stats stats = { 0, 0 };
+
+    fn(ctx, iterations);
+    for (int i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        double start = now_ns();
+        fn(ctx, iterations);
+        samples[i] = (now_ns() - start) / ops;
+        stats.ns_per_op += samples[i];
+    } /* End of for loop */
+    stats.ns_per_op /= BENCH_REPETITIONS;
+
+    for (int i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        stats.variance += (samples[i] - stats.ns_per_op) * (samples[i] - stats.ns_per_op);
+    } /* End of for loop */
+    stats.variance /= BENCH_REPETITIONS - 1;
+    return stats;
+} /* End of bench measure function */
+
+static int bench_first = 1;
+
+static void bench_report(const char* group, const char* name, unsigned long ops, struct bench_stats stats)
+{
+    printf("%s    {\"group\": \"%s\", \"name\": \"%s\", \"ops\": %lu, \"ns_per_op\": %.3f, "
+            "\"ns_per_op_variance\": %.5f, \"ops_per_second\": %.0f}",
+            bench_first ? "" : ",\n", group, name, ops, stats.ns_per_op, stats.variance,
+            stats.ns_per_op > 0 ? 1e9 / stats.ns_per_op : 0);
+    bench_first = 0;
+} /* End of bench report function */
+
+static void bench_run(const char* group, const char* name, bench_fn fn, void* ctx, unsigned long iterations, unsigned long ops)
+{
+    bench_report(group, name, ops, bench_measure(fn, ctx, iterations, ops));
+} /* End of bench run function */
+
+/* Opcode classes, with x = 1 and y = 2. Calls are paired with a return so
+ * the stack never overflows. hires runs the class in 128x64 mode and
+ * profile, when set, under that quirk profile. */
+struct bench_opcode
+{
+    const char* name;
+    unsigned short opcodes[2];
+    int count;
+    bool hires;
+    const char* profile;
+    struct chip8 chip8;
+}; /* End bench opcode struct */
+
+static struct bench_opcode bench_opcodes[] = {
+    { "00E0", { 0x00E0 }, 1 },
+    { "00C1", { 0x00C1 }, 1 },
+    { "00C1/hires", { 0x00C1 }, 1, true },
+    { "00FB", { 0x00FB }, 1 },
+    { "00FB/hires", { 0x00FB }, 1, true },
+    { "00FC", { 0x00FC }, 1 },
+    { "00FC/hires", { 0x00FC }, 1, true },
+    { "2nnn+00EE", { 0x2300, 0x00EE }, 2 },
+    { "1nnn", { 0x1300 }, 1 },
+    { "3xkk", { 0x3107 }, 1 },
+    { "4xkk", { 0x4107 }, 1 },
+    { "5xy0", { 0x5120 }, 1 },
+    { "5xy2", { 0x5122 }, 1 },
+    { "5xy2/descending", { 0x5212 }, 1 },
+    { "5xy3", { 0x5123 }, 1 },
+    { "6xkk", { 0x6107 }, 1 },
+    { "7xkk", { 0x7107 }, 1 },
+    { "8xy0", { 0x8120 }, 1 },
+    { "8xy1", { 0x8121 }, 1 },
+    { "8xy1/vip", { 0x8121 }, 1, false, "vip" },
+    { "8xy2", { 0x8122 }, 1 },
+    { "8xy3", { 0x8123 }, 1 },
+    { "8xy4", { 0x8124 }, 1 },
+    { "8xy5", { 0x8125 }, 1 },
+    { "8xy6", { 0x8126 }, 1 },
+    { "8xy6/vip", { 0x8126 }, 1, false, "vip" },
+    { "8xy7", { 0x8127 }, 1 },
+    { "8xyE", { 0x812E }, 1 },
+    { "9xy0", { 0x9120 }, 1 },
+    { "Annn", { 0xA300 }, 1 },
+    { "Bnnn", { 0xB300 }, 1 },
+    { "Bnnn/schip", { 0xB300 }, 1, false, "schip" },
+    { "Cxkk", { 0xC1FF }, 1 },
+    { "Dxyn", { 0xD125 }, 1 },
+    { "Dxyn/hires", { 0xD125 }, 1, true },
+    { "Dxyn/schip", { 0xD125 }, 1, false, "schip" },
+    { "Dxy0/hires", { 0xD120 }, 1, true },
+    { "F301+Dxyn", { 0xF301, 0xD125 }, 2 },
+    { "Ex9E", { 0xE19E }, 1 },
+    { "F000+1nnn", { 0xF000, 0x1300 }, 2 },
+    { "F002", { 0xF002 }, 1 },
+    { "ExA1", { 0xE1A1 }, 1 },
+    { "Fx07", { 0xF107 }, 1 },
+    { "Fx0A", { 0xF10A }, 1 },
+    { "Fx15", { 0xF115 }, 1 },
+    { "Fx18", { 0xF118 }, 1 },
+    { "Fx1E+Annn", { 0xF11E, 0xA300 }, 2 },
+    { "Fx29", { 0xF129 }, 1 },
+    { "Fx30", { 0xF130 }, 1 },
+    { "Fx33", { 0xF133 }, 1 },
+    { "Fx3A", { 0xF13A }, 1 },
+    { "Fx55", { 0xFF55 }, 1 },
+    { "Fx55+Annn/vip", { 0xFF55, 0xA300 }, 2, false, "vip" },
+    { "Fx65", { 0xFF65 }, 1 },
+};
+
+static void bench_exec(void* ctx, unsigned long iterations)
+{
+    struct bench_opcode* op = ctx;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        for (int j = 0; j < op->count; j++)
+        {
+            chip8_exec(&op->chip8, op->opcodes[j]);
+        } /* End of nested for loop */
+    } /* End of for loop */
+} /* End of bench exec function */
+
+struct bench_sprite
+{
+    struct chip8_screen screen;
+    const char* sprite;
+    int x;
+    int y;
+    bool clip;
+}; /* End bench sprite struct */
+
+static void bench_draw_sprite(void* ctx, unsigned long iterations)
+{
+    struct bench_sprite* s = ctx;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        chip8_screen_draw_sprite(&s->screen, s->x, s->y, s->sprite, 15, s->clip);
+    } /* End of for loop */
+} /* End of bench draw sprite function */
+
+/* Draw-heavy case : each iteration draws the next sprite of a sweep that
+ * visits every origin on the screen, so edge placements show up in
+ * proportion to their share of the screen. wide draws 16x16 sprites. */
+struct bench_sweep
+{
+    struct chip8_screen screen;
+    const char* sprite;
+    bool hires;
+    bool wide;
+    bool clip;
+}; /* End bench sweep struct */
+
+static void bench_draw_sweep(void* ctx, unsigned long iterations)
+{
+    struct bench_sweep* s = ctx;
+    int width = chip8_screen_width(&s->screen);
+    int height = chip8_screen_height(&s->screen);
+    int x = 0;
+    int y = 0;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        if (s->wide)
+        {
+            chip8_screen_draw_sprite16(&s->screen, x, y, s->sprite, s->clip);
+        }
+        else
+        {
+            chip8_screen_draw_sprite(&s->screen, x, y, s->sprite, 15, s->clip);
+        } /* End of if else statement */
+        if (++x == width)
+        {
+            x = 0;
+            y = y + 1 == height ? 0 : y + 1;
+        } /* End of if statement */
+    } /* End of for loop */
+} /* End of bench draw sweep function */
+
+/* A hi-res frame expanded to 32-bit colours at scale */
+struct bench_scale
+{
+    struct chip8_frame frame;
+    int scale;
+    uint32_t pixels[CHIP8_HIRES_WIDTH * BENCH_MAX_SCALE * CHIP8_HIRES_HEIGHT * BENCH_MAX_SCALE];
+}; /* End bench scale struct */
+
+static void bench_scale_rgba(void* ctx, unsigned long iterations)
+{
+    static const uint32_t palette[4] = { 0xff000000, 0xffffffff, 0xffaaaaaa, 0xff555555 };
+    struct bench_scale* s = ctx;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        chip8_scale_rgba(&s->frame, palette, s->scale, s->pixels, CHIP8_HIRES_WIDTH * s->scale * sizeof(uint32_t));
+    } /* End of for loop */
+} /* End of bench scale rgba function */
+
+static void bench_memory_get_short(void* ctx, unsigned long iterations)
+{
+    struct chip8* chip8 = ctx;
+    unsigned short sum = 0;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        sum += chip8_memory_get_short(&chip8->memory, CHIP8_CLASSIC_MEMORY_SIZE, 0x200 + (i & 0x3fe));
+    } /* End of for loop */
+    chip8->registers.I = sum;
+} /* End of bench memory get short function */
+
+static void bench_init(void* ctx, unsigned long iterations)
+{
+    struct chip8* chip8 = ctx;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        chip8_init(chip8);
+    } /* End of for loop */
+} /* End of bench init function */
+
+/* Rewinds after every step, either by copying the whole machine back or
+ * by restoring only the pages written since the snapshot */
+struct bench_snapshot
+{
+    struct chip8 chip8;
+    struct chip8_snapshot snapshot;
+    unsigned short opcode;
+    bool incremental;
+}; /* End bench snapshot struct */
+
+static void bench_snapshot_restore(void* ctx, unsigned long iterations)
+{
+    struct bench_snapshot* s = ctx;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        if (s->opcode)
+        {
+            chip8_exec(&s->chip8, s->opcode);
+        }
+        else
+        {
+            chip8_run_frame(&s->chip8);
+        } /* End of if statement */
+
+        if (s->incremental)
+        {
+            chip8_snapshot_restore(&s->snapshot, &s->chip8);
+        }
+        else
+        {
+            s->chip8 = s->snapshot.state;
+        } /* End of if statement */
+    } /* End of for loop */
+} /* End of bench snapshot restore function */
+
+struct bench_rom
+{
+    struct chip8 chip8;
+    char* buf;
+    size_t size;
+    struct chip8_script script;
+    bool has_script;
+    struct chip8_scheduler scheduler;
+    bool frame_events;
+    struct chip8_predecode* predecode;
+    char path[1024];
+    const struct chip8_profile* profile;
+    struct chip8_trace* trace;
+}; /* End bench rom struct */
+
+/* Puts the ROM back at power on under its quirk profile */
+static void bench_rom_reset(struct bench_rom* rom)
+{
+    chip8_init(&rom->chip8);
+    chip8_load(&rom->chip8, rom->buf, rom->size);
+    chip8_set_profile(&rom->chip8, rom->profile);
+    chip8_script_rewind(&rom->script);
+} /* End of bench rom reset function */
+
+static void bench_load(void* ctx, unsigned long iterations)
+{
+    struct bench_rom* rom = ctx;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        chip8_load(&rom->chip8, rom->buf, rom->size);
+    } /* End of for loop */
+} /* End of bench load function */
+
+static void bench_load_file(void* ctx, unsigned long iterations)
+{
+    struct bench_rom* rom = ctx;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        chip8_load_file(&rom->chip8, rom->path);
+    } /* End of for loop */
+} /* End of bench load file function */
+
+/* iterations is the frame count; every repetition restarts the ROM */
+static void bench_rom_frames(void* ctx, unsigned long iterations)
+{
+    struct bench_rom* rom = ctx;
+    bench_rom_reset(rom);
+
+    for (unsigned long frame = 0; frame < iterations; frame++)
+    {
+        if (rom->has_script)
+        {
+            chip8_script_apply(&rom->script, &rom->chip8, frame);
+        } /* End of if statement */
+        chip8_run_frame(&rom->chip8);
+    } /* End of for loop */
+} /* End of bench rom frames function */
+
+/* The same frames with a trace attached, which records every
+ * instruction and runs the idle waits instead of skipping them */
+static void bench_rom_traced(void* ctx, unsigned long iterations)
+{
+    struct bench_rom* rom = ctx;
+    bench_rom_reset(rom);
+    chip8_trace_reset(rom->trace);
+    rom->chip8.trace = rom->trace;
+
+    for (unsigned long frame = 0; frame < iterations; frame++)
+    {
+        if (rom->has_script)
+        {
+            chip8_script_apply(&rom->script, &rom->chip8, frame);
+        } /* End of if statement */
+        chip8_run_frame(&rom->chip8);
+    } /* End of for loop */
+    rom->chip8.trace = NULL;
+} /* End of bench rom traced function */
+
+static int bench_frame_event(void* context, struct chip8* chip8, const struct chip8_event* event)
+{
+    (void) context;
+    (void) chip8;
+    (void) event;
+    return 0;
+} /* End of bench frame event function */
+
+/* The same run driven by the scheduler, the script's key presses queued
+ * as events and, with frame_events set, a no-op frame event at every
+ * frame boundary. Without frame events the core runs straight from one
+ * key press to the next. */
+static void bench_rom_scheduled(void* ctx, unsigned long iterations)
+{
+    struct bench_rom* rom = ctx;
+    bench_rom_reset(rom);
+    chip8_scheduler_clear(&rom->scheduler);
+    if (rom->has_script)
+    {
+        chip8_script_schedule(&rom->script, &rom->scheduler);
+    } /* End of if statement */
+    if (rom->frame_events)
+    {
+        chip8_scheduler_push(&rom->scheduler, 0, CHIP8_CYCLES_PER_FRAME, CHIP8_EVENT_FRAME, 0);
+    } /* End of if statement */
+    chip8_scheduler_run(&rom->scheduler, &rom->chip8, (unsigned long long) iterations * CHIP8_CYCLES_PER_FRAME);
+} /* End of bench rom scheduled function */
+
+/* The same frames run over a decode cache, fused or not depending on
+ * the cache. The cache outlives the repetitions, as it would a session. */
+static void bench_rom_predecoded(void* ctx, unsigned long iterations)
+{
+    struct bench_rom* rom = ctx;
+    bench_rom_reset(rom);
+
+    for (unsigned long frame = 0; frame < iterations; frame++)
+    {
+        if (rom->has_script)
+        {
+            chip8_script_apply(&rom->script, &rom->chip8, frame);
+        } /* End of if statement */
+        chip8_predecode_run_frame(rom->predecode, &rom->chip8);
+    } /* End of for loop */
+} /* End of bench rom predecoded function */
+
+static char* read_file(const char* filename, size_t* size)
+{
+    FILE* f = fopen(filename, "rb");
+    if (!f)
+    {
+        return NULL;
+    } /* End of if statement */
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char* buf = malloc(len > 0 ? len : 1);
+    if (!buf || (len > 0 && fread(buf, len, 1, f) != 1))
+    {
+        free(buf);
+        fclose(f);
+        return NULL;
+    } /* End of if statement */
+
+    fclose(f);
+    *size = len;
+    return buf;
+} /* End of read file function */
+
+static void bench_core(void)
+{
+    for (size_t i = 0; i < sizeof(bench_opcodes) / sizeof(bench_opcodes[0]); i++)
+    {
+        struct bench_opcode* op = &bench_opcodes[i];
+        chip8_init(&op->chip8);
+        chip8_screen_set_hires(&op->chip8.screen, op->hires);
+        if (op->profile)
+        {
+            chip8_set_profile(&op->chip8, chip8_profile_find(op->profile));
+        } /* End of if statement */
+        op->chip8.registers.PC = CHIP8_PROGRAM_LOAD_ADDRESS;
+        op->chip8.registers.I = 0x300;
+        op->chip8.registers.V[1] = 0x37;
+        op->chip8.registers.V[2] = 0x15;
+        bench_run("exec", op->name, bench_exec, op, BENCH_ITERATIONS, BENCH_ITERATIONS * op->count);
+    } /* End of for loop */
+
+    static const char sprite[15] = {
+        0xff, 0x81, 0xbd, 0xa5, 0xa5, 0xbd, 0x81, 0xff, 0x3c, 0x42, 0x81, 0x81, 0x42, 0x3c, 0x18
+    };
+    struct bench_sprite aligned = { .sprite = sprite, .x = 8, .y = 4 };
+    struct bench_sprite unaligned = { .sprite = sprite, .x = 11, .y = 4 };
+    struct bench_sprite wrapping = { .sprite = sprite, .x = CHIP8_WIDTH - 3, .y = CHIP8_HEIGHT - 6 };
+    struct bench_sprite clipping = { .sprite = sprite, .x = CHIP8_WIDTH - 3, .y = CHIP8_HEIGHT - 6, .clip = true };
+    chip8_screen_init(&aligned.screen);
+    chip8_screen_init(&unaligned.screen);
+    chip8_screen_init(&wrapping.screen);
+    chip8_screen_init(&clipping.screen);
+    bench_run("draw_sprite", "aligned", bench_draw_sprite, &aligned, BENCH_ITERATIONS, BENCH_ITERATIONS);
+    bench_run("draw_sprite", "unaligned", bench_draw_sprite, &unaligned, BENCH_ITERATIONS, BENCH_ITERATIONS);
+    bench_run("draw_sprite", "wrapping", bench_draw_sprite, &wrapping, BENCH_ITERATIONS, BENCH_ITERATIONS);
+    bench_run("draw_sprite", "clipping", bench_draw_sprite, &clipping, BENCH_ITERATIONS, BENCH_ITERATIONS);
+
+    static const char sprite16[32] = {
+        0xff, 0xff, 0x80, 0x01, 0xbf, 0xfd, 0xa0, 0x05, 0xa7, 0xe5, 0xa4, 0x25, 0xa5, 0xa5, 0xa5, 0xa5,
+        0xa5, 0xa5, 0xa5, 0xa5, 0xa4, 0x25, 0xa7, 0xe5, 0xa0, 0x05, 0xbf, 0xfd, 0x80, 0x01, 0xff, 0xff
+    };
+    static struct bench_sweep sweeps[] = {
+        { .hires = false, .wide = false, .clip = false },
+        { .hires = false, .wide = false, .clip = true },
+        { .hires = true, .wide = false, .clip = false },
+        { .hires = true, .wide = false, .clip = true },
+        { .hires = true, .wide = true, .clip = false },
+        { .hires = true, .wide = true, .clip = true },
+    };
+    for (size_t i = 0; i < sizeof(sweeps) / sizeof(sweeps[0]); i++)
+    {
+        struct bench_sweep* s = &sweeps[i];
+        char name[32];
+        snprintf(name, sizeof(name), "sweep%s%s/%s", s->hires ? "/hires" : "", s->wide ? "/16x16" : "", s->clip ? "clip" : "wrap");
+        s->sprite = s->wide ? sprite16 : sprite;
+        chip8_screen_init(&s->screen);
+        chip8_screen_set_hires(&s->screen, s->hires);
+        bench_run("draw_sprite", name, bench_draw_sweep, s, BENCH_ITERATIONS, BENCH_ITERATIONS);
+    } /* End of for loop */
+
+    static struct chip8 chip8;
+    chip8_init(&chip8);
+    bench_run("memory", "get_short", bench_memory_get_short, &chip8, BENCH_ITERATIONS * 10, BENCH_ITERATIONS * 10);
+    bench_run("lifecycle", "init", bench_init, &chip8, BENCH_ITERATIONS / 10, BENCH_ITERATIONS / 10);
+
+    /* Fx55 with I = 0x300 dirties a single page */
+    static struct bench_snapshot snapshot;
+    chip8_init(&snapshot.chip8);
+    snapshot.chip8.registers.I = 0x300;
+    chip8_snapshot_take(&snapshot.snapshot, &snapshot.chip8);
+    snapshot.opcode = 0xF555;
+    snapshot.incremental = false;
+    bench_run("snapshot", "Fx55/full", bench_snapshot_restore, &snapshot, BENCH_ITERATIONS, BENCH_ITERATIONS);
+    snapshot.incremental = true;
+    bench_run("snapshot", "Fx55/incremental", bench_snapshot_restore, &snapshot, BENCH_ITERATIONS, BENCH_ITERATIONS);
+
+    /* Both planes of a hi-res screen filled with a sweep of sprites, so
+     * every colour shows up; one op is one frame */
+    static struct bench_scale scale;
+    chip8_init(&chip8);
+    chip8_screen_set_hires(&chip8.screen, true);
+    chip8_screen_select_planes(&chip8.screen, 3);
+    for (int i = 0; i < CHIP8_HIRES_WIDTH * CHIP8_HIRES_HEIGHT / 16; i++)
+    {
+        chip8_screen_draw_sprite(&chip8.screen, i * 5, i * 3, sprite, 7, false);
+    } /* End of for loop */
+    chip8_frame_capture(&scale.frame, &chip8, 0);
+    for (scale.scale = 1; scale.scale <= BENCH_MAX_SCALE; scale.scale++)
+    {
+        char name[32];
+        unsigned long frames = BENCH_ITERATIONS / 100 / (scale.scale * scale.scale);
+        snprintf(name, sizeof(name), "rgba/x%d", scale.scale);
+        bench_run("scale", name, bench_scale_rgba, &scale, frames ? frames : 1, frames ? frames : 1);
+    } /* End of for loop */
+} /* End of bench core function */
+
+/* One frame of the ROM followed by a rewind to the state it reached
+ * after running frames frames */
+static void bench_snapshot_rom(const char* path, struct bench_rom* rom, unsigned long frames)
+{
+    static struct bench_snapshot snapshot;
+    char name[1100];
+
+    bench_rom_frames(rom, frames);
+    snapshot.chip8 = rom->chip8;
+    chip8_snapshot_take(&snapshot.snapshot, &snapshot.chip8);
+    snapshot.opcode = 0;
+
+    snapshot.incremental = false;
+    snprintf(name, sizeof(name), "%s/full", path);
+    bench_run("snapshot", name, bench_snapshot_restore, &snapshot, BENCH_ITERATIONS / 10, BENCH_ITERATIONS / 10);
+    snapshot.incremental = true;
+    snprintf(name, sizeof(name), "%s/incremental", path);
+    bench_run("snapshot", name, bench_snapshot_restore, &snapshot, BENCH_ITERATIONS / 10, BENCH_ITERATIONS / 10);
+} /* End of bench snapshot rom function */
+
+/* Counts how many rows the ROM marks dirty per frame, how many of those
+ * really changed, and how many frames touch the screen at all */
+static void bench_dirty_rows(const char* path, struct bench_rom* rom, unsigned long frames)
+{
+    static struct chip8_screen previous;
+    unsigned long long dirty = 0;
+    unsigned long long changed = 0;
+    unsigned long frames_drawn = 0;
+
+    bench_rom_reset(rom);
+    previous = rom->chip8.screen;
+
+    for (unsigned long frame = 0; frame < frames; frame++)
+    {
+        if (rom->has_script)
+        {
+            chip8_script_apply(&rom->script, &rom->chip8, frame);
+        } /* End of if statement */
+        chip8_run_frame(&rom->chip8);
+
+        unsigned long long rows = chip8_screen_take_dirty_rows(&rom->chip8.screen);
+        dirty += __builtin_popcountll(rows);
+        frames_drawn += rows != 0;
+        for (int y = 0; y < CHIP8_HIRES_HEIGHT; y++)
+        {
+            bool row_changed = false;
+            for (int plane = 0; plane < CHIP8_SCREEN_PLANES; plane++)
+            {
+                row_changed |= memcmp(previous.rows[plane][y], rom->chip8.screen.rows[plane][y], sizeof(previous.rows[plane][y])) != 0;
+            } /* End of nested for loop */
+            changed += row_changed;
+        } /* End of for loop */
+        previous = rom->chip8.screen;
+    } /* End of for loop */
+
+    printf(",\n    {\"group\": \"screen\", \"name\": \"%s\", \"frames\": %lu, \"frames_drawn\": %lu, "
+            "\"dirty_rows_per_frame\": %.3f, \"changed_rows_per_frame\": %.3f}",
+            path, frames, frames_drawn, frames ? (double) dirty / frames : 0, frames ? (double) changed / frames : 0);
+} /* End of bench dirty rows function */
+
+/* ROM arguments are PATH or PATH:SCRIPT. Without a profile each ROM
+ * runs under the profile its file extension implies. With a fusion
+ * every ROM is also run predecoded with it. */
+static int bench_roms(int argc, char** argv, unsigned long frames, const struct chip8_profile* profile,
+        const struct chip8_fusion* fusion, struct chip8_trace* trace, const char* trace_filename)
+{
+    static struct bench_rom rom;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            continue;
+        } /* End of if statement */
+
+        char path[1024];
+        char name[1100];
+        snprintf(path, sizeof(path), "%s", argv[i]);
+        char* script = strchr(path, ':');
+        if (script)
+        {
+            *script++ = '\0';
+        } /* End of if statement */
+
+        memset(&rom, 0, sizeof(rom));
+        rom.buf = read_file(path, &rom.size);
+        chip8_init(&rom.chip8);
+        if (!rom.buf || chip8_load(&rom.chip8, rom.buf, rom.size) != CHIP8_LOAD_OK)
+        {
+            fprintf(stderr, "Failed to load ROM %s\n", path);
+            free(rom.buf);
+            return -1;
+        } /* End of if statement */
+        if (script)
+        {
+            if (chip8_script_load(&rom.script, script) != 0)
+            {
+                fprintf(stderr, "Failed to load input script %s\n", script);
+                free(rom.buf);
+                return -1;
+            } /* End of nested if statement */
+            rom.has_script = true;
+        } /* End of if statement */
+        rom.profile = profile ? profile : chip8_profile_for_file(path);
+
+        bench_run("load", path, bench_load, &rom, BENCH_ITERATIONS / 10, BENCH_ITERATIONS / 10);
+        snprintf(rom.path, sizeof(rom.path), "%s", path);
+        bench_run("load_file", path, bench_load_file, &rom, BENCH_ITERATIONS / 100, BENCH_ITERATIONS / 100);
+        bench_run("rom", path, bench_rom_frames, &rom, frames, frames * CHIP8_CYCLES_PER_FRAME);
+        if (trace)
+        {
+            snprintf(name, sizeof(name), "%s/traced", path);
+            rom.trace = trace;
+            bench_run("rom", name, bench_rom_traced, &rom, frames, frames * CHIP8_CYCLES_PER_FRAME);
+            if (trace_filename && chip8_trace_flush(trace, trace_filename) != 0)
+            {
+                fprintf(stderr, "Failed to write trace to %s\n", trace_filename);
+            } /* End of nested if statement */
+        } /* End of if statement */
+        if (chip8_scheduler_init(&rom.scheduler, rom.script.count + 1, bench_frame_event, NULL) == 0)
+        {
+            snprintf(name, sizeof(name), "%s/scheduled", path);
+            rom.frame_events = false;
+            bench_run("rom", name, bench_rom_scheduled, &rom, frames, frames * CHIP8_CYCLES_PER_FRAME);
+            snprintf(name, sizeof(name), "%s/scheduled/frame_events", path);
+            rom.frame_events = true;
+            bench_run("rom", name, bench_rom_scheduled, &rom, frames, frames * CHIP8_CYCLES_PER_FRAME);
+            chip8_scheduler_free(&rom.scheduler);
+        } /* End of if statement */
+
+        struct chip8_predecode predecode;
+        rom.predecode = &predecode;
+        if (chip8_predecode_init(&predecode, NULL) == 0)
+        {
+            snprintf(name, sizeof(name), "%s/predecode", path);
+            bench_run("rom", name, bench_rom_predecoded, &rom, frames, frames * CHIP8_CYCLES_PER_FRAME);
+            chip8_predecode_free(&predecode);
+        } /* End of if statement */
+        if (fusion && chip8_predecode_init(&predecode, fusion) == 0)
+        {
+            snprintf(name, sizeof(name), "%s/fused", path);
+            bench_run("rom", name, bench_rom_predecoded, &rom, frames, frames * CHIP8_CYCLES_PER_FRAME);
+            chip8_predecode_free(&predecode);
+        } /* End of if statement */
+        bench_snapshot_rom(path, &rom, frames);
+        bench_dirty_rows(path, &rom, frames);
+
+        chip8_script_free(&rom.script);
+        free(rom.buf);
+    } /* End of for loop */
+    return 0;
+} /* End of bench roms function */
+
+int main(int argc, char** argv)
+{
+    unsigned long frames = BENCH_DEFAULT_FRAMES;
+    const struct chip8_profile* profile = NULL;
+    const char* ngrams_file = NULL;
+    int fuse = BENCH_DEFAULT_FUSE;
+    const char* trace_option = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--frames=", 9) == 0)
+        {
+            frames = strtoul(argv[i] + 9, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--ngrams=", 9) == 0)
+        {
+            ngrams_file = argv[i] + 9;
+        }
+        else if (strncmp(argv[i], "--fuse=", 7) == 0)
+        {
+            fuse = atoi(argv[i] + 7);
+        }
+        else if (strncmp(argv[i], "--trace=", 8) == 0)
+        {
+            trace_option = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--profile=", 10) == 0 && chip8_profile_find(argv[i] + 10))
+        {
+            profile = chip8_profile_find(argv[i] + 10);
+        }
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            fprintf(stderr, "Usage: %s [--frames=N] [--profile=NAME] [--ngrams=FILE [--fuse=N]] [--trace=FILE] [ROM[:SCRIPT]]...\n", argv[0]);
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    /* The runs to fuse come from a profile saved by ngrams */
+    struct chip8_fusion fusion;
+    if (ngrams_file)
+    {
+        struct chip8_ngrams ngrams;
+        int res = chip8_ngrams_init(&ngrams);
+        if (res == 0)
+        {
+            res = chip8_ngrams_load(&ngrams, ngrams_file);
+        } /* End of if statement */
+        if (res == 0)
+        {
+            res = chip8_fusion_select(&fusion, &ngrams, fuse);
+        } /* End of if statement */
+        chip8_ngrams_free(&ngrams);
+        if (res < 0)
+        {
+            fprintf(stderr, "Failed to load n-grams from %s\n", ngrams_file);
+            return -1;
+        } /* End of if statement */
+    } /* End of if statement */
+
+    /* Every ROM also runs with a trace attached; with --trace=FILE or
+     * CHIP8_TRACE=FILE the last ROM's traced run is written there */
+    static struct chip8_trace trace;
+    const char* trace_filename = chip8_trace_start(&trace, trace_option);
+    bool traced = trace_filename || chip8_trace_init(&trace, CHIP8_TRACE_DEFAULT_CAPACITY) == 0;
+
+    printf("{\n  \"cycles_per_frame\": %d,\n  \"repetitions\": %d,\n  \"benchmarks\": [\n",
+            CHIP8_CYCLES_PER_FRAME, BENCH_REPETITIONS);
+    bench_core();
+    int res = bench_roms(argc, argv, frames, profile, ngrams_file ? &fusion : NULL,
+            traced ? &trace : NULL, trace_filename);
+    printf("\n  ]\n}\n");
+    if (traced)
+    {
+        chip8_trace_free(&trace);
+    } /* End of if statement */
+    return res;
+} /* End of main function */
@@ -0,0 +1,223 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8conformance.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8.h"
+#include "chip8hash.h"
+#include "chip8loader.h"
+#include "chip8scheduler.h"
+#include "chip8script.h"
+
+/* A manifest has one run per line:
+ *     ROM FRAMES SCRIPT|- SCREEN_HASH REGISTERS_HASH MEMORY_HASH
+ * with paths relative to the manifest and hashes in hex. With --record the
+ * hash columns may be omitted and the manifest is printed back with the
+ * computed values filled in. */
+struct conformance_run
+{
+    char rom[512];
+    unsigned long frames;
+    char script[512];
+    struct chip8_hashes expected;
+    int has_expected;
+}; /* End conformance run struct */
+
+/* With --trace=FILE or CHIP8_TRACE=FILE every run is traced, and the
+ * last instructions of a failing run are written to the file */
+static struct chip8_trace conformance_trace;
+static const char* conformance_trace_filename;
+
+static void resolve(char* out, size_t size, const char* dir, const char* path)
+{
+    if (path[0] == '/' || dir[0] == '\0')
+    {
+        snprintf(out, size, "%s", path);
+    }
+    else
+    {
+        snprintf(out, size, "%s/%s", dir, path);
+    } /* End of if statement */
+} /* End of resolve function */
+
+static int parse_run(const char* line, struct conformance_run* run)
+{
+    int fields = sscanf(line, "%511s %lu %511s %llx %llx %llx", run->rom, &run->frames, run->script,
+            &run->expected.screen, &run->expected.registers, &run->expected.memory);
+    if (fields != 3 && fields != 6)
+    {
+        return -1;
+    } /* End of if statement */
+    run->has_expected = fields == 6;
+    return 0;
+} /* End of parse run function */
+
+static int execute_run(const char* dir, const struct conformance_run* run, struct chip8_hashes* hashes)
+{
+    static struct chip8 chip8;
+    char path[1024];
+
+    chip8_init(&chip8);
+    resolve(path, sizeof(path), dir, run->rom);
+    enum chip8_load_result res = chip8_load_file(&chip8, path);
+    if (res != CHIP8_LOAD_OK)
+    {
+        fprintf(stderr, "%s: %s\n", path, chip8_load_result_name(res));
+        return -1;
+    } /* End of if statement */
+    chip8_set_profile(&chip8, chip8_profile_for_file(path));
+    if (conformance_trace_filename)
+    {
+        chip8_trace_reset(&conformance_trace);
+        chip8.trace = &conformance_trace;
+    } /* End of if statement */
+
+    struct chip8_script script = { 0 };
+    if (strcmp(run->script, "-") != 0)
+    {
+        resolve(path, sizeof(path), dir, run->script);
+        if (chip8_script_load(&script, path) != 0)
+        {
+            fprintf(stderr, "%s: failed to load input script\n", path);
+            return -1;
+        } /* End of nested if statement */
+    } /* End of if statement */
+
+    /* The script's key presses are the only events, so the core runs
+     * straight from one to the next */
+    struct chip8_scheduler scheduler;
+    if (chip8_scheduler_init(&scheduler, script.count, NULL, NULL) != 0
+            || chip8_script_schedule(&script, &scheduler) != 0)
+    {
+        fprintf(stderr, "%s: cannot schedule input script\n", path);
+        chip8_script_free(&script);
+        return -1;
+    } /* End of if statement */
+    chip8_scheduler_run(&scheduler, &chip8, (unsigned long long) run->frames * CHIP8_CYCLES_PER_FRAME);
+    chip8_scheduler_free(&scheduler);
+    chip8_script_free(&script);
+
+    chip8_hash(&chip8, hashes);
+    return 0;
+} /* End of execute run function */
+
+int main(int argc, char** argv)
+{
+    const char* manifest = NULL;
+    const char* trace = NULL;
+    int record = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0)
+        {
+            record = 1;
+        }
+        else if (strncmp(argv[i], "--trace=", 8) == 0)
+        {
+            trace = argv[i] + 8;
+        }
+        else if (!manifest && argv[i][0] != '-')
+        {
+            manifest = argv[i];
+        }
+        else
+        {
+            manifest = NULL;
+            break;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    if (!manifest)
+    {
+        printf("Usage: %s [--record] [--trace=FILE] MANIFEST\n", argv[0]);
+        return -1;
+    } /* End of if statement */
+    conformance_trace_filename = chip8_trace_start(&conformance_trace, trace);
+
+    FILE* f = fopen(manifest, "r");
+    if (!f)
+    {
+        printf("Failed to open manifest!\n");
+        return -1;
+    } /* End of if statement */
+
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", manifest);
+    char* slash = strrchr(dir, '/');
+    if (slash)
+    {
+        *slash = '\0';
+    }
+    else
+    {
+        dir[0] = '\0';
+    } /* End of if statement */
+
+    int runs = 0;
+    int failures = 0;
+    char line[2048];
+    while (fgets(line, sizeof(line), f))
+    {
+        struct conformance_run run;
+        struct chip8_hashes actual;
+
+        if (line[0] == '#' || strspn(line, " \t\r\n") == strlen(line))
+        {
+            if (record)
+            {
+                fputs(line, stdout);
+            } /* End of nested if statement */
+            continue;
+        } /* End of if statement */
+
+        if (parse_run(line, &run) != 0 || (!record && !run.has_expected))
+        {
+            fprintf(stderr, "Malformed manifest line: %s", line);
+            failures++;
+            continue;
+        } /* End of if statement */
+
+        runs++;
+        if (execute_run(dir, &run, &actual) != 0)
+        {
+            failures++;
+            continue;
+        } /* End of if statement */
+
+        if (record)
+        {
+            printf("%s %lu %s %016llx %016llx %016llx\n", run.rom, run.frames, run.script,
+                    actual.screen, actual.registers, actual.memory);
+            continue;
+        } /* End of if statement */
+
+        int ok = actual.screen == run.expected.screen
+            && actual.registers == run.expected.registers
+            && actual.memory == run.expected.memory;
+        printf("%-4s %s (%lu frames)\n", ok ? "ok" : "FAIL", run.rom, run.frames);
+        if (!ok)
+        {
+            printf("     screen    %016llx expected %016llx\n", actual.screen, run.expected.screen);
+            printf("     registers %016llx expected %016llx\n", actual.registers, run.expected.registers);
+            printf("     memory    %016llx expected %016llx\n", actual.memory, run.expected.memory);
+            if (conformance_trace_filename && chip8_trace_flush(&conformance_trace, conformance_trace_filename) == 0)
+            {
+                printf("     trace     %s\n", conformance_trace_filename);
+            } /* End of nested if statement */
+            failures++;
+        } /* End of nested if statement */
+    } /* End of while loop */
+    fclose(f);
+    if (conformance_trace_filename)
+    {
+        chip8_trace_free(&conformance_trace);
+    } /* End of if statement */
+
+    if (!record)
+    {
+        printf("%d runs, %d failures\n", runs, failures);
+    } /* End of if statement */
+    return failures ? 1 : 0;
+} /* End of main function */
@@ -0,0 +1,245 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8fusegen.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8ngram.h"
+#include "chip8predecode.h"
+#include "chip8profiler.h"
+
+#define FUSEGEN_DEFAULT_SUPERS 16
+#define FUSEGEN_DEFAULT_TRACES 8
+
+/* Reads the counts written by profiling builds, picks the superinstructions
+ * and hot traces worth a handler of their own and writes them out as
+ * chip8super.h, compiled into every build after it. Superinstructions
+ * are the pairs and triples of forms chip8_fusion_select picks from the
+ * n-grams; traces are the runs of CHIP8_FUSE_MAX forms the per address
+ * and edge counts say ran straight through. */
+
+/* The enum constant for each op, as the generated code names them */
+static const char* fusegen_op_constants[CHIP8_TOTAL_OPS] = {
+    "CHIP8_OP_CLS", "CHIP8_OP_RET", "CHIP8_OP_SCROLL_DOWN", "CHIP8_OP_SCROLL_UP",
+    "CHIP8_OP_SCROLL_RIGHT", "CHIP8_OP_SCROLL_LEFT", "CHIP8_OP_LORES", "CHIP8_OP_HIRES",
+    "CHIP8_OP_SYS", "CHIP8_OP_JP", "CHIP8_OP_CALL", "CHIP8_OP_SE_BYTE",
+    "CHIP8_OP_SNE_BYTE", "CHIP8_OP_SE_REG", "CHIP8_OP_SAVE_RANGE", "CHIP8_OP_LOAD_RANGE",
+    "CHIP8_OP_LD_BYTE", "CHIP8_OP_ADD_BYTE", "CHIP8_OP_LD_REG", "CHIP8_OP_OR",
+    "CHIP8_OP_AND", "CHIP8_OP_XOR", "CHIP8_OP_ADD_REG", "CHIP8_OP_SUB",
+    "CHIP8_OP_SHR", "CHIP8_OP_SUBN", "CHIP8_OP_SHL", "CHIP8_OP_SNE_REG",
+    "CHIP8_OP_LD_I", "CHIP8_OP_JP_V0", "CHIP8_OP_RND", "CHIP8_OP_DRW",
+    "CHIP8_OP_SKP", "CHIP8_OP_SKNP", "CHIP8_OP_LD_I_LONG", "CHIP8_OP_PLANES",
+    "CHIP8_OP_AUDIO", "CHIP8_OP_LD_VX_DT", "CHIP8_OP_LD_VX_K", "CHIP8_OP_LD_DT_VX",
+    "CHIP8_OP_LD_ST_VX", "CHIP8_OP_ADD_I", "CHIP8_OP_LD_F", "CHIP8_OP_LD_HF",
+    "CHIP8_OP_BCD", "CHIP8_OP_PITCH", "CHIP8_OP_STORE", "CHIP8_OP_READ",
+    "CHIP8_OP_INVALID"
+}; /* End op constants array */
+
+static void fusegen_pattern_name(FILE* out, const struct chip8_fusion_pattern* pattern)
+{
+    for (int i = 0; i < pattern->length; i++)
+    {
+        fprintf(out, "%s%s", i ? " " : "", chip8_op_name(pattern->ops[i]));
+    } /* End of for loop */
+} /* End of fusegen pattern name function */
+
+/* Writes the handler for one superinstruction. Straight forms leave PC
+ * alone, so it is only set before the forms that read or move it and
+ * once at the end; the checks for a run cut short follow just the forms
+ * that can cut it. */
+static void fusegen_write_handler(FILE* out, const struct chip8_fusion_pattern* pattern, int super, const char* kind)
+{
+    fprintf(out, "\n/* ");
+    fusegen_pattern_name(out, pattern);
+    fprintf(out, ", a %s run %llu times */\n", kind, pattern->count);
+    fprintf(out, "static inline void CHIP8_EXEC_NAME(chip8_super_%d)(struct chip8* chip8, "
+            "const struct chip8_decoded* decoded,\n        unsigned short pc)\n{\n", super);
+    bool pc_set = false;
+    for (int i = 0; i < pattern->length; i++)
+    {
+        bool straight = chip8_op_straight(pattern->ops[i]);
+        bool last = i == pattern->length - 1;
+        if (!straight)
+        {
+            fprintf(out, "    chip8->registers.PC = pc + %d;\n", 2 * (i + 1));
+        } /* End of if statement */
+        fprintf(out, "    CHIP8_EXEC_NAME(chip8_exec_decoded)(chip8, %s, decoded->opcodes[%d]);\n",
+                fusegen_op_constants[pattern->ops[i]], i);
+        fprintf(out, "    chip8->cycles++;\n");
+        if (!straight && !last)
+        {
+            fprintf(out, "    if (CHIP8_EXEC_NAME(chip8_decoded_stopped)(chip8, pc + %d))\n"
+                    "    {\n        return;\n    } /* End of if statement */\n", 2 * (i + 1));
+        }
+        else if (!straight)
+        {
+            fprintf(out, "    CHIP8_EXEC_NAME(chip8_decoded_fault)(chip8);\n");
+        } /* End of if statement */
+        pc_set = !straight;
+    } /* End of for loop */
+    if (!pc_set)
+    {
+        fprintf(out, "    chip8->registers.PC = pc + %d;\n", 2 * pattern->length);
+    } /* End of if statement */
+    fprintf(out, "} /* End of super %d function */\n", super);
+} /* End of fusegen write handler function */
+
+static int fusegen_write(FILE* out, const struct chip8_fusion* supers, const struct chip8_fusion* traces,
+        unsigned long long instructions, int files)
+{
+    int total = supers->count + traces->count;
+    fprintf(out, "/* Program name : Chip-8 emulator \n * File name : chip8super.h */\n\n");
+    fprintf(out, "/* Generated by fusegen from %d counts file%s covering %llu instructions;\n"
+            " * regenerate rather than edit. The first part lists the runs for the\n"
+            " * predecoder, the second is included by chip8exec.h once per profile\n"
+            " * and defines a handler for each run plus chip8_exec_super, which\n"
+            " * picks the handler for a decoded entry. */\n\n",
+            files, files == 1 ? "" : "s", instructions);
+
+    fprintf(out, "#ifndef CHIP8SUPER_H\n#define CHIP8SUPER_H\n\n#include \"chip8predecode.h\"\n\n");
+    fprintf(out, "#define CHIP8_TOTAL_SUPERS %d\n\n", total);
+    fprintf(out, "/* The runs with a handler, entry super - 1 for super, ending in an\n"
+            " * empty pattern */\n#define CHIP8_SUPER_PATTERNS \\\n");
+    for (int i = 0; i < total; i++)
+    {
+        const struct chip8_fusion_pattern* pattern = i < supers->count
+                ? &supers->patterns[i] : &traces->patterns[i - supers->count];
+        fprintf(out, "    { { ");
+        for (int j = 0; j < pattern->length; j++)
+        {
+            fprintf(out, "%s%s", j ? ", " : "", fusegen_op_constants[pattern->ops[j]]);
+        } /* End of nested for loop */
+        fprintf(out, " }, %d, %lluULL }, \\\n", pattern->length, pattern->count);
+    } /* End of for loop */
+    fprintf(out, "    { { 0 }, 0, 0 }\n\n#endif\n\n#ifdef CHIP8_EXEC_PROFILE\n");
+
+    for (int i = 0; i < total; i++)
+    {
+        if (i < supers->count)
+        {
+            fusegen_write_handler(out, &supers->patterns[i], i + 1, "superinstruction");
+        }
+        else
+        {
+            fusegen_write_handler(out, &traces->patterns[i - supers->count], i + 1, "trace");
+        } /* End of if statement */
+    } /* End of for loop */
+
+    fprintf(out, "\n/* Runs a decoded entry through its handler, or the generic dispatch\n"
+            " * if it has none */\n");
+    fprintf(out, "static inline void CHIP8_EXEC_NAME(chip8_exec_super)(struct chip8* chip8, "
+            "const struct chip8_decoded* decoded,\n        unsigned short pc)\n{\n");
+    fprintf(out, "    switch (decoded->super)\n    {\n");
+    for (int i = 0; i < total; i++)
+    {
+        fprintf(out, "        case %d:\n            CHIP8_EXEC_NAME(chip8_super_%d)(chip8, decoded, pc);\n"
+                "            break;\n", i + 1, i + 1);
+    } /* End of for loop */
+    fprintf(out, "        default:\n            CHIP8_EXEC_NAME(chip8_dispatch_decoded)(chip8, decoded, pc, "
+            "decoded->length);\n            break;\n    } /* End of switch statement */\n"
+            "} /* End of exec super function */\n\n#endif\n");
+    return ferror(out) ? -1 : 0;
+} /* End of fusegen write function */
+
+static void fusegen_free(struct chip8_profiler* profilers, int count, struct chip8_ngrams* ngrams)
+{
+    for (int i = 0; i < count; i++)
+    {
+        chip8_profiler_free(&profilers[i]);
+    } /* End of for loop */
+    free(profilers);
+    chip8_ngrams_free(ngrams);
+} /* End of fusegen free function */
+
+int main(int argc, char** argv)
+{
+    int super_count = FUSEGEN_DEFAULT_SUPERS;
+    int trace_count = FUSEGEN_DEFAULT_TRACES;
+    const char* output = NULL;
+
+    /* Each file's address counts stay apart, as they are only comparable
+     * within a ROM; the n-grams of every file add up in one table */
+    struct chip8_ngrams ngrams;
+    struct chip8_profiler* profilers = calloc(argc, sizeof(struct chip8_profiler));
+    if (!profilers || chip8_ngrams_init(&ngrams) != 0)
+    {
+        fprintf(stderr, "Out of memory\n");
+        free(profilers);
+        return -1;
+    } /* End of if statement */
+
+    int files = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--supers=", 9) == 0)
+        {
+            super_count = atoi(argv[i] + 9);
+        }
+        else if (strncmp(argv[i], "--traces=", 9) == 0)
+        {
+            trace_count = atoi(argv[i] + 9);
+        }
+        else if (strncmp(argv[i], "--out=", 6) == 0)
+        {
+            output = argv[i] + 6;
+        }
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            fprintf(stderr, "Usage: %s [--supers=N] [--traces=N] [--out=FILE] [COUNTS]...\n", argv[0]);
+            fusegen_free(profilers, files, &ngrams);
+            return -1;
+        }
+        else if (chip8_profiler_init(&profilers[files]) != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            fusegen_free(profilers, files, &ngrams);
+            return -1;
+        }
+        else if (chip8_profiler_load(&profilers[files++], argv[i]) != 0 || chip8_ngrams_load(&ngrams, argv[i]) != 0)
+        {
+            fprintf(stderr, "Failed to load counts from %s\n", argv[i]);
+            fusegen_free(profilers, files, &ngrams);
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    static struct chip8_fusion supers;
+    static struct chip8_fusion traces;
+    if (chip8_fusion_select(&supers, &ngrams, super_count) < 0
+            || chip8_profiler_traces(profilers, files, &traces, trace_count) < 0)
+    {
+        fprintf(stderr, "Out of memory\n");
+        fusegen_free(profilers, files, &ngrams);
+        return -1;
+    } /* End of if statement */
+
+    unsigned long long instructions = 0;
+    for (int op = 0; op < CHIP8_TOTAL_OPS; op++)
+    {
+        instructions += ngrams.singles[op];
+    } /* End of for loop */
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+    int res = out ? fusegen_write(out, &supers, &traces, instructions, files) : -1;
+    if (out && output && fclose(out) != 0)
+    {
+        res = -1;
+    } /* End of if statement */
+    if (res != 0)
+    {
+        fprintf(stderr, "Failed to write %s\n", output ? output : "the header");
+    } /* End of if statement */
+
+    for (int i = 0; i < supers.count + traces.count; i++)
+    {
+        const struct chip8_fusion_pattern* pattern = i < supers.count
+                ? &supers.patterns[i] : &traces.patterns[i - supers.count];
+        fprintf(stderr, "%s ", i < supers.count ? "super" : "trace");
+        fusegen_pattern_name(stderr, pattern);
+        fprintf(stderr, " %llu\n", pattern->count);
+    } /* End of for loop */
+
+    fusegen_free(profilers, files, &ngrams);
+    return res;
+} /* End of main function */
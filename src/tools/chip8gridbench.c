@@ -0,0 +1,182 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8gridbench.c */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "chip8.h"
+#include "chip8atlas.h"
+#include "chip8fleet.h"
+#include "chip8loader.h"
+
+#define GRIDBENCH_DEFAULT_COUNT 1000
+#define GRIDBENCH_DEFAULT_WORKERS 1
+#define GRIDBENCH_DEFAULT_SECONDS 5
+
+/* Runs a fleet the way the grid frontend does, workers paced to 60Hz,
+ * and times the display side on its own thread : collecting the new
+ * frames, redrawing their tiles and copying the dirty band out as the
+ * frontend uploads it to its texture. Reports that thread's CPU time
+ * per frame against the 60Hz budget, which is what decides how many
+ * instances one core can show, and the whole process's CPU use.
+ * CHIP8_POWERSAVE=0 runs idle instances too, for comparison. */
+struct gridbench
+{
+    struct chip8_fleet fleet;
+    int workers;
+    atomic_bool quit;
+}; /* End gridbench struct */
+
+struct gridbench_worker
+{
+    struct gridbench* bench;
+    int index;
+}; /* End gridbench worker struct */
+
+static long long now_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+} /* End of now ns function */
+
+static void sleep_until(long long deadline)
+{
+    struct timespec ts = { deadline / 1000000000LL, deadline % 1000000000LL };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+} /* End of sleep until function */
+
+static void* worker_thread(void* arg)
+{
+    struct gridbench_worker* worker = arg;
+    struct gridbench* bench = worker->bench;
+    long long period = 1000000000LL / CHIP8_TIMER_HZ;
+    long long next = now_ns(CLOCK_MONOTONIC);
+    while (!atomic_load_explicit(&bench->quit, memory_order_relaxed))
+    {
+        chip8_fleet_run_frame(&bench->fleet, worker->index, bench->workers);
+        next += period;
+        sleep_until(next);
+    } /* End of while loop */
+    return NULL;
+} /* End of worker thread function */
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s ROM [COUNT] [WORKERS] [SECONDS]\n", argv[0]);
+        return -1;
+    } /* End of if statement */
+
+    static struct chip8 program;
+    chip8_init(&program);
+    enum chip8_load_result load = chip8_load_file(&program, argv[1]);
+    if (load != CHIP8_LOAD_OK)
+    {
+        printf("Failed to load %s: %s\n", argv[1], chip8_load_result_name(load));
+        return -1;
+    } /* End of if statement */
+    chip8_set_profile(&program, chip8_profile_for_file(argv[1]));
+
+    static struct gridbench bench;
+    int count = argc > 2 ? atoi(argv[2]) : GRIDBENCH_DEFAULT_COUNT;
+    bench.workers = argc > 3 ? atoi(argv[3]) : GRIDBENCH_DEFAULT_WORKERS;
+    double seconds = argc > 4 ? atof(argv[4]) : GRIDBENCH_DEFAULT_SECONDS;
+    if (count < 1 || bench.workers < 1 || bench.workers > count)
+    {
+        printf("Need at least one instance and between one worker and one per instance\n");
+        return -1;
+    } /* End of if statement */
+
+    static const uint32_t palette[4] = { 0xff000000, 0xffffffff, 0xffaaaaaa, 0xff555555 };
+    struct chip8_atlas atlas;
+    if (chip8_fleet_init(&bench.fleet, &program, count) != 0 || chip8_atlas_init(&atlas, count, palette) != 0)
+    {
+        printf("Out of memory for %d instances\n", count);
+        return -1;
+    } /* End of if statement */
+    uint32_t* texture = malloc(atlas.pitch * atlas.height);
+    const char* powersave = getenv("CHIP8_POWERSAVE");
+    bench.fleet.powersave = !powersave || strcmp(powersave, "0") != 0;
+
+    atomic_init(&bench.quit, false);
+    pthread_t threads[bench.workers];
+    struct gridbench_worker workers[bench.workers];
+    for (int i = 0; i < bench.workers; i++)
+    {
+        workers[i] = (struct gridbench_worker) { &bench, i };
+        pthread_create(&threads[i], NULL, worker_thread, &workers[i]);
+    } /* End of for loop */
+
+    long long period = 1000000000LL / CHIP8_TIMER_HZ;
+    long long start = now_ns(CLOCK_MONOTONIC);
+    long long cpu_start = now_ns(CLOCK_PROCESS_CPUTIME_ID);
+    long long next = start;
+    long long busy = 0;
+    long long worst = 0;
+    unsigned long long tiles = 0;
+    unsigned long long uploaded = 0;
+    unsigned long frames = 0;
+    for (; now_ns(CLOCK_MONOTONIC) - start < seconds * 1e9; frames++)
+    {
+        long long begin = now_ns(CLOCK_THREAD_CPUTIME_ID);
+        for (int i = 0; i < count; i++)
+        {
+            const struct chip8_frame* frame = chip8_triple_read(&bench.fleet.instances[i].triple);
+            if (frame)
+            {
+                chip8_atlas_draw(&atlas, i, frame);
+                tiles++;
+            } /* End of if statement */
+        } /* End of for loop */
+
+        int y;
+        int height;
+        if (chip8_atlas_take_dirty(&atlas, &y, &height))
+        {
+            memcpy((char*) texture + y * atlas.pitch, (char*) atlas.pixels + y * atlas.pitch, height * atlas.pitch);
+            uploaded += height * atlas.pitch;
+        } /* End of if statement */
+        long long spent = now_ns(CLOCK_THREAD_CPUTIME_ID) - begin;
+        busy += spent;
+        worst = spent > worst ? spent : worst;
+
+        next += period;
+        sleep_until(next);
+    } /* End of for loop */
+    double elapsed = (now_ns(CLOCK_MONOTONIC) - start) / 1e9;
+    double cpu = (now_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu_start) / 1e9;
+
+    atomic_store(&bench.quit, true);
+    for (int i = 0; i < bench.workers; i++)
+    {
+        pthread_join(threads[i], NULL);
+    } /* End of for loop */
+
+    unsigned long long emulated = 0;
+    unsigned long long slept = 0;
+    for (int i = 0; i < count; i++)
+    {
+        emulated += bench.fleet.instances[i].frames;
+        slept += bench.fleet.instances[i].slept;
+    } /* End of for loop */
+
+    printf("{\"instances\": %d, \"workers\": %d, \"powersave\": %s, \"atlas\": \"%dx%d\", \"frames\": %lu, "
+            "\"emulated_frames_per_second\": %.0f, \"slept_fraction\": %.3f, \"tiles_per_frame\": %.1f, "
+            "\"upload_bytes_per_frame\": %.0f, \"display_us_per_frame\": %.1f, \"display_worst_us\": %.1f, "
+            "\"display_budget_used\": %.3f, \"cpu_percent\": %.1f}\n",
+            count, bench.workers, bench.fleet.powersave ? "true" : "false", atlas.width, atlas.height, frames,
+            emulated / elapsed, emulated ? (double) slept / emulated : 0.0, (double) tiles / frames,
+            (double) uploaded / frames, busy / 1e3 / frames, worst / 1e3, (double) busy / frames / period,
+            100 * cpu / elapsed);
+
+    free(texture);
+    chip8_atlas_free(&atlas);
+    chip8_fleet_free(&bench.fleet);
+    return 0;
+} /* End of main function */
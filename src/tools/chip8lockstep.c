@@ -0,0 +1,316 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8lockstep.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8.h"
+#include "chip8backend.h"
+#include "chip8lockstep.h"
+#include "chip8loader.h"
+#include "chip8ngram.h"
+
+#define LOCKSTEP_ROM_CYCLES 10000000
+#define LOCKSTEP_FUZZ_CYCLES 1000
+#define LOCKSTEP_PROFILE_CYCLES 1000000
+#define LOCKSTEP_DEFAULT_FUSE CHIP8_FUSION_MAX_PATTERNS
+
+struct lockstep_options
+{
+    const struct chip8_backend* a;
+    const struct chip8_backend* b;
+    unsigned int interval;
+    unsigned long long cycles;
+    unsigned long long seed;
+    unsigned long programs;
+    int fuzz;
+    const char* rom;
+    const char* ngrams;
+    int fuse;
+}; /* End lockstep options struct */
+
+static struct chip8_lockstep lockstep;
+static struct chip8_divergence divergence;
+
+static void usage(const char* program)
+{
+    printf("Usage: %s [--a=BACKEND] [--b=BACKEND] [--interval=N] [--cycles=N] [--ngrams=FILE] [--fuse=N] ROM\n",
+            program);
+    printf("       %s --fuzz [--a=BACKEND] [--b=BACKEND] [--seed=N] [--programs=N] [--cycles=N]\n", program);
+    printf("Backends:");
+    for (int i = 0; i < chip8_total_backends; i++)
+    {
+        printf(" %s", chip8_backends[i].name);
+    } /* End of for loop */
+    printf("\n");
+} /* End of usage function */
+
+static int parse_args(int argc, char** argv, struct lockstep_options* options)
+{
+    options->a = chip8_backend_find("switch");
+    options->b = options->a;
+    options->interval = 1000;
+    options->cycles = 0;
+    options->seed = 1;
+    options->programs = 1000;
+    options->fuzz = 0;
+    options->rom = NULL;
+    options->ngrams = NULL;
+    options->fuse = LOCKSTEP_DEFAULT_FUSE;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--a=", 4) == 0 || strncmp(arg, "--b=", 4) == 0)
+        {
+            const struct chip8_backend* backend = chip8_backend_find(arg + 4);
+            if (!backend)
+            {
+                return -1;
+            } /* End of nested if statement */
+            *(arg[2] == 'a' ? &options->a : &options->b) = backend;
+        }
+        else if (strncmp(arg, "--interval=", 11) == 0)
+        {
+            options->interval = strtoul(arg + 11, NULL, 10);
+        }
+        else if (strncmp(arg, "--cycles=", 9) == 0)
+        {
+            options->cycles = strtoull(arg + 9, NULL, 10);
+        }
+        else if (strncmp(arg, "--seed=", 7) == 0)
+        {
+            options->seed = strtoull(arg + 7, NULL, 10);
+        }
+        else if (strncmp(arg, "--programs=", 11) == 0)
+        {
+            options->programs = strtoul(arg + 11, NULL, 10);
+        }
+        else if (strncmp(arg, "--ngrams=", 9) == 0)
+        {
+            options->ngrams = arg + 9;
+        }
+        else if (strncmp(arg, "--fuse=", 7) == 0)
+        {
+            options->fuse = atoi(arg + 7);
+        }
+        else if (strcmp(arg, "--fuzz") == 0)
+        {
+            options->fuzz = 1;
+        }
+        else if (arg[0] != '-' && !options->rom)
+        {
+            options->rom = arg;
+        }
+        else
+        {
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    return options->fuzz || options->rom ? 0 : -1;
+} /* End of parse args function */
+
+/* A backend that runs fused instructions fuses the runs picked from the
+ * n-grams saved in --ngrams=FILE or, without one, from profiling the
+ * ROM itself from start for a while */
+static int fuse_rom(const struct lockstep_options* options, const struct chip8* start)
+{
+    static struct chip8 profiled;
+    struct chip8_ngrams ngrams;
+    struct chip8_fusion fusion;
+    if (chip8_ngrams_init(&ngrams) != 0)
+    {
+        return -1;
+    } /* End of if statement */
+
+    int res = 0;
+    if (options->ngrams)
+    {
+        res = chip8_ngrams_load(&ngrams, options->ngrams);
+    }
+    else
+    {
+        profiled = *start;
+        chip8_ngrams_run(&ngrams, &profiled, options->cycles < LOCKSTEP_PROFILE_CYCLES ? options->cycles
+                : LOCKSTEP_PROFILE_CYCLES);
+    } /* End of if statement */
+    if (res == 0)
+    {
+        res = chip8_fusion_select(&fusion, &ngrams, options->fuse);
+    } /* End of if statement */
+    chip8_ngrams_free(&ngrams);
+    if (res < 0)
+    {
+        printf("Failed to pick the runs to fuse\n");
+        return -1;
+    } /* End of if statement */
+
+    chip8_predecode_backend_fuse(&fusion);
+    printf("Fusing %d runs from %s\n", fusion.count, options->ngrams ? options->ngrams : "a profile of the ROM");
+    return 0;
+} /* End of fuse rom function */
+
+static int run_rom(const struct lockstep_options* options)
+{
+    static struct chip8 start;
+
+    chip8_init(&start);
+    enum chip8_load_result res = chip8_load_file(&start, options->rom);
+    if (res != CHIP8_LOAD_OK)
+    {
+        printf("Failed to load %s: %s\n", options->rom, chip8_load_result_name(res));
+        return -1;
+    } /* End of if statement */
+    chip8_set_profile(&start, chip8_profile_for_file(options->rom));
+    if ((options->a->run || options->b->run) && fuse_rom(options, &start) != 0)
+    {
+        return -1;
+    } /* End of if statement */
+    chip8_lockstep_init(&lockstep, options->a, options->b, &start, options->interval);
+
+    if (chip8_lockstep_run(&lockstep, options->cycles, &divergence))
+    {
+        chip8_lockstep_print(stdout, &lockstep, &divergence);
+        return 1;
+    } /* End of if statement */
+
+    printf("%s and %s agree for %llu instructions\n", options->a->name, options->b->name, options->cycles);
+    return 0;
+} /* End of run rom function */
+
+static unsigned long long fuzz_state;
+
+static unsigned long long fuzz_random(void)
+{
+    fuzz_state ^= fuzz_state << 13;
+    fuzz_state ^= fuzz_state >> 7;
+    fuzz_state ^= fuzz_state << 17;
+    return fuzz_state;
+} /* End of fuzz random function */
+
+/* Rejects opcodes that would trip the core's bounds asserts from the
+ * current state, so the fuzzer only ever compares defined behaviour */
+static int fuzz_opcode_is_safe(const struct chip8* chip8, unsigned short opcode)
+{
+    unsigned char x = (opcode >> 8) & 0x000f;
+    unsigned char y = (opcode >> 4) & 0x000f;
+    unsigned char n = opcode & 0x000f;
+    unsigned short I = chip8->registers.I;
+    int space = chip8_address_space(chip8);
+
+    switch (opcode & 0xf000)
+    {
+        case 0x0000:
+            return opcode != 0x00EE || chip8->registers.SP > 0;
+
+        case 0x2000:
+            return chip8->registers.SP < CHIP8_TOTAL_STACK_DEPTH;
+
+        case 0x5000:
+            return I + (x > y ? x - y : y - x) < space;
+
+        case 0xD000:
+            return I + (n == 0 ? 32 : n) * chip8_screen_plane_count(&chip8->screen) <= space;
+
+        case 0xF000:
+            switch (opcode & 0x00ff)
+            {
+                case 0x00: return chip8->registers.PC + 3 < space;
+                case 0x02: return I + CHIP8_AUDIO_PATTERN_SIZE <= space;
+                case 0x33: return I + 2 < space;
+                case 0x55:
+                case 0x65: return I + x < space;
+            } /* End of nested switch */
+            break;
+    } /* End of switch statement */
+
+    return 1;
+} /* End of fuzz opcode is safe function */
+
+static void fuzz_poke(unsigned short address, unsigned short opcode)
+{
+    struct chip8* states[] = { &lockstep.a, &lockstep.b, &lockstep.checkpoint };
+    for (int i = 0; i < 3; i++)
+    {
+        int space = chip8_address_space(states[i]);
+        chip8_memory_set(&states[i]->memory, space, address, opcode >> 8);
+        chip8_memory_set(&states[i]->memory, space, address + 1, opcode & 0xff);
+    } /* End of for loop */
+} /* End of fuzz poke function */
+
+/* Each program starts from random registers and memory, then a random
+ * opcode is planted at PC before every instruction */
+static int run_fuzz(const struct lockstep_options* options)
+{
+    static struct chip8 start;
+    fuzz_state = options->seed ? options->seed : 1;
+
+    for (unsigned long program = 0; program < options->programs; program++)
+    {
+        chip8_init(&start);
+        chip8_seed(&start, fuzz_random());
+        for (int i = CHIP8_PROGRAM_LOAD_ADDRESS; i < CHIP8_MEMORY_SIZE; i++)
+        {
+            start.memory.memory[i] = fuzz_random();
+        } /* End of for loop */
+        for (int i = 0; i < CHIP8_TOTAL_DATA_REGISTERS; i++)
+        {
+            start.registers.V[i] = fuzz_random();
+        } /* End of for loop */
+        for (int i = 0; i < CHIP8_TOTAL_KEYS; i++)
+        {
+            start.keyboard.keyboard[i] = fuzz_random() & 1;
+        } /* End of for loop */
+        start.registers.I = fuzz_random() % chip8_address_space(&start);
+        chip8_set_delay_timer(&start, fuzz_random());
+        start.registers.PC = CHIP8_PROGRAM_LOAD_ADDRESS;
+
+        chip8_lockstep_init(&lockstep, options->a, options->b, &start, 1);
+
+        for (unsigned long long cycle = 0; cycle < options->cycles; cycle++)
+        {
+            if (lockstep.a.registers.PC > chip8_address_space(&lockstep.a) - 2)
+            {
+                lockstep.a.registers.PC = CHIP8_PROGRAM_LOAD_ADDRESS;
+                lockstep.b.registers.PC = CHIP8_PROGRAM_LOAD_ADDRESS;
+                lockstep.checkpoint.registers.PC = CHIP8_PROGRAM_LOAD_ADDRESS;
+            } /* End of if statement */
+
+            unsigned short opcode;
+            do
+            {
+                opcode = fuzz_random();
+            } while (!fuzz_opcode_is_safe(&lockstep.a, opcode));
+            fuzz_poke(lockstep.a.registers.PC, opcode);
+
+            if (chip8_lockstep_run(&lockstep, 1, &divergence))
+            {
+                printf("Program %lu (seed %llu):\n", program, options->seed);
+                chip8_lockstep_print(stdout, &lockstep, &divergence);
+                return 1;
+            } /* End of if statement */
+        } /* End of for loop */
+    } /* End of for loop */
+
+    printf("%s and %s agree over %lu random programs of %llu instructions\n",
+            options->a->name, options->b->name, options->programs, options->cycles);
+    return 0;
+} /* End of run fuzz function */
+
+int main(int argc, char** argv)
+{
+    struct lockstep_options options;
+    if (parse_args(argc, argv, &options) != 0)
+    {
+        usage(argv[0]);
+        return -1;
+    } /* End of if statement */
+
+    if (options.cycles == 0)
+    {
+        options.cycles = options.fuzz ? LOCKSTEP_FUZZ_CYCLES : LOCKSTEP_ROM_CYCLES;
+    } /* End of if statement */
+    return options.fuzz ? run_fuzz(&options) : run_rom(&options);
+} /* End of main function */
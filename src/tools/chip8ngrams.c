@@ -0,0 +1,254 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8ngrams.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8.h"
+#include "chip8hash.h"
+#include "chip8loader.h"
+#include "chip8ngram.h"
+#include "chip8predecode.h"
+#include "chip8script.h"
+
+#define NGRAMS_DEFAULT_FRAMES 3000
+#define NGRAMS_DEFAULT_FUSE 16
+
+/* Profiles which instruction forms the ROMs run back to back, picks the
+ * runs worth fusing and checks that the predecoder running them fused
+ * ends every frame in the same state as the profile's interpreter.
+ * Profiles saved from earlier runs can be loaded and added in, so the
+ * picks can come from the workload rather than a single session. */
+
+struct ngrams_rom
+{
+    char path[1024];
+    struct chip8_script script;
+    const struct chip8_profile* profile;
+}; /* End ngrams rom struct */
+
+/* Splits PATH:SCRIPT and loads the script. Returns -1 on failure. */
+static int ngrams_rom_open(struct ngrams_rom* rom, const char* arg, const struct chip8_profile* profile)
+{
+    memset(rom, 0, sizeof(struct ngrams_rom));
+    snprintf(rom->path, sizeof(rom->path), "%s", arg);
+    char* script = strchr(rom->path, ':');
+    if (script)
+    {
+        *script++ = '\0';
+        if (chip8_script_load(&rom->script, script) != 0)
+        {
+            fprintf(stderr, "Failed to load input script %s\n", script);
+            return -1;
+        } /* End of nested if statement */
+    } /* End of if statement */
+    rom->profile = profile ? profile : chip8_profile_for_file(rom->path);
+    return 0;
+} /* End of ngrams rom open function */
+
+static int ngrams_rom_reset(struct ngrams_rom* rom, struct chip8* chip8)
+{
+    chip8_init(chip8);
+    enum chip8_load_result res = chip8_load_file(chip8, rom->path);
+    if (res != CHIP8_LOAD_OK)
+    {
+        fprintf(stderr, "%s: %s\n", rom->path, chip8_load_result_name(res));
+        return -1;
+    } /* End of if statement */
+    chip8_set_profile(chip8, rom->profile);
+    chip8_script_rewind(&rom->script);
+    return 0;
+} /* End of ngrams rom reset function */
+
+static int ngrams_profile(struct ngrams_rom* rom, struct chip8_ngrams* ngrams, unsigned long frames)
+{
+    static struct chip8 chip8;
+    if (ngrams_rom_reset(rom, &chip8) != 0)
+    {
+        return -1;
+    } /* End of if statement */
+
+    for (unsigned long frame = 0; frame < frames; frame++)
+    {
+        chip8_script_apply(&rom->script, &chip8, frame);
+        chip8_ngrams_run(ngrams, &chip8, CHIP8_CYCLES_PER_FRAME);
+    } /* End of for loop */
+    return 0;
+} /* End of ngrams profile function */
+
+static unsigned long long ngrams_total(const struct chip8_ngrams* ngrams)
+{
+    unsigned long long total = 0;
+    for (int op = 0; op < CHIP8_TOTAL_OPS; op++)
+    {
+        total += ngrams->singles[op];
+    } /* End of for loop */
+    return total;
+} /* End of ngrams total function */
+
+/* Runs the ROM under the interpreter and fused side by side, comparing
+ * state after every frame. Returns the first frame that differs, frames
+ * if none does, or -1 on failure. */
+static long ngrams_verify(struct ngrams_rom* rom, struct chip8_predecode* predecode, unsigned long frames)
+{
+    static struct chip8 reference;
+    static struct chip8 fused;
+    if (ngrams_rom_reset(rom, &reference) != 0 || ngrams_rom_reset(rom, &fused) != 0)
+    {
+        return -1;
+    } /* End of if statement */
+
+    for (unsigned long frame = 0; frame < frames; frame++)
+    {
+        chip8_script_apply(&rom->script, &reference, frame);
+        fused.keyboard = reference.keyboard;
+        chip8_run_frame(&reference);
+        chip8_predecode_run_frame(predecode, &fused);
+
+        struct chip8_hashes a;
+        struct chip8_hashes b;
+        chip8_hash(&reference, &a);
+        chip8_hash(&fused, &b);
+        if (memcmp(&a, &b, sizeof(a)) != 0 || reference.cycles != fused.cycles || reference.fault != fused.fault)
+        {
+            return frame;
+        } /* End of if statement */
+    } /* End of for loop */
+    return frames;
+} /* End of ngrams verify function */
+
+int main(int argc, char** argv)
+{
+    unsigned long frames = NGRAMS_DEFAULT_FRAMES;
+    int fuse = NGRAMS_DEFAULT_FUSE;
+    const struct chip8_profile* profile = NULL;
+    const char* save = NULL;
+
+    struct chip8_ngrams ngrams;
+    if (chip8_ngrams_init(&ngrams) != 0)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    } /* End of if statement */
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--frames=", 9) == 0)
+        {
+            frames = strtoul(argv[i] + 9, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--fuse=", 7) == 0)
+        {
+            fuse = atoi(argv[i] + 7);
+        }
+        else if (strncmp(argv[i], "--profile=", 10) == 0 && chip8_profile_find(argv[i] + 10))
+        {
+            profile = chip8_profile_find(argv[i] + 10);
+        }
+        else if (strncmp(argv[i], "--save=", 7) == 0)
+        {
+            save = argv[i] + 7;
+        }
+        else if (strncmp(argv[i], "--load=", 7) == 0)
+        {
+            if (chip8_ngrams_load(&ngrams, argv[i] + 7) != 0)
+            {
+                fprintf(stderr, "Failed to load n-grams from %s\n", argv[i] + 7);
+                chip8_ngrams_free(&ngrams);
+                return -1;
+            } /* End of nested if statement */
+        }
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            fprintf(stderr, "Usage: %s [--frames=N] [--profile=NAME] [--load=FILE]... [--save=FILE] [--fuse=N] "
+                    "[ROM[:SCRIPT]]...\n", argv[0]);
+            chip8_ngrams_free(&ngrams);
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    /* Instructions each ROM ran, by argument */
+    unsigned long long* executed = calloc(argc, sizeof(unsigned long long));
+    int res = executed ? 0 : -1;
+    struct ngrams_rom rom;
+    for (int i = 1; i < argc && res == 0; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            continue;
+        } /* End of if statement */
+        res = ngrams_rom_open(&rom, argv[i], profile);
+        if (res == 0)
+        {
+            unsigned long long before = ngrams_total(&ngrams);
+            res = ngrams_profile(&rom, &ngrams, frames);
+            executed[i] = ngrams_total(&ngrams) - before;
+        } /* End of if statement */
+        chip8_script_free(&rom.script);
+    } /* End of for loop */
+
+    if (res == 0 && save && chip8_ngrams_save(&ngrams, save) != 0)
+    {
+        fprintf(stderr, "Failed to save n-grams to %s\n", save);
+        res = -1;
+    } /* End of if statement */
+
+    struct chip8_fusion fusion;
+    if (res != 0 || chip8_fusion_select(&fusion, &ngrams, fuse) < 0)
+    {
+        free(executed);
+        chip8_ngrams_free(&ngrams);
+        return -1;
+    } /* End of if statement */
+
+    printf("{\n  \"instructions\": %llu,\n  \"fusion\": [", ngrams_total(&ngrams));
+    for (int i = 0; i < fusion.count; i++)
+    {
+        const struct chip8_fusion_pattern* pattern = &fusion.patterns[i];
+        printf("%s\n    {\"ops\": \"", i ? "," : "");
+        for (int j = 0; j < pattern->length; j++)
+        {
+            printf("%s%s", j ? " " : "", chip8_op_name(pattern->ops[j]));
+        } /* End of nested for loop */
+        printf("\", \"count\": %llu}", pattern->count);
+    } /* End of for loop */
+    printf("\n  ],\n  \"roms\": [");
+
+    /* Every ROM gets a cache of its own so the dispatch counts are its */
+    int first = 1;
+    for (int i = 1; i < argc && res == 0; i++)
+    {
+        struct chip8_predecode predecode;
+        if (strncmp(argv[i], "--", 2) == 0 || ngrams_rom_open(&rom, argv[i], profile) != 0)
+        {
+            continue;
+        } /* End of if statement */
+        if (chip8_predecode_init(&predecode, &fusion) != 0)
+        {
+            chip8_script_free(&rom.script);
+            res = -1;
+            break;
+        } /* End of if statement */
+
+        long matched = ngrams_verify(&rom, &predecode, frames);
+        printf("%s\n    {\"rom\": \"%s\", \"frames\": %lu, \"matches\": %s, \"instructions\": %llu, "
+                "\"decodes\": %llu, \"dispatches\": %llu, \"instructions_per_dispatch\": %.3f}",
+                first ? "" : ",", rom.path, frames, matched == (long) frames ? "true" : "false",
+                executed[i], predecode.decodes, predecode.dispatches,
+                predecode.dispatches ? (double) executed[i] / predecode.dispatches : 0);
+        if (matched != (long) frames)
+        {
+            fprintf(stderr, "%s: fused run differs from the interpreter at frame %ld\n", rom.path, matched);
+            res = 1;
+        } /* End of if statement */
+        first = 0;
+        chip8_predecode_free(&predecode);
+        chip8_script_free(&rom.script);
+    } /* End of for loop */
+    printf("\n  ]\n}\n");
+
+    free(executed);
+    chip8_ngrams_free(&ngrams);
+    return res;
+} /* End of main function */
@@ -0,0 +1,271 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8record.c */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "chip8.h"
+#include "chip8frame.h"
+#include "chip8hash.h"
+#include "chip8loader.h"
+#include "chip8scale.h"
+#include "chip8script.h"
+#include "chip8video.h"
+
+#define RECORD_DEFAULT_FRAMES 3600
+#define RECORD_DEFAULT_SCALE 4
+#define RECORD_MAX_SCALE 40
+#define RECORD_QUEUE_SIZE 256
+
+/* Frames go from the emulator to the encoder thread through a single
+ * producer, single consumer ring. Only frames whose screen differs from
+ * the one before are queued; the encoder stretches each over the frames
+ * until the next. */
+struct record_entry
+{
+    unsigned long frame;
+    struct chip8_frame data;
+}; /* End record entry struct */
+
+struct record
+{
+    struct chip8 chip8;
+    struct chip8_video video;
+    int scale;
+    struct record_entry queue[RECORD_QUEUE_SIZE];
+    _Alignas(64) atomic_ulong head;
+    _Alignas(64) atomic_ulong tail;
+    atomic_int done;
+    unsigned long end_frame;
+    unsigned long stalls;
+    int res;
+}; /* End record struct */
+
+static void pause_briefly(void)
+{
+    struct timespec ts = { 0, 100000 };
+    nanosleep(&ts, NULL);
+} /* End of pause briefly function */
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+} /* End of now seconds function */
+
+static void* encoder(void* arg)
+{
+    struct record* record = arg;
+    unsigned long tail = 0;
+    while (1)
+    {
+        unsigned long head = atomic_load_explicit(&record->head, memory_order_acquire);
+        if (tail == head)
+        {
+            if (atomic_load_explicit(&record->done, memory_order_acquire) &&
+                tail == atomic_load_explicit(&record->head, memory_order_acquire))
+            {
+                break;
+            } /* End of if statement */
+            pause_briefly();
+            continue;
+        } /* End of if statement */
+
+        const struct record_entry* entry = &record->queue[tail % RECORD_QUEUE_SIZE];
+        int scale = record->scale * CHIP8_WIDTH / entry->data.width;
+        chip8_scale_indexed(&entry->data, record->video.lut, scale, chip8_video_buffer(&record->video));
+        if (record->res == 0 && chip8_video_write(&record->video, entry->frame) != 0)
+        {
+            record->res = -1;
+        } /* End of if statement */
+        atomic_store_explicit(&record->tail, ++tail, memory_order_release);
+    } /* End of while loop */
+
+    if (chip8_video_close(&record->video, record->end_frame) != 0)
+    {
+        record->res = -1;
+    } /* End of if statement */
+    return NULL;
+} /* End of encoder function */
+
+static void enqueue(struct record* record, unsigned long frame)
+{
+    unsigned long head = atomic_load_explicit(&record->head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&record->tail, memory_order_acquire) == RECORD_QUEUE_SIZE)
+    {
+        record->stalls++;
+        pause_briefly();
+    } /* End of while loop */
+
+    struct record_entry* entry = &record->queue[head % RECORD_QUEUE_SIZE];
+    entry->frame = frame;
+    chip8_frame_capture(&entry->data, &record->chip8, frame);
+    atomic_store_explicit(&record->head, head + 1, memory_order_release);
+} /* End of enqueue function */
+
+int main(int argc, char** argv)
+{
+    static struct record record;
+    enum chip8_video_format format = CHIP8_VIDEO_Y4M;
+    unsigned long frames = RECORD_DEFAULT_FRAMES;
+    const char* out = NULL;
+    const char* rom = NULL;
+    const char* trace = NULL;
+    bool stats = false;
+    record.scale = RECORD_DEFAULT_SCALE;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--format=", 9) == 0 && chip8_video_format_find(argv[i] + 9, &format) == 0)
+        {
+            continue;
+        }
+        else if (strncmp(argv[i], "--scale=", 8) == 0)
+        {
+            record.scale = atoi(argv[i] + 8);
+        }
+        else if (strncmp(argv[i], "--frames=", 9) == 0)
+        {
+            frames = strtoul(argv[i] + 9, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--out=", 6) == 0)
+        {
+            out = argv[i] + 6;
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            stats = true;
+        }
+        else if (strncmp(argv[i], "--trace=", 8) == 0)
+        {
+            trace = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--", 2) != 0 && !rom)
+        {
+            rom = argv[i];
+        }
+        else
+        {
+            rom = NULL;
+            break;
+        } /* End of if else statement */
+    } /* End of for loop */
+
+    /* Hi-res pixels are drawn at half the scale, so it must be even */
+    if (!rom || record.scale < 2 || record.scale > RECORD_MAX_SCALE || record.scale % 2)
+    {
+        fprintf(stderr, "Usage: %s [--format=y4m|gif|png] [--scale=EVEN] [--frames=N] [--out=PATH] [--stats] [--trace=FILE] ROM[:SCRIPT]\n", argv[0]);
+        return -1;
+    } /* End of if statement */
+    if (!out)
+    {
+        out = format == CHIP8_VIDEO_Y4M ? "-" : format == CHIP8_VIDEO_GIF ? "record.gif" : "frame";
+    } /* End of if statement */
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s", rom);
+    char* script_path = strchr(path, ':');
+    if (script_path)
+    {
+        *script_path++ = '\0';
+    } /* End of if statement */
+
+    struct chip8* chip8 = &record.chip8;
+    chip8_init(chip8);
+    enum chip8_load_result load = chip8_load_file(chip8, path);
+    if (load != CHIP8_LOAD_OK)
+    {
+        fprintf(stderr, "Failed to load %s: %s\n", path, chip8_load_result_name(load));
+        return -1;
+    } /* End of if statement */
+    chip8_set_profile(chip8, chip8_profile_for_file(path));
+
+    /* --trace=FILE or CHIP8_TRACE=FILE keeps the last instructions in a
+     * ring buffer and writes them out at the end or on abort */
+    static struct chip8_trace ring;
+    const char* trace_filename = chip8_trace_start(&ring, trace);
+    if (trace_filename)
+    {
+        chip8->trace = &ring;
+    } /* End of if statement */
+
+    struct chip8_script script = { 0 };
+    if (script_path && chip8_script_load(&script, script_path) != 0)
+    {
+        fprintf(stderr, "Failed to load input script %s\n", script_path);
+        return -1;
+    } /* End of if statement */
+
+    if (chip8_video_open(&record.video, format, out, CHIP8_WIDTH * record.scale, CHIP8_HEIGHT * record.scale) != 0)
+    {
+        fprintf(stderr, "Failed to open %s\n", out);
+        chip8_script_free(&script);
+        return -1;
+    } /* End of if statement */
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, encoder, &record);
+
+    double start = now_seconds();
+    unsigned long long last_hash = 0;
+    unsigned long queued = 0;
+    unsigned long frame = 0;
+    for (; frame < frames && chip8->fault == CHIP8_FAULT_NONE; frame++)
+    {
+        chip8_script_apply(&script, chip8, frame);
+        chip8_run_frame(chip8);
+
+        /* A frame that dirtied no rows cannot differ from the last one;
+         * the rest are hashed to catch redraws of the same picture */
+        if (!chip8_screen_take_dirty_rows(&chip8->screen) && frame > 0)
+        {
+            continue;
+        } /* End of if statement */
+        unsigned long long hash = chip8_hash_screen(chip8);
+        if (hash == last_hash && frame > 0)
+        {
+            continue;
+        } /* End of if statement */
+        last_hash = hash;
+        enqueue(&record, frame);
+        queued++;
+    } /* End of for loop */
+    double emulated = now_seconds() - start;
+
+    record.end_frame = frame;
+    atomic_store_explicit(&record.done, 1, memory_order_release);
+    pthread_join(thread, NULL);
+    double seconds = now_seconds() - start;
+
+    if (chip8->fault != CHIP8_FAULT_NONE)
+    {
+        fprintf(stderr, "Stopped at PC %03X: %s\n", chip8->registers.PC, chip8_fault_name(chip8->fault));
+    } /* End of if statement */
+    if (stats)
+    {
+        fprintf(stderr, "{\"frames\": %lu, \"distinct_frames\": %lu, \"images\": %lu, \"bytes\": %llu, "
+                "\"core_seconds\": %.3f, \"seconds\": %.3f, \"realtime_factor\": %.0f, \"core_stalls\": %lu}\n",
+                frame, queued, record.video.images, record.video.bytes, emulated, seconds,
+                frame / (double) CHIP8_TIMER_HZ / seconds, record.stalls);
+    } /* End of if statement */
+
+    if (trace_filename)
+    {
+        if (chip8_trace_flush(&ring, trace_filename) != 0)
+        {
+            fprintf(stderr, "Failed to write trace to %s\n", trace_filename);
+        } /* End of nested if statement */
+        chip8_trace_free(&ring);
+    } /* End of if statement */
+
+    chip8_script_free(&script);
+    if (record.res != 0)
+    {
+        fprintf(stderr, "Failed to write %s\n", out);
+    } /* End of if statement */
+    return record.res;
+} /* End of main function */
@@ -0,0 +1,152 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8shmbench.c */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "chip8.h"
+#include "chip8loader.h"
+#include "chip8publish.h"
+
+#define SHMBENCH_DEFAULT_INSTANCES 1000
+#define SHMBENCH_DEFAULT_FRAMES 600
+
+/* Publishes every instance's frame after each emulated frame while a
+ * reader thread sweeps all the segments, and reports how fast both
+ * sides go */
+struct shmbench
+{
+    int instances;
+    struct chip8* chip8s;
+    struct chip8_publisher* publishers;
+    struct chip8_subscriber* subscribers;
+    atomic_int done;
+    unsigned long long reads;
+    unsigned long long failed_reads;
+}; /* End shmbench struct */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+} /* End of now ns function */
+
+static void* reader(void* arg)
+{
+    struct shmbench* bench = arg;
+    struct chip8_frame frame;
+    while (!atomic_load(&bench->done))
+    {
+        for (int i = 0; i < bench->instances; i++)
+        {
+            if (chip8_subscriber_read(&bench->subscribers[i], &frame) == 0)
+            {
+                bench->reads++;
+            }
+            else
+            {
+                bench->failed_reads++;
+            } /* End of if statement */
+        } /* End of for loop */
+    } /* End of while loop */
+    return NULL;
+} /* End of reader function */
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s ROM [INSTANCES] [FRAMES]\n", argv[0]);
+        return -1;
+    } /* End of if statement */
+
+    static struct shmbench bench;
+    bench.instances = argc > 2 ? atoi(argv[2]) : SHMBENCH_DEFAULT_INSTANCES;
+    unsigned long frames = argc > 3 ? strtoul(argv[3], NULL, 10) : SHMBENCH_DEFAULT_FRAMES;
+    bench.chip8s = calloc(bench.instances, sizeof(struct chip8));
+    bench.publishers = calloc(bench.instances, sizeof(struct chip8_publisher));
+    bench.subscribers = calloc(bench.instances, sizeof(struct chip8_subscriber));
+    if (!bench.chip8s || !bench.publishers || !bench.subscribers)
+    {
+        printf("Out of memory\n");
+        return -1;
+    } /* End of if statement */
+
+    int opened = 0;
+    int res = 0;
+    for (; opened < bench.instances; opened++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "/chip8-bench-%d-%d", (int) getpid(), opened);
+        chip8_init(&bench.chip8s[opened]);
+        enum chip8_load_result load = chip8_load_file(&bench.chip8s[opened], argv[1]);
+        if (load != CHIP8_LOAD_OK)
+        {
+            printf("Failed to load %s: %s\n", argv[1], chip8_load_result_name(load));
+            res = -1;
+            break;
+        } /* End of if statement */
+        if (chip8_publisher_open(&bench.publishers[opened], name) != 0)
+        {
+            printf("Failed to create shared frame %s\n", name);
+            res = -1;
+            break;
+        } /* End of if statement */
+        if (chip8_subscriber_open(&bench.subscribers[opened], name) != 0)
+        {
+            chip8_publisher_close(&bench.publishers[opened]);
+            printf("Failed to open shared frame %s\n", name);
+            res = -1;
+            break;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    if (res == 0)
+    {
+        pthread_t thread;
+        pthread_create(&thread, NULL, reader, &bench);
+
+        double emulate = 0;
+        double publish = 0;
+        for (unsigned long frame = 0; frame < frames; frame++)
+        {
+            double start = now_ns();
+            for (int i = 0; i < bench.instances; i++)
+            {
+                chip8_run_frame(&bench.chip8s[i]);
+            } /* End of nested for loop */
+            double middle = now_ns();
+            for (int i = 0; i < bench.instances; i++)
+            {
+                chip8_publisher_publish(&bench.publishers[i], &bench.chip8s[i], frame);
+            } /* End of nested for loop */
+            emulate += middle - start;
+            publish += now_ns() - middle;
+        } /* End of for loop */
+
+        atomic_store(&bench.done, 1);
+        pthread_join(thread, NULL);
+
+        double published = (double) frames * bench.instances;
+        double seconds = (emulate + publish) / 1e9;
+        printf("{\n  \"instances\": %d,\n  \"frames\": %lu,\n", bench.instances, frames);
+        printf("  \"publish_ns_per_frame\": %.1f,\n  \"emulate_ns_per_frame\": %.1f,\n",
+                publish / published, emulate / published);
+        printf("  \"published_frames_per_second\": %.0f,\n", published / seconds);
+        printf("  \"reader_frames_per_second\": %.0f,\n  \"reader_failed_reads\": %llu\n}\n",
+                bench.reads / seconds, bench.failed_reads);
+    } /* End of if statement */
+
+    for (int i = 0; i < opened; i++)
+    {
+        chip8_subscriber_close(&bench.subscribers[i]);
+        chip8_publisher_close(&bench.publishers[i]);
+    } /* End of for loop */
+    return res;
+} /* End of main function */
@@ -0,0 +1,67 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8shmview.c */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "chip8publish.h"
+
+static void print_frame(const struct chip8_frame* frame)
+{
+    printf("frame %llu  PC=%03X I=%03X SP=%02X DT=%02X ST=%02X\n", (unsigned long long) frame->frame,
+            frame->PC, frame->I, frame->SP, frame->delay_timer, frame->sound_timer);
+    for (int i = 0; i < CHIP8_TOTAL_DATA_REGISTERS; i++)
+    {
+        printf("V%X=%02X ", i, frame->V[i]);
+    } /* End of for loop */
+    printf("\n");
+
+    for (int y = 0; y < frame->height; y++)
+    {
+        for (int x = 0; x < frame->width; x++)
+        {
+            putchar(".#o@"[chip8_frame_pixel(frame, x, y)]);
+        } /* End of nested for loop */
+        putchar('\n');
+    } /* End of for loop */
+} /* End of print frame function */
+
+int main(int argc, char** argv)
+{
+    int follow = argc > 2 && strcmp(argv[2], "--follow") == 0;
+    if (argc < 2 || (argc > 2 && !follow))
+    {
+        printf("Usage: %s NAME [--follow]\n", argv[0]);
+        return -1;
+    } /* End of if statement */
+
+    struct chip8_subscriber subscriber;
+    if (chip8_subscriber_open(&subscriber, argv[1]) != 0)
+    {
+        printf("Failed to open shared frame %s\n", argv[1]);
+        return -1;
+    } /* End of if statement */
+
+    struct chip8_frame frame;
+    unsigned long long last = ~0ULL;
+    do
+    {
+        if (chip8_subscriber_read(&subscriber, &frame) == 0 && frame.frame != last)
+        {
+            if (follow)
+            {
+                printf("\033[H\033[2J");
+            } /* End of nested if statement */
+            print_frame(&frame);
+            fflush(stdout);
+            last = frame.frame;
+        } /* End of if statement */
+
+        struct timespec delay = { 0, 1000000000 / 60 };
+        nanosleep(&delay, NULL);
+    } while (follow);
+
+    chip8_subscriber_close(&subscriber);
+    return 0;
+} /* End of main function */
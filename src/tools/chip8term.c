@@ -0,0 +1,274 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8term.c */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "chip8.h"
+#include "chip8loader.h"
+#include "chip8profiler.h"
+#include "chip8script.h"
+#include "chip8term.h"
+
+/* Terminals report key presses but not releases, so a key typed on
+ * stdin is held down for this many frames */
+#define TERM_KEY_HOLD_FRAMES 6
+
+static volatile sig_atomic_t quit;
+
+static void on_signal(int signal)
+{
+    (void) signal;
+    quit = 1;
+} /* End of on signal function */
+
+static int key_for_char(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    } /* End of if statement */
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    } /* End of if statement */
+    return -1;
+} /* End of key for char function */
+
+/* Writes all of buf, retrying on short writes */
+static int write_all(const char* buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t written = write(STDOUT_FILENO, buf, len);
+        if (written <= 0)
+        {
+            return -1;
+        } /* End of if statement */
+        buf += written;
+        len -= written;
+    } /* End of while loop */
+    return 0;
+} /* End of write all function */
+
+static double cpu_seconds(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+} /* End of cpu seconds function */
+
+int main(int argc, char** argv)
+{
+    enum chip8_term_mode mode = CHIP8_TERM_BRAILLE;
+    unsigned long frames = 0;
+    bool fast = false;
+    bool stats = false;
+    const char* rom = NULL;
+    const char* trace = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--half") == 0)
+        {
+            mode = CHIP8_TERM_HALF_BLOCK;
+        }
+        else if (strncmp(argv[i], "--frames=", 9) == 0)
+        {
+            frames = strtoul(argv[i] + 9, NULL, 10);
+        }
+        else if (strcmp(argv[i], "--fast") == 0)
+        {
+            fast = true;
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            stats = true;
+        }
+        else if (strncmp(argv[i], "--trace=", 8) == 0)
+        {
+            trace = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--", 2) != 0 && !rom)
+        {
+            rom = argv[i];
+        }
+        else
+        {
+            rom = NULL;
+            break;
+        } /* End of if else statement */
+    } /* End of for loop */
+    if (!rom)
+    {
+        fprintf(stderr, "Usage: %s [--half] [--frames=N] [--fast] [--stats] [--trace=FILE] ROM[:SCRIPT]\n", argv[0]);
+        return -1;
+    } /* End of if statement */
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s", rom);
+    char* script_path = strchr(path, ':');
+    if (script_path)
+    {
+        *script_path++ = '\0';
+    } /* End of if statement */
+
+    static struct chip8 chip8;
+    chip8_init(&chip8);
+    chip8_seed(&chip8, time(NULL));
+    enum chip8_load_result load = chip8_load_file(&chip8, path);
+    if (load != CHIP8_LOAD_OK)
+    {
+        fprintf(stderr, "Failed to load %s: %s\n", path, chip8_load_result_name(load));
+        return -1;
+    } /* End of if statement */
+    chip8_set_profile(&chip8, chip8_profile_for_file(path));
+
+    /* --trace=FILE or CHIP8_TRACE=FILE keeps the last instructions in a
+     * ring buffer and writes them out at the end or on abort */
+    static struct chip8_trace ring;
+    const char* trace_filename = chip8_trace_start(&ring, trace);
+    if (trace_filename)
+    {
+        chip8.trace = &ring;
+    } /* End of if statement */
+
+#ifdef CHIP8_PROFILING
+    /* Profiling builds (make term-profiling) write what the run executed
+     * to CHIP8_COUNTS=file on exit, for fusegen */
+    static struct chip8_profiler profiler;
+    const char* counts_filename = getenv("CHIP8_COUNTS");
+    if (counts_filename && chip8_profiler_init(&profiler) == 0)
+    {
+        chip8.profiler = &profiler;
+    } /* End of if statement */
+#endif
+
+    struct chip8_script script = { 0 };
+    if (script_path && chip8_script_load(&script, script_path) != 0)
+    {
+        fprintf(stderr, "Failed to load input script %s\n", script_path);
+        return -1;
+    } /* End of if statement */
+
+    /* Live keys from stdin when it is a terminal, without echo or line
+     * buffering; Ctrl-C still stops the run */
+    struct termios saved;
+    bool interactive = !script_path && isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved) == 0;
+    if (interactive)
+    {
+        struct termios raw = saved;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    } /* End of if statement */
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    static struct chip8_term term;
+    chip8_term_init(&term, mode);
+    static const char hide_cursor[] = "\033[?25l";
+    write_all(hide_cursor, sizeof(hide_cursor) - 1);
+
+    unsigned long held[CHIP8_TOTAL_KEYS] = { 0 };
+    unsigned long long bytes = 0;
+    unsigned long long largest = 0;
+    unsigned long written = 0;
+    unsigned long frame = 0;
+    double cpu_start = cpu_seconds();
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    for (; !quit && (frames == 0 || frame < frames) && chip8.fault == CHIP8_FAULT_NONE; frame++)
+    {
+        if (script_path)
+        {
+            chip8_script_apply(&script, &chip8, frame);
+        } /* End of if statement */
+        if (interactive)
+        {
+            char c;
+            while (read(STDIN_FILENO, &c, 1) == 1)
+            {
+                int key = key_for_char(c);
+                if (key != -1)
+                {
+                    held[key] = frame + TERM_KEY_HOLD_FRAMES;
+                } /* End of if statement */
+            } /* End of while loop */
+            for (int key = 0; key < CHIP8_TOTAL_KEYS; key++)
+            {
+                chip8.keyboard.keyboard[key] = held[key] > frame;
+            } /* End of for loop */
+        } /* End of if statement */
+
+        chip8_run_frame(&chip8);
+
+        size_t len = chip8_term_render(&term, &chip8.screen, chip8_screen_take_dirty_rows(&chip8.screen));
+        if (len)
+        {
+            write_all(term.buffer, len);
+            bytes += len;
+            largest = len > largest ? len : largest;
+            written++;
+        } /* End of if statement */
+
+        if (!fast)
+        {
+            next.tv_nsec += 1000000000L / CHIP8_TIMER_HZ;
+            if (next.tv_nsec >= 1000000000L)
+            {
+                next.tv_nsec -= 1000000000L;
+                next.tv_sec++;
+            } /* End of if statement */
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        } /* End of if statement */
+    } /* End of for loop */
+
+    static const char restore[] = "\033[0m\033[?25h\n";
+    write_all(restore, sizeof(restore) - 1);
+    if (interactive)
+    {
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    } /* End of if statement */
+    if (chip8.fault != CHIP8_FAULT_NONE)
+    {
+        fprintf(stderr, "Stopped at PC %03X: %s\n", chip8.registers.PC, chip8_fault_name(chip8.fault));
+    } /* End of if statement */
+
+    if (stats && frame > 0)
+    {
+        fprintf(stderr, "{\"frames\": %lu, \"frames_written\": %lu, \"bytes\": %llu, \"bytes_per_frame\": %.1f, "
+                "\"largest_frame\": %llu, \"cpu_us_per_frame\": %.2f}\n",
+                frame, written, bytes, (double) bytes / frame, largest, (cpu_seconds() - cpu_start) * 1e6 / frame);
+    } /* End of if statement */
+
+    if (trace_filename)
+    {
+        if (chip8_trace_flush(&ring, trace_filename) != 0)
+        {
+            fprintf(stderr, "Failed to write trace to %s\n", trace_filename);
+        } /* End of nested if statement */
+        chip8_trace_free(&ring);
+    } /* End of if statement */
+
+#ifdef CHIP8_PROFILING
+    if (chip8.profiler)
+    {
+        if (chip8_profiler_save(chip8.profiler, counts_filename) != 0)
+        {
+            fprintf(stderr, "Failed to write counts to %s\n", counts_filename);
+        } /* End of nested if statement */
+        chip8_profiler_free(chip8.profiler);
+    } /* End of if statement */
+#endif
+
+    chip8_script_free(&script);
+    return 0;
+} /* End of main function */
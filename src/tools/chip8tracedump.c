@@ -0,0 +1,153 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8tracedump.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chip8disasm.h"
+#include "chip8trace.h"
+
+struct chip8_trace_filter
+{
+    long pc;
+    unsigned short opcode_mask;
+    unsigned short opcode_value;
+    int reg;
+    unsigned long long from;
+    unsigned long long to;
+}; /* End trace filter struct */
+
+static void usage(const char* program)
+{
+    printf("Usage: %s TRACE [--pc=ADDR] [--op=MASK:VALUE] [--reg=N] [--from=CYCLE] [--to=CYCLE]\n", program);
+    printf("  --pc     only show instructions fetched from ADDR\n");
+    printf("  --op     only show opcodes where (opcode & MASK) == VALUE, e.g. --op=F0FF:F055\n");
+    printf("  --reg    only show instructions that changed VN\n");
+    printf("  --from   first cycle to show\n");
+    printf("  --to     last cycle to show\n");
+} /* End of usage function */
+
+static int parse_args(int argc, char** argv, struct chip8_trace_filter* filter)
+{
+    filter->pc = -1;
+    filter->opcode_mask = 0;
+    filter->opcode_value = 0;
+    filter->reg = -1;
+    filter->from = 0;
+    filter->to = ~0ULL;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--pc=", 5) == 0)
+        {
+            filter->pc = strtol(arg + 5, NULL, 16);
+        }
+        else if (strncmp(arg, "--op=", 5) == 0)
+        {
+            char* end;
+            filter->opcode_mask = strtoul(arg + 5, &end, 16);
+            if (*end != ':')
+            {
+                return -1;
+            } /* End of nested if statement */
+            filter->opcode_value = strtoul(end + 1, NULL, 16);
+        }
+        else if (strncmp(arg, "--reg=", 6) == 0)
+        {
+            filter->reg = strtol(arg + 6, NULL, 16);
+        }
+        else if (strncmp(arg, "--from=", 7) == 0)
+        {
+            filter->from = strtoull(arg + 7, NULL, 10);
+        }
+        else if (strncmp(arg, "--to=", 5) == 0)
+        {
+            filter->to = strtoull(arg + 5, NULL, 10);
+        }
+        else
+        {
+            return -1;
+        } /* End of if statement */
+    } /* End of for loop */
+
+    return 0;
+} /* End of parse args function */
+
+static int matches(const struct chip8_trace_filter* filter, const struct chip8_trace_record* record)
+{
+    if (record->cycle < filter->from || record->cycle > filter->to)
+    {
+        return 0;
+    } /* End of if statement */
+    if (filter->pc >= 0 && record->PC != filter->pc)
+    {
+        return 0;
+    } /* End of if statement */
+    if ((record->opcode & filter->opcode_mask) != filter->opcode_value)
+    {
+        return 0;
+    } /* End of if statement */
+    if (filter->reg >= 0 && record->reg != filter->reg)
+    {
+        return 0;
+    } /* End of if statement */
+    return 1;
+} /* End of matches function */
+
+int main(int argc, char** argv)
+{
+    struct chip8_trace_filter filter;
+    if (argc < 2 || parse_args(argc, argv, &filter) != 0)
+    {
+        usage(argv[0]);
+        return -1;
+    } /* End of if statement */
+
+    FILE* f = fopen(argv[1], "rb");
+    if (!f)
+    {
+        printf("Failed to open file!\n");
+        return -1;
+    } /* End of if statement */
+
+    struct chip8_trace_header header;
+    if (fread(&header, sizeof(header), 1, f) != 1
+            || memcmp(header.magic, CHIP8_TRACE_MAGIC, sizeof(header.magic)) != 0
+            || header.version != CHIP8_TRACE_VERSION)
+    {
+        printf("Not a chip8 trace file!\n");
+        fclose(f);
+        return -1;
+    } /* End of if statement */
+
+    struct chip8_trace_record record;
+    char text[32];
+    unsigned long long read = 0;
+    while (read < header.count && fread(&record, sizeof(record), 1, f) == 1)
+    {
+        read++;
+        if (!matches(&filter, &record))
+        {
+            continue;
+        } /* End of if statement */
+
+        chip8_disassemble(record.opcode, text, sizeof(text));
+        printf("%12llu  %03X  %04X  %-18s I=%03X", (unsigned long long) record.cycle,
+                record.PC, record.opcode, text, record.I);
+        if (record.reg != CHIP8_TRACE_NO_REGISTER)
+        {
+            printf("  V%X=%02X", record.reg, record.value);
+        } /* End of if statement */
+        printf("\n");
+    } /* End of while loop */
+
+    fclose(f);
+    if (read != header.count)
+    {
+        printf("Trace truncated after %llu of %llu records\n", read, (unsigned long long) header.count);
+        return -1;
+    } /* End of if statement */
+    return 0;
+} /* End of main function */
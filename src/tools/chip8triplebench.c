@@ -0,0 +1,157 @@
+/* Program name : Chip-8 emulator 
+ * File name : chip8triplebench.c */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "chip8.h"
+#include "chip8loader.h"
+#include "chip8scale.h"
+#include "chip8triple.h"
+
+#define TRIPLEBENCH_DEFAULT_SECONDS 2
+
+/* Runs a ROM flat out for a few seconds and presents its frames the
+ * way the SDL frontend does, either inline on the emulation thread as it
+ * used to or through the triple buffer from a render thread, with and
+ * without a vsync wait. Fills an RGBA buffer as the frontend fills its
+ * texture, and models vsync as sleeping to the next 60Hz boundary since
+ * there is no display here. */
+struct triplebench
+{
+    struct chip8 chip8;
+    struct chip8_triple triple;
+    bool vsync;
+    atomic_int done;
+    unsigned long long presented;
+    uint32_t pixels[CHIP8_HIRES_WIDTH * CHIP8_HIRES_HEIGHT];
+}; /* End triplebench struct */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+} /* End of now ns function */
+
+static void present(struct triplebench* bench, const struct chip8_frame* frame)
+{
+    static const uint32_t palette[4] = { 0xff000000, 0xffffffff, 0xffaaaaaa, 0xff555555 };
+    chip8_scale_rgba(frame, palette, 1, bench->pixels, frame->width * sizeof(uint32_t));
+
+    if (bench->vsync)
+    {
+        long long period = 1000000000LL / CHIP8_TIMER_HZ;
+        long long now = now_ns();
+        long long wait = period - now % period;
+        struct timespec ts = { wait / 1000000000LL, wait % 1000000000LL };
+        nanosleep(&ts, NULL);
+    } /* End of if statement */
+    bench->presented++;
+} /* End of present function */
+
+static void* render(void* arg)
+{
+    struct triplebench* bench = arg;
+    struct timespec idle = { 0, 1000000 };
+    while (!atomic_load(&bench->done))
+    {
+        const struct chip8_frame* frame = chip8_triple_read(&bench->triple);
+        if (frame)
+        {
+            present(bench, frame);
+        }
+        else
+        {
+            nanosleep(&idle, NULL);
+        } /* End of if else statement */
+    } /* End of while loop */
+    return NULL;
+} /* End of render function */
+
+static int run(struct triplebench* bench, const char* path, double seconds, bool threaded, bool vsync, bool first)
+{
+    static struct chip8_frame inline_frame;
+    chip8_init(&bench->chip8);
+    enum chip8_load_result load = chip8_load_file(&bench->chip8, path);
+    if (load != CHIP8_LOAD_OK)
+    {
+        printf("Failed to load %s: %s\n", path, chip8_load_result_name(load));
+        return -1;
+    } /* End of if statement */
+    chip8_set_profile(&bench->chip8, chip8_profile_for_file(path));
+    chip8_triple_init(&bench->triple);
+    bench->vsync = vsync;
+    bench->presented = 0;
+    atomic_store(&bench->done, 0);
+
+    pthread_t thread;
+    if (threaded)
+    {
+        pthread_create(&thread, NULL, render, bench);
+    } /* End of if statement */
+
+    double start = now_ns();
+    double end = start + seconds * 1e9;
+    double now = start;
+    unsigned long frame = 0;
+    for (; now < end && bench->chip8.fault == CHIP8_FAULT_NONE; frame++, now = now_ns())
+    {
+        chip8_run_frame(&bench->chip8);
+        if (!chip8_screen_take_dirty_rows(&bench->chip8.screen))
+        {
+            continue;
+        } /* End of if statement */
+        if (threaded)
+        {
+            chip8_frame_capture(chip8_triple_back(&bench->triple), &bench->chip8, frame);
+            chip8_triple_publish(&bench->triple);
+        }
+        else
+        {
+            chip8_frame_capture(&inline_frame, &bench->chip8, frame);
+            present(bench, &inline_frame);
+        } /* End of if else statement */
+    } /* End of for loop */
+    seconds = (now - start) / 1e9;
+
+    if (threaded)
+    {
+        atomic_store(&bench->done, 1);
+        pthread_join(thread, NULL);
+    } /* End of if statement */
+
+    printf("%s  {\"mode\": \"%s\", \"vsync\": %s, \"frames\": %lu, \"frames_per_second\": %.0f, "
+            "\"instructions_per_second\": %.0f, \"presented\": %llu}",
+            first ? "" : ",\n", threaded ? "threaded" : "inline", vsync ? "true" : "false", frame, frame / seconds,
+            bench->chip8.cycles / seconds, bench->presented);
+    return 0;
+} /* End of run function */
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s ROM [SECONDS]\n", argv[0]);
+        return -1;
+    } /* End of if statement */
+
+    static struct triplebench bench;
+    double seconds = argc > 2 ? atof(argv[2]) : TRIPLEBENCH_DEFAULT_SECONDS;
+
+    printf("[\n");
+    int res = 0;
+    for (int threaded = 0; threaded < 2 && res == 0; threaded++)
+    {
+        for (int vsync = 0; vsync < 2 && res == 0; vsync++)
+        {
+            res = run(&bench, argv[1], seconds, threaded, vsync, threaded == 0 && vsync == 0);
+        } /* End of nested for loop */
+    } /* End of for loop */
+    printf("\n]\n");
+    return res;
+} /* End of main function */